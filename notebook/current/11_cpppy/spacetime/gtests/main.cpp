@@ -1,6 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <sstream>
+
+#include <unistd.h>
+
 #include "spacetime.hpp"
+#include "spacetime/driver.hpp"
 
 
 namespace st = spacetime;
@@ -47,6 +53,268 @@ TEST(SolverTest, Celm)
 
 }
 
+TEST(SolverTest, Gather)
+{
+
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 10, 10);
+    std::shared_ptr<st::LinearScalarSolver> sol=st::LinearScalarSolver::construct(grid, 0.2);
+
+    st::Grid::array_type dx = sol->gather_celm([](st::LinearScalarCelm const & ce) { return ce.dx(); }, true);
+    EXPECT_EQ(9, dx.size());
+    for (size_t it=0; it<dx.size(); ++it) { EXPECT_EQ(1, dx[it]); }
+
+    xt::xarray<st::sindex_type> indices{3, 0, 10};
+    st::Grid::array_type x = sol->gather_selm([](st::LinearScalarSelm const & se) { return se.x(); }, indices, false);
+    EXPECT_EQ(3, x.size());
+    EXPECT_EQ(3, x[0]);
+    EXPECT_EQ(0, x[1]);
+    EXPECT_EQ(10, x[2]);
+
+    xt::xarray<st::sindex_type> bad{11};
+    EXPECT_THROW(
+        sol->gather_selm([](st::LinearScalarSelm const & se) { return se.x(); }, bad, false),
+        std::out_of_range
+    );
+
+}
+
+TEST(SolverTest, DerivedCache)
+{
+
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 2*M_PI, 16);
+    std::shared_ptr<st::InviscidBurgersSolver> sol=st::InviscidBurgersSolver::construct(grid, 0.1);
+    st::Grid::array_type xctr = sol->xctr(false);
+    st::Grid::array_type so0(std::vector<size_t>{xctr.size()});
+    st::Grid::array_type so1(std::vector<size_t>{xctr.size()});
+    for (size_t it=0; it<xctr.size(); ++it)
+    {
+        so0[it] = std::sin(xctr[it]);
+        so1[it] = std::cos(xctr[it]);
+    }
+    sol->set_so0(0, so0, false);
+    sol->set_so1(0, so1, false);
+    sol->setup_march();
+
+    // The cached kernels produce the same bits as the uncached ones.
+    std::shared_ptr<st::InviscidBurgersSolver> ref=sol->clone();
+    EXPECT_FALSE(ref->use_derived_cache());
+    sol->set_use_derived_cache(true);
+    sol->march_alpha<2>(10);
+    ref->march_alpha<2>(10);
+    for (bool odd_plane : {false, true})
+    {
+        st::Grid::array_type v0 = sol->get_so0(0, odd_plane);
+        st::Grid::array_type v1 = ref->get_so0(0, odd_plane);
+        for (size_t it=0; it<v0.size(); ++it) { EXPECT_EQ(v0[it], v1[it]); }
+        v0 = sol->get_so1(0, odd_plane);
+        v1 = ref->get_so1(0, odd_plane);
+        for (size_t it=0; it<v0.size(); ++it) { EXPECT_EQ(v0[it], v1[it]); }
+    }
+
+    // Writing the solution through a held reference is seen by the getters
+    // and by the next cached march.
+    st::Grid::array_type & held = sol->so0();
+    st::Grid::array_type & held_ref = ref->so0();
+    st::Grid::array_type so0p = sol->get_so0p(0, false);
+    EXPECT_EQ(sol->selm(3, false).so0p(0), so0p[3]);
+    const st::real_type before = so0p[3];
+    held.fill(2);
+    held_ref.fill(2);
+    so0p = sol->get_so0p(0, false);
+    EXPECT_NE(before, so0p[3]);
+    EXPECT_EQ(sol->selm(3, false).so0p(0), so0p[3]);
+    sol->march_alpha<2>(1);
+    ref->march_alpha<2>(1);
+    for (bool odd_plane : {false, true})
+    {
+        st::Grid::array_type v0 = sol->get_so0(0, odd_plane);
+        st::Grid::array_type v1 = ref->get_so0(0, odd_plane);
+        for (size_t it=0; it<v0.size(); ++it) { EXPECT_EQ(v0[it], v1[it]); }
+    }
+
+    // So is writing the coordinates.
+    EXPECT_EQ(xctr[3], sol->xctr(false)[3]);
+    st::Grid::array_type & xcoord = grid->xcoord();
+    xcoord.fill(1);
+    EXPECT_EQ(1, sol->xctr(false)[3]);
+
+}
+
+TEST(DriverTest, RunConfig)
+{
+
+    std::istringstream iss(
+        "# comment line\n"
+        "equation = inviscid_burgers\n"
+        "\n"
+        "ncelm=20  # trailing comment\n"
+        "steps = 5\n"
+        "output_interval = 2\n"
+    );
+    st::RunConfig config = st::RunConfig::from_stream(iss);
+    EXPECT_EQ("inviscid_burgers", config.equation());
+    EXPECT_EQ(20, config.ncelm());
+    EXPECT_EQ(5, config.steps());
+    EXPECT_EQ(2, config.output_interval());
+    EXPECT_EQ(2, config.alpha());
+
+    EXPECT_THROW(config.set("nokey", "1"), std::invalid_argument);
+    EXPECT_THROW(config.set("ncelm", "-1"), std::invalid_argument);
+    EXPECT_THROW(config.set("dt", "0.1x"), std::invalid_argument);
+    EXPECT_THROW(config.set("alpha", "3"), std::invalid_argument);
+    // A rejected value leaves the config untouched.
+    EXPECT_EQ(2, config.alpha());
+    std::istringstream bad("ncelm 20\n");
+    EXPECT_THROW(st::RunConfig::from_stream(bad), std::invalid_argument);
+
+}
+
+TEST(DriverTest, Run)
+{
+
+    st::RunConfig config;
+    config.set("ncelm", "8");
+    config.set("steps", "80");
+    config.set("output_interval", "40");
+    st::Driver driver(config);
+
+    // One period of marching returns to the initial condition.
+    std::shared_ptr<st::LinearScalarSolver> svr = driver.build_solver<st::LinearScalarSolver>();
+    st::Grid::array_type so0 = svr->get_so0(0, false);
+    std::ostringstream oss;
+    EXPECT_EQ(3, driver.run_solver(*svr, &oss));
+    st::Grid::array_type so0_final = svr->get_so0(0, false);
+    for (size_t it=0; it<so0.size(); ++it)
+    {
+        EXPECT_NEAR(so0[it], so0_final[it], 1.e-12);
+    }
+    EXPECT_EQ(0, oss.str().find("# step 0 time 0\n"));
+    EXPECT_NE(std::string::npos, oss.str().find("# step 80 time "));
+
+}
+
+TEST(TunerTest, MarchParameter)
+{
+
+    st::MarchParameter param = st::MarchParameter::from_string("use_derived_cache=1");
+    EXPECT_TRUE(param.use_derived_cache());
+    EXPECT_EQ("use_derived_cache=1", param.to_string());
+    EXPECT_FALSE(st::MarchParameter::from_string("").use_derived_cache());
+    EXPECT_THROW(st::MarchParameter::from_string("use_derived_cache=2"), std::invalid_argument);
+    EXPECT_THROW(st::MarchParameter::from_string("chunk=8"), std::invalid_argument);
+
+    // Problem sizes within a factor of 2 share the key.
+    EXPECT_EQ(st::MarchTuner::key("Solver", 64), st::MarchTuner::key("Solver", 127));
+    EXPECT_NE(st::MarchTuner::key("Solver", 64), st::MarchTuner::key("Solver", 128));
+
+}
+
+TEST(TunerTest, Tune)
+{
+
+    st::MarchTuner & tuner = st::MarchTuner::me();
+    const std::string old_path = tuner.path();
+    const std::string path = ::testing::TempDir() + "libst_gtest/tuning.txt";
+    std::remove(path.c_str());
+    tuner.set_path(path);
+
+    std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 2*M_PI, 64);
+    std::shared_ptr<st::LinearScalarSolver> sol=st::LinearScalarSolver::construct(grid, 0.01);
+    sol->setup_march();
+    st::Grid::array_type so0 = sol->get_so0(0, false);
+    EXPECT_THROW(tuner.tune(*sol, 4, 3), std::invalid_argument);
+    st::MarchParameter param = tuner.tune(*sol, 4, 1);
+    EXPECT_EQ(param.use_derived_cache(), sol->use_derived_cache());
+    // Tuning marches clones only.
+    st::Grid::array_type so0_tuned = sol->get_so0(0, false);
+    for (size_t it=0; it<so0.size(); ++it) { EXPECT_EQ(so0[it], so0_tuned[it]); }
+
+    // The choice is persisted and applied on request to later solvers of the
+    // same size.
+    tuner.set_path(path);
+    std::ifstream ifs(path);
+    std::string line;
+    std::getline(ifs, line);
+    EXPECT_EQ(st::MarchTuner::key("LinearScalarSolver", 64) + "\t" + param.to_string(), line);
+    tuner.store(st::MarchTuner::key("LinearScalarSolver", 64), st::MarchParameter(true), false);
+    EXPECT_FALSE(std::ifstream(path + ".tmp." + std::to_string(getpid())));
+    sol = st::LinearScalarSolver::construct(grid, 0.01);
+    EXPECT_FALSE(sol->use_derived_cache());
+    EXPECT_TRUE(tuner.apply(*sol));
+    EXPECT_TRUE(sol->use_derived_cache());
+    sol = st::LinearScalarSolver::construct(st::Grid::construct(0, 2*M_PI, 256), 0.01);
+    EXPECT_FALSE(tuner.apply(*sol));
+
+    tuner.set_path(old_path);
+
+}
+
+TEST(SchedulerTest, March)
+{
+
+    auto initialize = [](auto & sol)
+    {
+        st::Grid::array_type xctr = sol->xctr(false);
+        st::Grid::array_type so0(std::vector<size_t>{xctr.size()});
+        for (size_t it=0; it<xctr.size(); ++it) { so0[it] = std::sin(xctr[it]); }
+        sol->set_so0(0, so0, false);
+        sol->setup_march();
+    };
+
+    std::vector<std::shared_ptr<st::LinearScalarSolver>> lsols, lrefs;
+    std::vector<std::shared_ptr<st::InviscidBurgersSolver>> bsols, brefs;
+    for (size_t ncelm : {8, 33, 64, 250, 1000})
+    {
+        std::shared_ptr<st::Grid> grid=st::Grid::construct(0, 2*M_PI, ncelm);
+        lsols.push_back(st::LinearScalarSolver::construct(grid, 2*M_PI/ncelm/2));
+        bsols.push_back(st::InviscidBurgersSolver::construct(grid, 2*M_PI/ncelm/2));
+        initialize(lsols.back());
+        initialize(bsols.back());
+        lrefs.push_back(lsols.back()->clone());
+        brefs.push_back(bsols.back()->clone());
+    }
+
+    st::MarchScheduler scheduler(3);
+    EXPECT_EQ(3, scheduler.nthread());
+    // A small grain splits every solver into many tasks.
+    scheduler.set_grain(100);
+    for (size_t it=0; it<lsols.size(); ++it)
+    {
+        scheduler.add(lsols[it], 20+it, it % 3);
+        scheduler.add(bsols[it], 15+it);
+    }
+    EXPECT_EQ(2*lsols.size(), scheduler.njob());
+    EXPECT_THROW(scheduler.add(lsols[0], 1), std::invalid_argument);
+    EXPECT_THROW(scheduler.add(lrefs[0], 1, 3), std::invalid_argument);
+    scheduler.run();
+    EXPECT_EQ(0, scheduler.njob());
+
+    // The scheduled marching produces the same bits as the sequential one.
+    for (size_t it=0; it<lsols.size(); ++it)
+    {
+        switch (it % 3)
+        {
+        case 0: lrefs[it]->march_alpha<0>(20+it); break;
+        case 1: lrefs[it]->march_alpha<1>(20+it); break;
+        default: lrefs[it]->march_alpha<2>(20+it); break;
+        }
+        brefs[it]->march_alpha<2>(15+it);
+        st::Grid::array_type v0 = lsols[it]->get_so0(0, false);
+        st::Grid::array_type v1 = lrefs[it]->get_so0(0, false);
+        for (size_t ie=0; ie<v0.size(); ++ie) { EXPECT_EQ(v0[ie], v1[ie]); }
+        v0 = bsols[it]->get_so1(0, false);
+        v1 = brefs[it]->get_so1(0, false);
+        for (size_t ie=0; ie<v0.size(); ++ie) { EXPECT_EQ(v0[ie], v1[ie]); }
+    }
+
+    // The scheduler is reusable.
+    scheduler.add(bsols[0], 5);
+    scheduler.run();
+    brefs[0]->march_alpha<2>(5);
+    EXPECT_EQ(brefs[0]->get_so0(0, false)[3], bsols[0]->get_so0(0, false)[3]);
+
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -18,5 +18,7 @@
 #include "spacetime/kernel/linear_scalar.hpp"
 #include "spacetime/kernel/inviscid_burgers.hpp"
 #include "spacetime/io.hpp"
+#include "spacetime/tuner.hpp"
+#include "spacetime/scheduler.hpp"
 
 /* vim: set et ts=4 sw=4: */
@@ -38,6 +38,18 @@ typename CelmBase<SE>::value_type CelmBase<SE>::calc_so0(size_t iv) const
     return (flux_ll + flux_ur) / se_tp.dx();
 }
 
+template< typename SE >
+inline
+typename CelmBase<SE>::value_type CelmBase<SE>::calc_so0_cached(size_t iv) const
+{
+    const SE se_xn = selm_xn();
+    const SE se_xp = selm_xp();
+    const value_type flux_ll = se_xn.xp(iv) + se_xn.tp_cached(iv);
+    const value_type flux_ur = se_xp.xn(iv) - se_xp.tp_cached(iv);
+    const SE se_tp = selm_tp();
+    return (flux_ll + flux_ur) / se_tp.dx();
+}
+
 template< typename SE >
 template< size_t ALPHA >
 inline
@@ -48,6 +60,34 @@ typename CelmBase<SE>::value_type CelmBase<SE>::calc_so1_alpha(size_t iv) const
     const SE se_xp = selm_xp();
     const value_type upn = se_xn.so0p(iv); // u' at left SE
     const value_type upp = se_xp.so0p(iv); // u' at right SE
+    return alpha_scheme<ALPHA>(se_xn, se_xp, upn, upp, iv);
+}
+
+template< typename SE >
+template< size_t ALPHA >
+inline
+typename CelmBase<SE>::value_type CelmBase<SE>::calc_so1_alpha_cached(size_t iv) const
+{
+    // Fetch value.
+    const SE se_xn = selm_xn();
+    const SE se_xp = selm_xp();
+    const value_type upn = se_xn.so0p_cached(iv); // u' at left SE
+    const value_type upp = se_xp.so0p_cached(iv); // u' at right SE
+    return alpha_scheme<ALPHA>(se_xn, se_xp, upn, upp, iv);
+}
+
+template< typename SE >
+template< size_t ALPHA >
+inline
+typename CelmBase<SE>::value_type CelmBase<SE>::alpha_scheme
+(
+    SE const & se_xn
+  , SE const & se_xp
+  , value_type upn
+  , value_type upp
+  , size_t iv
+) const
+{
     const value_type utp = selm_tp().so0(iv); // u at top SE
     // alpha-scheme.
     const value_type duxn = (utp - upn) / se_xn.dxpos();
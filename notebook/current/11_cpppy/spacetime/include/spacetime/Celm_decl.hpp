@@ -78,6 +78,8 @@ public:
 
     value_type calc_so0(size_t /*iv*/) const { return 0.0; }
     template<size_t ALPHA> value_type calc_so1_alpha(size_t /*iv*/) const { return 0.0; }
+    value_type calc_so0_cached(size_t /*iv*/) const { return 0.0; }
+    template<size_t ALPHA> value_type calc_so1_alpha_cached(size_t /*iv*/) const { return 0.0; }
 
 }; /* end class Celm */
 
@@ -108,6 +110,18 @@ public:
     value_type calc_so0(size_t iv) const;
     template<size_t ALPHA> value_type calc_so1_alpha(size_t iv) const;
 
+    /**
+     * Same as calc_so0() and calc_so1_alpha() but take tp and so0p of the SEs
+     * from the scratch arrays of the Field, which must have been filled for
+     * the plane of the CE.
+     */
+    value_type calc_so0_cached(size_t iv) const;
+    template<size_t ALPHA> value_type calc_so1_alpha_cached(size_t iv) const;
+
+private:
+
+    template<size_t ALPHA> value_type alpha_scheme(SE const & se_xn, SE const & se_xp, value_type upn, value_type upp, size_t iv) const;
+
 }; /* end class CelmBase */
 
 } /* end namespace spacetime */
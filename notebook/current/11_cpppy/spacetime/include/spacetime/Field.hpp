@@ -30,6 +30,42 @@ void Field::set_time_increment(value_type time_increment)
     m_quarter_time_increment = 0.25 * time_increment;
 }
 
+template< typename SE, typename F >
+inline
+void Field::fill_derived(array_type & derived, bool odd_plane, F && func)
+{
+    if (derived.shape() != m_so0.shape())
+    {
+        derived = array_type(std::vector<size_t>{m_so0.shape()[0], m_so0.shape()[1]});
+    }
+    const size_t nv = nvar();
+    // All the SEs on the plane, including the ghost ones outside the domain.
+    const sindex_type start = odd_plane ? -1 : 0;
+    const sindex_type stop = grid().nselm();
+    SE se = selm<SE>(start, odd_plane);
+    value_type * ptr = derived.data() + se.xindex() * nv; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    for (sindex_type ie=start; ie<stop; ++ie)
+    {
+        for (size_t iv=0; iv<nv; ++iv) { ptr[iv] = func(se, iv); } // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        se.move_right();
+        ptr += 2 * nv; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+}
+
+template< typename SE >
+inline
+void Field::fill_so0p(bool odd_plane)
+{
+    fill_derived<SE>(m_so0p, odd_plane, [](SE const & se, size_t iv) { return se.so0p(iv); });
+}
+
+template< typename SE >
+inline
+void Field::fill_tp(bool odd_plane)
+{
+    fill_derived<SE>(m_tp, odd_plane, [](SE const & se, size_t iv) { return se.tp(iv); });
+}
+
 template< typename CE >
 // NOLINTNEXTLINE(readability-const-return-type)
 inline
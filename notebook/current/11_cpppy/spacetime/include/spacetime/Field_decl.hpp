@@ -77,6 +77,17 @@ public:
 
     size_t nvar() const { return m_so0.shape()[1]; }
 
+    /**
+     * Scratch arrays of tp and so0p for the marching kernels, indexed like so0
+     * and so1.  A fill computes the whole plane and is stale as soon as the
+     * solution or the grid changes, so a kernel fills what it reads right
+     * before reading it, and other code must not read them.
+     */
+    template< typename SE > void fill_so0p(bool odd_plane);
+    template< typename SE > void fill_tp(bool odd_plane);
+    value_type cached_so0p(size_t it, size_t iv) const { return m_so0p(it, iv); }
+    value_type cached_tp(size_t it, size_t iv) const { return m_tp(it, iv); }
+
     void set_time_increment(value_type time_increment);
 
     real_type time_increment() const { return m_time_increment; }
@@ -100,12 +111,17 @@ public:
 
 private:
 
+    template< typename SE, typename F > void fill_derived(array_type & derived, bool odd_plane, F && func);
+
     std::shared_ptr<Grid> m_grid;
 
     array_type m_so0;
     array_type m_so1;
     array_type m_cfl;
 
+    array_type m_so0p;
+    array_type m_tp;
+
     real_type m_time_increment = 0;
     // Cached value;
     real_type m_half_time_increment = 0;
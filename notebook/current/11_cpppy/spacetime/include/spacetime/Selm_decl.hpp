@@ -70,6 +70,13 @@ public:
 
     value_type so0p(size_t iv) const { return so0(iv); }
 
+    /**
+     * Read from the scratch arrays of the Field, which must have been filled
+     * for the plane.
+     */
+    value_type so0p_cached(size_t iv) const { return field().cached_so0p(xindex(), iv); }
+    value_type tp_cached(size_t iv) const { return field().cached_tp(xindex(), iv); }
+
     value_type & update_cfl() { cfl() = 0.0; return cfl(); }
 
 }; /* end class Selm */
@@ -20,6 +20,8 @@ public:
     using base_type = SolverBase<Solver, Celm, Selm>;
     using base_type::base_type;
 
+    static char const * name() { return "Solver"; }
+
     static std::shared_ptr<Solver>
     construct(std::shared_ptr<Grid> const & grid, value_type time_increment, size_t nvar)
     {
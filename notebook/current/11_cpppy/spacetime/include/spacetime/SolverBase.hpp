@@ -14,20 +14,14 @@ template< typename ST, typename CE, typename SE >
 inline typename SolverBase<ST,CE,SE>::array_type
 SolverBase<ST,CE,SE>::x(bool odd_plane) const
 {
-    const index_type nselm = grid().nselm() - odd_plane;
-    array_type ret(std::vector<size_t>{nselm});
-    for (index_type it=0; it<nselm; ++it) { ret[it] = selm(it, odd_plane).x(); }
-    return ret;
+    return gather_selm([](SE const & se) { return se.x(); }, odd_plane);
 }
 
 template< typename ST, typename CE, typename SE >
 inline typename SolverBase<ST,CE,SE>::array_type
 SolverBase<ST,CE,SE>::xctr(bool odd_plane) const
 {
-    const index_type nselm = grid().nselm() - odd_plane;
-    array_type ret(std::vector<size_t>{nselm});
-    for (index_type it=0; it<nselm; ++it) { ret[it] = selm(it, odd_plane).xctr(); }
-    return ret;
+    return gather_selm([](SE const & se) { return se.xctr(); }, odd_plane);
 }
 
 template< typename ST, typename CE, typename SE >
@@ -35,10 +29,7 @@ inline typename SolverBase<ST,CE,SE>::array_type
 SolverBase<ST,CE,SE>::get_so0p(size_t iv, bool odd_plane) const
 {
     if (iv >= m_field.nvar()) { throw std::out_of_range("get_so0p(): out of nvar range"); }
-    const index_type nselm = grid().nselm() - odd_plane;
-    array_type ret(std::vector<size_t>{nselm});
-    for (index_type it=0; it<nselm; ++it) { ret[it] = selm(it, odd_plane).so0p(iv); }
-    return ret;
+    return gather_selm([iv](SE const & se) { return se.so0p(iv); }, odd_plane);
 }
 
 template< typename ST, typename CE, typename SE >
@@ -105,15 +96,71 @@ SolverBase<ST,CE,SE>::set_cfl(typename SolverBase<ST,CE,SE>::array_type const &
     for (index_type it=0; it<nselm; ++it) { selm(it, odd_plane).cfl() = arr[it]; }
 }
 
+template< typename ST, typename CE, typename SE >
+template< typename F >
+inline typename SolverBase<ST,CE,SE>::array_type
+SolverBase<ST,CE,SE>::gather_celm(F && func, bool odd_plane) const
+{
+    const index_type ncelm = grid().ncelm() - odd_plane;
+    array_type ret(std::vector<size_t>{ncelm});
+    for (index_type it=0; it<ncelm; ++it) { ret[it] = func(celm(it, odd_plane)); }
+    return ret;
+}
+
+template< typename ST, typename CE, typename SE >
+template< typename F, typename IT >
+inline typename SolverBase<ST,CE,SE>::array_type
+SolverBase<ST,CE,SE>::gather_celm(F && func, IT const & indices, bool odd_plane) const
+{
+    if (1 != indices.shape().size()) { throw std::out_of_range("gather_celm(): indices not 1D"); }
+    array_type ret(std::vector<size_t>{indices.size()});
+    for (size_t it=0; it<indices.size(); ++it) { ret[it] = func(celm_at(indices[it], odd_plane)); }
+    return ret;
+}
+
+template< typename ST, typename CE, typename SE >
+template< typename F >
+inline typename SolverBase<ST,CE,SE>::array_type
+SolverBase<ST,CE,SE>::gather_selm(F && func, bool odd_plane) const
+{
+    const index_type nselm = grid().nselm() - odd_plane;
+    array_type ret(std::vector<size_t>{nselm});
+    for (index_type it=0; it<nselm; ++it) { ret[it] = func(selm(it, odd_plane)); }
+    return ret;
+}
+
+template< typename ST, typename CE, typename SE >
+template< typename F, typename IT >
+inline typename SolverBase<ST,CE,SE>::array_type
+SolverBase<ST,CE,SE>::gather_selm(F && func, IT const & indices, bool odd_plane) const
+{
+    if (1 != indices.shape().size()) { throw std::out_of_range("gather_selm(): indices not 1D"); }
+    array_type ret(std::vector<size_t>{indices.size()});
+    for (size_t it=0; it<indices.size(); ++it) { ret[it] = func(selm_at(indices[it], odd_plane)); }
+    return ret;
+}
+
 template< typename ST, typename CE, typename SE >
 inline void SolverBase<ST,CE,SE>::march_half_so0(bool odd_plane)
 {
     const sindex_type start = odd_plane ? -1 : 0;
     const sindex_type stop = grid().ncelm();
-    for (sindex_type ic=start; ic<stop; ++ic)
+    if (m_use_derived_cache)
     {
-        auto ce = celm(ic, odd_plane);
-        ce.selm_tp().so0(0) = ce.calc_so0(0);
+        m_field.template fill_tp<SE>(odd_plane);
+        for (sindex_type ic=start; ic<stop; ++ic)
+        {
+            auto ce = celm(ic, odd_plane);
+            ce.selm_tp().so0(0) = ce.calc_so0_cached(0);
+        }
+    }
+    else
+    {
+        for (sindex_type ic=start; ic<stop; ++ic)
+        {
+            auto ce = celm(ic, odd_plane);
+            ce.selm_tp().so0(0) = ce.calc_so0(0);
+        }
     }
 }
 
@@ -134,10 +181,22 @@ inline void SolverBase<ST,CE,SE>::march_half_so1_alpha(bool odd_plane)
 {
     const sindex_type start = odd_plane ? -1 : 0;
     const sindex_type stop = grid().ncelm();
-    for (sindex_type ic=start; ic<stop; ++ic)
+    if (m_use_derived_cache)
+    {
+        m_field.template fill_so0p<SE>(odd_plane);
+        for (sindex_type ic=start; ic<stop; ++ic)
+        {
+            auto ce = celm(ic, odd_plane);
+            ce.selm_tp().so1(0) = ce.template calc_so1_alpha_cached<ALPHA>(0);
+        }
+    }
+    else
     {
-        auto ce = celm(ic, odd_plane);
-        ce.selm_tp().so1(0) = ce.template calc_so1_alpha<ALPHA>(0);
+        for (sindex_type ic=start; ic<stop; ++ic)
+        {
+            auto ce = celm(ic, odd_plane);
+            ce.selm_tp().so1(0) = ce.template calc_so1_alpha<ALPHA>(0);
+        }
     }
 }
 
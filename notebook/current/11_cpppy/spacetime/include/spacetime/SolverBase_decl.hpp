@@ -110,6 +110,16 @@ public:
 
     void set_time_increment(value_type time_increment) { m_field.set_time_increment(time_increment); }
 
+    /**
+     * Let the marching kernels compute tp and so0p once per SE into the
+     * scratch arrays of the Field, instead of once for each of the two
+     * neighboring CEs.  The results are identical either way.  It is off by
+     * default because the extra pass costs more than recomputing the cheap
+     * scalar fluxes.
+     */
+    bool use_derived_cache() const { return m_use_derived_cache; }
+    void set_use_derived_cache(bool value) { m_use_derived_cache = value; }
+
     real_type time_increment() const { return m_field.time_increment(); }
     real_type dt() const { return m_field.dt(); }
     real_type hdt() const { return m_field.hdt(); }
@@ -129,6 +139,16 @@ public:
     SE const selm_at(sindex_type ielm, bool odd_plane) const { return m_field.selm_at<SE>(ielm, odd_plane); }
     SE       selm_at(sindex_type ielm, bool odd_plane)       { return m_field.selm_at<SE>(ielm, odd_plane); }
 
+    /**
+     * Evaluate a functor of a CE or SE for all elements on a plane, or for the
+     * elements of the given 1D index array, and collect the results in an
+     * array.  The indices are bounds-checked.
+     */
+    template< typename F > array_type gather_celm(F && func, bool odd_plane) const;
+    template< typename F, typename IT > array_type gather_celm(F && func, IT const & indices, bool odd_plane) const;
+    template< typename F > array_type gather_selm(F && func, bool odd_plane) const;
+    template< typename F, typename IT > array_type gather_selm(F && func, IT const & indices, bool odd_plane) const;
+
     void update_cfl(bool odd_plane);
     void march_half_so0(bool odd_plane);
     template <size_t ALPHA> void march_half_so1_alpha(bool odd_plane);
@@ -143,6 +163,7 @@ public:
 private:
 
     Field m_field;
+    bool m_use_derived_cache = false;
 
 }; /* end class SolverBase */
 
@@ -0,0 +1,429 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Native driver: read a run configuration and march a solver without Python.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+#include "spacetime/Grid.hpp"
+#include "spacetime/Field.hpp"
+#include "spacetime/SolverBase.hpp"
+#include "spacetime/kernel/linear_scalar.hpp"
+#include "spacetime/kernel/inviscid_burgers.hpp"
+
+namespace spacetime
+{
+
+/**
+ * Run configuration of the native driver.  The text format is one
+ * "key = value" pair per line.  Blank lines are ignored and "#" starts a
+ * comment.  Recognized keys:
+ *
+ *   equation         linear_scalar or inviscid_burgers
+ *   xmin, xmax       domain bounds
+ *   ncelm            number of conservation elements
+ *   dt               time increment; takes precedence over cfl
+ *   cfl              CFL number used to derive dt when dt is not given
+ *   alpha            order of the alpha scheme (0, 1, or 2)
+ *   steps            number of full time steps
+ *   init             initial condition: sine, gaussian, or step
+ *   output           path of the output file; empty for no output
+ *   output_interval  write every this many steps; 0 for the final step only
+ */
+class RunConfig
+{
+
+public:
+
+    static RunConfig from_stream(std::istream & is);
+    static RunConfig from_file(std::string const & path);
+
+    RunConfig() = default;
+    RunConfig(RunConfig const & ) = default;
+    RunConfig(RunConfig       &&) = default;
+    RunConfig & operator=(RunConfig const & ) = default;
+    RunConfig & operator=(RunConfig       &&) = default;
+    ~RunConfig() = default;
+
+    void set(std::string const & key, std::string const & value);
+
+    std::string const & equation() const { return m_equation; }
+    real_type xmin() const { return m_xmin; }
+    real_type xmax() const { return m_xmax; }
+    size_t ncelm() const { return m_ncelm; }
+    real_type dt() const { return m_dt; }
+    real_type cfl() const { return m_cfl; }
+    size_t alpha() const { return m_alpha; }
+    size_t steps() const { return m_steps; }
+    std::string const & init() const { return m_init; }
+    std::string const & output() const { return m_output; }
+    size_t output_interval() const { return m_output_interval; }
+
+private:
+
+    static std::string strip(std::string const & str);
+    static real_type to_real(std::string const & key, std::string const & value);
+    static size_t to_size(std::string const & key, std::string const & value);
+
+    std::string m_equation = "linear_scalar";
+    real_type m_xmin = 0;
+    real_type m_xmax = 2 * M_PI;
+    size_t m_ncelm = 100;
+    real_type m_dt = 0;
+    real_type m_cfl = 1;
+    size_t m_alpha = 2;
+    size_t m_steps = 0;
+    std::string m_init = "sine";
+    std::string m_output;
+    size_t m_output_interval = 0;
+
+}; /* end class RunConfig */
+
+inline
+RunConfig RunConfig::from_stream(std::istream & is)
+{
+    RunConfig ret;
+    std::string line;
+    size_t lineno = 0;
+    while (std::getline(is, line))
+    {
+        ++lineno;
+        const size_t pcomment = line.find('#');
+        if (pcomment != std::string::npos) { line.erase(pcomment); }
+        line = strip(line);
+        if (line.empty()) { continue; }
+        const size_t peq = line.find('=');
+        if (peq == std::string::npos)
+        {
+            throw std::invalid_argument(Formatter()
+                << "RunConfig::from_stream() line " << lineno
+                << ": \"" << line << "\" is not a key = value pair"
+            );
+        }
+        ret.set(strip(line.substr(0, peq)), strip(line.substr(peq+1)));
+    }
+    return ret;
+}
+
+inline
+RunConfig RunConfig::from_file(std::string const & path)
+{
+    std::ifstream ifs(path);
+    if (!ifs)
+    {
+        throw std::invalid_argument(Formatter()
+            << "RunConfig::from_file(path=" << path << "): cannot open"
+        );
+    }
+    return from_stream(ifs);
+}
+
+inline
+void RunConfig::set(std::string const & key, std::string const & value)
+{
+    if      ("equation" == key) { m_equation = value; }
+    else if ("xmin" == key) { m_xmin = to_real(key, value); }
+    else if ("xmax" == key) { m_xmax = to_real(key, value); }
+    else if ("ncelm" == key) { m_ncelm = to_size(key, value); }
+    else if ("dt" == key) { m_dt = to_real(key, value); }
+    else if ("cfl" == key) { m_cfl = to_real(key, value); }
+    else if ("alpha" == key)
+    {
+        const size_t alpha = to_size(key, value);
+        if (alpha > 2)
+        {
+            throw std::invalid_argument(Formatter()
+                << "RunConfig::set(key=" << key << ", value=" << value
+                << "): alpha not in {0, 1, 2}"
+            );
+        }
+        m_alpha = alpha;
+    }
+    else if ("steps" == key) { m_steps = to_size(key, value); }
+    else if ("init" == key) { m_init = value; }
+    else if ("output" == key) { m_output = value; }
+    else if ("output_interval" == key) { m_output_interval = to_size(key, value); }
+    else
+    {
+        throw std::invalid_argument(Formatter()
+            << "RunConfig::set(key=" << key << "): unknown key"
+        );
+    }
+}
+
+inline
+std::string RunConfig::strip(std::string const & str)
+{
+    const char * spaces = " \t\r\n";
+    const size_t begin = str.find_first_not_of(spaces);
+    if (begin == std::string::npos) { return std::string(); }
+    const size_t end = str.find_last_not_of(spaces);
+    return str.substr(begin, end-begin+1);
+}
+
+inline
+real_type RunConfig::to_real(std::string const & key, std::string const & value)
+{
+    size_t pos = 0;
+    real_type ret = 0;
+    try { ret = std::stod(value, &pos); }
+    catch (std::logic_error const &) { pos = 0; }
+    if (0 == pos || pos != value.size())
+    {
+        throw std::invalid_argument(Formatter()
+            << "RunConfig::set(key=" << key << ", value=" << value
+            << "): not a real number"
+        );
+    }
+    return ret;
+}
+
+inline
+size_t RunConfig::to_size(std::string const & key, std::string const & value)
+{
+    size_t pos = 0;
+    size_t ret = 0;
+    if (!value.empty() && '-' != value[0])
+    {
+        try { ret = std::stoul(value, &pos); }
+        catch (std::logic_error const &) { pos = 0; }
+    }
+    if (0 == pos || pos != value.size())
+    {
+        throw std::invalid_argument(Formatter()
+            << "RunConfig::set(key=" << key << ", value=" << value
+            << "): not a non-negative integer"
+        );
+    }
+    return ret;
+}
+
+/**
+ * Build, initialize, march, and write out a solver according to a RunConfig.
+ */
+class Driver
+{
+
+public:
+
+    using value_type = real_type;
+    using array_type = Grid::array_type;
+
+    explicit Driver(RunConfig config) : m_config(std::move(config)) {}
+
+    Driver() = delete;
+    Driver(Driver const & ) = delete;
+    Driver(Driver       &&) = delete;
+    Driver & operator=(Driver const & ) = delete;
+    Driver & operator=(Driver       &&) = delete;
+    ~Driver() = default;
+
+    RunConfig const & config() const { return m_config; }
+
+    /**
+     * Run the configured problem and return the number of snapshots written.
+     */
+    size_t run();
+
+    template< typename ST > std::shared_ptr<ST> build_solver() const;
+    template< typename ST > size_t run_solver(ST & svr, std::ostream * os) const;
+    template< typename ST > static void write(std::ostream & os, ST const & svr, size_t step);
+
+private:
+
+    template< typename ST > void march(ST & svr, size_t steps) const;
+
+    void initialize(array_type const & xctr, array_type & so0, array_type & so1) const;
+
+    RunConfig m_config;
+
+}; /* end class Driver */
+
+template< typename ST >
+inline
+std::shared_ptr<ST> Driver::build_solver() const
+{
+    std::shared_ptr<Grid> grid = Grid::construct(m_config.xmin(), m_config.xmax(), m_config.ncelm());
+    std::shared_ptr<ST> svr = ST::construct(grid, 1);
+
+    const array_type xctr = svr->xctr(false);
+    array_type so0(std::vector<size_t>{xctr.size()});
+    array_type so1(std::vector<size_t>{xctr.size()});
+    initialize(xctr, so0, so1);
+    svr->set_so0(0, so0, false);
+    svr->set_so1(0, so1, false);
+
+    real_type dt = m_config.dt();
+    if (dt <= 0)
+    {
+        // The wave speed is unity for the linear scalar equation and |u| for
+        // the inviscid Burgers equation.
+        real_type speed = 1;
+        if ("inviscid_burgers" == m_config.equation())
+        {
+            speed = 0;
+            for (size_t it=0; it<so0.size(); ++it) { speed = std::max(speed, std::fabs(so0[it])); }
+        }
+        const real_type dx = (m_config.xmax() - m_config.xmin()) / m_config.ncelm();
+        dt = m_config.cfl() * dx / (speed > 0 ? speed : 1);
+    }
+    svr->set_time_increment(dt);
+    svr->setup_march();
+    return svr;
+}
+
+template< typename ST >
+inline
+size_t Driver::run_solver(ST & svr, std::ostream * os) const
+{
+    const size_t nstep = m_config.steps();
+    const size_t interval = m_config.output_interval();
+    size_t nwrite = 0;
+    if (nullptr != os && interval > 0)
+    {
+        write(*os, svr, 0);
+        ++nwrite;
+    }
+    size_t current = 0;
+    while (current < nstep)
+    {
+        size_t chunk = nstep - current;
+        if (interval > 0) { chunk = std::min(chunk, interval - current % interval); }
+        march(svr, chunk);
+        current += chunk;
+        if (nullptr != os && (current == nstep || (interval > 0 && 0 == current % interval)))
+        {
+            write(*os, svr, current);
+            ++nwrite;
+        }
+    }
+    if (nullptr != os && 0 == nstep && 0 == interval)
+    {
+        write(*os, svr, 0);
+        ++nwrite;
+    }
+    return nwrite;
+}
+
+template< typename ST >
+inline
+void Driver::write(std::ostream & os, ST const & svr, size_t step)
+{
+    const array_type x = svr.xctr(false);
+    const array_type so0 = svr.get_so0(0, false);
+    const array_type so1 = svr.get_so1(0, false);
+    os << "# step " << step << " time " << step * svr.dt() << "\n";
+    for (size_t it=0; it<x.size(); ++it)
+    {
+        os << x[it] << " " << so0[it] << " " << so1[it] << "\n";
+    }
+    os << "\n";
+}
+
+template< typename ST >
+inline
+void Driver::march(ST & svr, size_t steps) const
+{
+    switch (m_config.alpha())
+    {
+    case 0: svr.template march_alpha<0>(steps); break;
+    case 1: svr.template march_alpha<1>(steps); break;
+    case 2: svr.template march_alpha<2>(steps); break;
+    default:
+        throw std::invalid_argument(Formatter()
+            << "Driver::march(): alpha=" << m_config.alpha() << " not in {0, 1, 2}"
+        );
+    }
+}
+
+inline
+void Driver::initialize(array_type const & xctr, array_type & so0, array_type & so1) const
+{
+    const real_type xmin = m_config.xmin();
+    const real_type xmax = m_config.xmax();
+    const real_type xmid = (xmin + xmax) / 2;
+    if ("sine" == m_config.init())
+    {
+        // One full period over the domain.
+        const real_type kwave = 2 * M_PI / (xmax - xmin);
+        for (size_t it=0; it<xctr.size(); ++it)
+        {
+            so0[it] = std::sin(kwave * (xctr[it] - xmin));
+            so1[it] = kwave * std::cos(kwave * (xctr[it] - xmin));
+        }
+    }
+    else if ("gaussian" == m_config.init())
+    {
+        const real_type width = (xmax - xmin) / 10;
+        for (size_t it=0; it<xctr.size(); ++it)
+        {
+            const real_type xi = (xctr[it] - xmid) / width;
+            so0[it] = std::exp(-xi * xi);
+            so1[it] = -2 * xi / width * so0[it];
+        }
+    }
+    else if ("step" == m_config.init())
+    {
+        for (size_t it=0; it<xctr.size(); ++it)
+        {
+            so0[it] = xctr[it] < xmid ? 1 : 0;
+            so1[it] = 0;
+        }
+    }
+    else
+    {
+        throw std::invalid_argument(Formatter()
+            << "Driver::initialize(): unknown init=" << m_config.init()
+        );
+    }
+}
+
+inline
+size_t Driver::run()
+{
+    std::ofstream ofs;
+    std::ostream * os = nullptr;
+    if (!m_config.output().empty())
+    {
+        ofs.open(m_config.output());
+        if (!ofs)
+        {
+            throw std::invalid_argument(Formatter()
+                << "Driver::run(): cannot open output=" << m_config.output()
+            );
+        }
+        ofs.precision(17);
+        os = &ofs;
+    }
+
+    if ("linear_scalar" == m_config.equation())
+    {
+        return run_solver(*build_solver<LinearScalarSolver>(), os);
+    }
+    if ("inviscid_burgers" == m_config.equation())
+    {
+        return run_solver(*build_solver<InviscidBurgersSolver>(), os);
+    }
+    throw std::invalid_argument(Formatter()
+        << "Driver::run(): unknown equation=" << m_config.equation()
+    );
+}
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
@@ -39,6 +39,8 @@ public:
     using base_type = SolverBase<InviscidBurgersSolver, InviscidBurgersCelm, InviscidBurgersSelm>;
     using base_type::base_type;
 
+    static char const * name() { return "InviscidBurgersSolver"; }
+
     static std::shared_ptr<InviscidBurgersSolver>
     construct(std::shared_ptr<Grid> const & grid, value_type time_increment)
     {
@@ -36,6 +36,8 @@ public:
     using base_type = SolverBase<LinearScalarSolver, LinearScalarCelm, LinearScalarSelm>;
     using base_type::base_type;
 
+    static char const * name() { return "LinearScalarSolver"; }
+
     static std::shared_ptr<LinearScalarSolver>
     construct(std::shared_ptr<Grid> const & grid, value_type time_increment)
     {
@@ -14,6 +14,7 @@
 #include "spacetime/python/wrapper_linear_scalar.hpp"
 #include "spacetime/python/wrapper_inviscid_burgers.hpp"
 #include "spacetime/python/wrapper_spacetime.hpp"
+#include "spacetime/python/wrapper_scheduler.hpp"
 #include "spacetime/python/WrapBase.hpp"
 
 /* vim: set et ts=4 sw=4: */
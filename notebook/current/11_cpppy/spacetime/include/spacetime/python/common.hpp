@@ -334,6 +334,32 @@ protected:
       , py::arg("steps") \
     )
 
+#define DECL_ST_WRAP_GATHER(ELM, NAME, EXPR) \
+    .def \
+    ( \
+        "get_" #ELM "_" #NAME \
+      , [](wrapped_type const & self, py::object const & indices, bool odd_plane) \
+        { \
+            auto func = [](typename wrapped_type::ELM ## _type const & elm) { return EXPR; }; \
+            if (indices.is_none()) { return self.gather_ ## ELM(func, odd_plane); } \
+            return self.gather_ ## ELM(func, indices.cast<xt::pyarray<sindex_type>>(), odd_plane); \
+        } \
+      , py::arg("indices")=py::none(), py::arg("odd_plane")=false \
+    )
+#define DECL_ST_WRAP_GATHER_IV(ELM, NAME, EXPR) \
+    .def \
+    ( \
+        "get_" #ELM "_" #NAME \
+      , [](wrapped_type const & self, size_t iv, py::object const & indices, bool odd_plane) \
+        { \
+            if (iv >= self.nvar()) { throw std::out_of_range("get_" #ELM "_" #NAME "(): out of nvar range"); } \
+            auto func = [iv](typename wrapped_type::ELM ## _type const & elm) { return EXPR; }; \
+            if (indices.is_none()) { return self.gather_ ## ELM(func, odd_plane); } \
+            return self.gather_ ## ELM(func, indices.cast<xt::pyarray<sindex_type>>(), odd_plane); \
+        } \
+      , py::arg("iv"), py::arg("indices")=py::none(), py::arg("odd_plane")=false \
+    )
+
         (*this)
             .def("__str__", &detail::to_str<wrapped_type>)
             .def("clone", &wrapped_type::clone, py::arg("grid")=false)
@@ -349,6 +375,25 @@ protected:
             .def_property_readonly("dt", &wrapped_type::dt)
             .def_property_readonly("hdt", &wrapped_type::hdt)
             .def_property_readonly("qdt", &wrapped_type::qdt)
+            .def_property(
+                "use_derived_cache"
+              , &wrapped_type::use_derived_cache
+              , &wrapped_type::set_use_derived_cache
+             )
+            .def
+            (
+                "autotune"
+              , [](wrapped_type & self, size_t steps, size_t alpha, bool save)
+                {
+                    return MarchTuner::me().tune(self, steps, alpha, save).to_string();
+                }
+              , py::arg("steps")=10, py::arg("alpha")=2, py::arg("save")=true
+            )
+            .def
+            (
+                "apply_tuning"
+              , [](wrapped_type & self) { return MarchTuner::me().apply(self); }
+            )
             .def("celm" , static_cast<celm_getter>(&wrapped_type::celm_at)
                , py::arg("ielm"), py::arg("odd_plane")=false)
             .def("selm" , static_cast<selm_getter>(&wrapped_type::selm_at)
@@ -379,8 +424,35 @@ protected:
             DECL_ST_WRAP_MARCH_ALPHA(0)
             DECL_ST_WRAP_MARCH_ALPHA(1)
             DECL_ST_WRAP_MARCH_ALPHA(2)
+            // Bulk queries of the element properties.
+            DECL_ST_WRAP_GATHER(celm, x, elm.x())
+            DECL_ST_WRAP_GATHER(celm, dx, elm.dx())
+            DECL_ST_WRAP_GATHER(celm, xneg, elm.xneg())
+            DECL_ST_WRAP_GATHER(celm, xpos, elm.xpos())
+            DECL_ST_WRAP_GATHER(celm, xctr, elm.xctr())
+            DECL_ST_WRAP_GATHER_IV(celm, calc_so0, elm.calc_so0(iv))
+            DECL_ST_WRAP_GATHER_IV(celm, calc_so1_alpha0, elm.template calc_so1_alpha<0>(iv))
+            DECL_ST_WRAP_GATHER_IV(celm, calc_so1_alpha1, elm.template calc_so1_alpha<1>(iv))
+            DECL_ST_WRAP_GATHER_IV(celm, calc_so1_alpha2, elm.template calc_so1_alpha<2>(iv))
+            DECL_ST_WRAP_GATHER(selm, x, elm.x())
+            DECL_ST_WRAP_GATHER(selm, dx, elm.dx())
+            DECL_ST_WRAP_GATHER(selm, xneg, elm.xneg())
+            DECL_ST_WRAP_GATHER(selm, xpos, elm.xpos())
+            DECL_ST_WRAP_GATHER(selm, xctr, elm.xctr())
+            DECL_ST_WRAP_GATHER(selm, dxneg, elm.dxneg())
+            DECL_ST_WRAP_GATHER(selm, dxpos, elm.dxpos())
+            DECL_ST_WRAP_GATHER(selm, cfl, elm.cfl())
+            DECL_ST_WRAP_GATHER_IV(selm, so0, elm.so0(iv))
+            DECL_ST_WRAP_GATHER_IV(selm, so1, elm.so1(iv))
+            DECL_ST_WRAP_GATHER_IV(selm, so0p, elm.so0p(iv))
+            DECL_ST_WRAP_GATHER_IV(selm, xn, elm.xn(iv))
+            DECL_ST_WRAP_GATHER_IV(selm, xp, elm.xp(iv))
+            DECL_ST_WRAP_GATHER_IV(selm, tn, elm.tn(iv))
+            DECL_ST_WRAP_GATHER_IV(selm, tp, elm.tp(iv))
         ;
 
+#undef DECL_ST_WRAP_GATHER_IV
+#undef DECL_ST_WRAP_GATHER
 #undef DECL_ST_WRAP_MARCH_ALPHA
 #undef DECL_ST_WRAP_ARRAY_ACCESS_1D
 #undef DECL_ST_WRAP_ARRAY_ACCESS_0D
@@ -0,0 +1,60 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+#include "spacetime/python/common.hpp"
+
+namespace spacetime
+{
+
+namespace python
+{
+
+class
+SPACETIME_PYTHON_WRAPPER_VISIBILITY
+WrapMarchScheduler
+  : public WrapBase< WrapMarchScheduler, MarchScheduler >
+{
+
+    friend base_type;
+
+    template< typename ST >
+    wrapper_type & def_add()
+    {
+        namespace py = pybind11;
+        return (*this)
+            .def
+            (
+                "add"
+              , &wrapped_type::add<ST>
+              , py::arg("solver"), py::arg("steps"), py::arg("alpha")=2
+            )
+        ;
+    }
+
+    WrapMarchScheduler(pybind11::module * mod, const char * pyname, const char * clsdoc)
+      : base_type(mod, pyname, clsdoc)
+    {
+        namespace py = pybind11;
+        (*this)
+            .def(py::init<size_t>(), py::arg("nthread")=0)
+            .def_property_readonly("nthread", &wrapped_type::nthread)
+            .def_property_readonly("njob", &wrapped_type::njob)
+            .def_property("grain", &wrapped_type::grain, &wrapped_type::set_grain)
+            .def("run", &wrapped_type::run, py::call_guard<py::gil_scoped_release>())
+        ;
+        def_add<Solver>();
+        def_add<LinearScalarSolver>();
+        def_add<InviscidBurgersSolver>();
+    }
+
+}; /* end class WrapMarchScheduler */
+
+} /* end namespace python */
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
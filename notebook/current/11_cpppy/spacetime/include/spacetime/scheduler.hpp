@@ -0,0 +1,324 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Work-stealing thread pool marching many solvers in one process.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+
+namespace spacetime
+{
+
+/**
+ * Marching of a solver is sequential, but independent solvers can march
+ * concurrently.  Each added solver becomes a job of half steps.  A task runs
+ * a chunk of the half steps of a job, sized so that it processes about
+ * grain() cells: small solvers run many half steps per task, and large
+ * solvers one.
+ *
+ * Every worker thread owns a deque of jobs.  A worker takes the job at the
+ * back of its own deque, runs a task, and pushes the job back there, so a
+ * solver tends to stay on the same core.  A worker with an empty deque steals
+ * from the front of the others', which balances the load of solvers with
+ * different sizes.
+ */
+class MarchScheduler
+{
+
+public:
+
+    /**
+     * @param nthread Number of worker threads.  0 means the number of
+     *  hardware threads.
+     */
+    explicit MarchScheduler(size_t nthread=0);
+
+    MarchScheduler(MarchScheduler const & ) = delete;
+    MarchScheduler(MarchScheduler       &&) = delete;
+    MarchScheduler & operator=(MarchScheduler const & ) = delete;
+    MarchScheduler & operator=(MarchScheduler       &&) = delete;
+    ~MarchScheduler();
+
+    size_t nthread() const { return m_worker.size(); }
+    size_t njob() const { return m_job.size(); }
+
+    size_t grain() const { return m_grain; }
+    void set_grain(size_t value) { m_grain = std::max(value, size_t(1)); }
+
+    /**
+     * Queue the solver to march the given number of steps with
+     * march_half1_alpha() and march_half2_alpha().  A solver can be queued
+     * only once per run().
+     */
+    template< typename ST >
+    void add(std::shared_ptr<ST> const & svr, size_t steps, size_t alpha=2);
+
+    /**
+     * March all the queued solvers and block until they finish.  The queue is
+     * emptied.  The first exception thrown by a solver stops the others and
+     * is rethrown.
+     */
+    void run();
+
+private:
+
+    struct Job
+    {
+        void const * solver;
+        // March the half step of the given index; even is the first half.
+        std::function<void(size_t)> march_half;
+        size_t nhalf;
+        size_t chunk;
+        size_t done;
+    }; /* end struct Job */
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<size_t> jobs;
+    }; /* end struct Worker */
+
+    template< typename ST, size_t ALPHA >
+    static std::function<void(size_t)> make_march_half(std::shared_ptr<ST> const & svr)
+    {
+        return [svr](size_t ihalf)
+        {
+            if (0 == ihalf % 2) { svr->template march_half1_alpha<ALPHA>(); }
+            else                { svr->template march_half2_alpha<ALPHA>(); }
+        };
+    }
+
+    void work(size_t iworker);
+    bool take(size_t iworker, size_t & ijob);
+    size_t push(size_t iworker, size_t ijob);
+    void execute(size_t iworker, size_t ijob);
+    void finish();
+
+    size_t m_grain = 1 << 16;
+    std::vector<Job> m_job;
+
+    std::vector<std::unique_ptr<Worker>> m_worker;
+    std::vector<std::thread> m_thread;
+
+    std::mutex m_mutex;
+    std::condition_variable m_work_cv;
+    std::condition_variable m_done_cv;
+    std::atomic<size_t> m_queued{0};
+    std::atomic<size_t> m_nidle{0};
+    std::atomic<bool> m_abort{false};
+    size_t m_remaining = 0;
+    bool m_stop = false;
+    std::exception_ptr m_error;
+
+}; /* end class MarchScheduler */
+
+inline
+MarchScheduler::MarchScheduler(size_t nthread)
+{
+    if (0 == nthread) { nthread = std::max(std::thread::hardware_concurrency(), 1u); }
+    for (size_t it=0; it<nthread; ++it) { m_worker.emplace_back(new Worker); }
+    for (size_t it=0; it<nthread; ++it) { m_thread.emplace_back(&MarchScheduler::work, this, it); }
+}
+
+inline
+MarchScheduler::~MarchScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_cv.notify_all();
+    for (std::thread & thread : m_thread) { thread.join(); }
+}
+
+template< typename ST >
+inline
+void MarchScheduler::add(std::shared_ptr<ST> const & svr, size_t steps, size_t alpha)
+{
+    if (!svr)
+    {
+        throw std::invalid_argument("MarchScheduler::add(): null solver");
+    }
+    for (Job const & job : m_job)
+    {
+        if (job.solver == svr.get())
+        {
+            throw std::invalid_argument("MarchScheduler::add(): solver already queued");
+        }
+    }
+    Job job;
+    job.solver = svr.get();
+    switch (alpha)
+    {
+    case 0: job.march_half = make_march_half<ST, 0>(svr); break;
+    case 1: job.march_half = make_march_half<ST, 1>(svr); break;
+    case 2: job.march_half = make_march_half<ST, 2>(svr); break;
+    default:
+        throw std::invalid_argument(Formatter() << "MarchScheduler::add(): alpha " << alpha << " not in {0, 1, 2}");
+    }
+    job.nhalf = 2 * steps;
+    job.chunk = std::max(m_grain / std::max(size_t(svr->grid().ncelm()), size_t(1)), size_t(1));
+    job.done = 0;
+    m_job.push_back(std::move(job));
+}
+
+inline
+void MarchScheduler::run()
+{
+    m_abort = false;
+    m_error = nullptr;
+    m_remaining = 0;
+    for (size_t ijob=0; ijob<m_job.size(); ++ijob)
+    {
+        if (m_job[ijob].nhalf > 0) { ++m_remaining; }
+    }
+    if (m_remaining > 0)
+    {
+        // Deal the jobs round-robin; stealing evens out what is left.
+        size_t iworker = 0;
+        for (size_t ijob=0; ijob<m_job.size(); ++ijob)
+        {
+            if (0 == m_job[ijob].nhalf) { continue; }
+            push(iworker, ijob);
+            iworker = (iworker + 1) % m_worker.size();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+        m_work_cv.notify_all();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done_cv.wait(lock, [this]{ return 0 == m_remaining; });
+    }
+    m_job.clear();
+    if (m_error) { std::rethrow_exception(m_error); }
+}
+
+inline
+size_t MarchScheduler::push(size_t iworker, size_t ijob)
+{
+    size_t depth;
+    {
+        std::lock_guard<std::mutex> lock(m_worker[iworker]->mutex);
+        m_worker[iworker]->jobs.push_back(ijob);
+        depth = m_worker[iworker]->jobs.size();
+        ++m_queued;
+    }
+    return depth;
+}
+
+inline
+bool MarchScheduler::take(size_t iworker, size_t & ijob)
+{
+    {
+        Worker & self = *m_worker[iworker];
+        std::lock_guard<std::mutex> lock(self.mutex);
+        if (!self.jobs.empty())
+        {
+            ijob = self.jobs.back();
+            self.jobs.pop_back();
+            --m_queued;
+            return true;
+        }
+    }
+    for (size_t it=1; it<m_worker.size(); ++it)
+    {
+        Worker & victim = *m_worker[(iworker + it) % m_worker.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty())
+        {
+            ijob = victim.jobs.front();
+            victim.jobs.pop_front();
+            --m_queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline
+void MarchScheduler::work(size_t iworker)
+{
+    while (true)
+    {
+        size_t ijob;
+        if (take(iworker, ijob))
+        {
+            execute(iworker, ijob);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        ++m_nidle;
+        m_work_cv.wait(lock, [this]{ return m_stop || m_queued > 0; });
+        --m_nidle;
+        if (m_stop) { return; }
+    }
+}
+
+inline
+void MarchScheduler::execute(size_t iworker, size_t ijob)
+{
+    Job & job = m_job[ijob];
+    if (!m_abort)
+    {
+        try
+        {
+            const size_t end = std::min(job.done + job.chunk, job.nhalf);
+            for ( ; job.done<end; ++job.done) { job.march_half(job.done); }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error) { m_error = std::current_exception(); }
+            m_abort = true;
+        }
+    }
+    if (!m_abort && job.done < job.nhalf)
+    {
+        // The job just pushed is taken again by this worker.  Wake an idle
+        // worker only if there are more for it to steal.
+        if (push(iworker, ijob) > 1 && m_nidle > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+            }
+            m_work_cv.notify_one();
+        }
+    }
+    else
+    {
+        finish();
+    }
+}
+
+inline
+void MarchScheduler::finish()
+{
+    bool done;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        done = 0 == --m_remaining;
+    }
+    if (done) { m_done_cv.notify_all(); }
+}
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,344 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/**
+ * Auto-tuning of the marching parameters, persisted per machine.
+ */
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "spacetime/system.hpp"
+#include "spacetime/type.hpp"
+
+namespace spacetime
+{
+
+/**
+ * Parameters that change the speed but not the result of marching.  So far
+ * the only one is use_derived_cache.
+ */
+class MarchParameter
+{
+
+public:
+
+    MarchParameter() = default;
+    explicit MarchParameter(bool use_derived_cache) : m_use_derived_cache(use_derived_cache) {}
+
+    /**
+     * All the candidates the tuner benchmarks.
+     */
+    static std::vector<MarchParameter> candidates()
+    {
+        return { MarchParameter(false), MarchParameter(true) };
+    }
+
+    static MarchParameter from_string(std::string const & str);
+    std::string to_string() const { return Formatter() << "use_derived_cache=" << m_use_derived_cache; }
+
+    bool use_derived_cache() const { return m_use_derived_cache; }
+
+    template< typename ST > static MarchParameter from_solver(ST const & svr)
+    {
+        return MarchParameter(svr.use_derived_cache());
+    }
+
+    template< typename ST > void apply(ST & svr) const
+    {
+        svr.set_use_derived_cache(m_use_derived_cache);
+    }
+
+private:
+
+    bool m_use_derived_cache = false;
+
+}; /* end class MarchParameter */
+
+inline
+MarchParameter MarchParameter::from_string(std::string const & str)
+{
+    MarchParameter ret;
+    std::istringstream iss(str);
+    std::string item;
+    while (iss >> item)
+    {
+        const size_t peq = item.find('=');
+        const std::string key = item.substr(0, peq);
+        const std::string value = peq == std::string::npos ? std::string() : item.substr(peq+1);
+        if ("use_derived_cache" == key && ("0" == value || "1" == value))
+        {
+            ret.m_use_derived_cache = "1" == value;
+        }
+        else
+        {
+            throw std::invalid_argument(Formatter()
+                << "MarchParameter::from_string(\"" << str << "\"): bad item " << item
+            );
+        }
+    }
+    return ret;
+}
+
+/**
+ * Process-wide registry of tuned marching parameters.  The entries are keyed
+ * by the CPU model, the solver, and the problem size rounded down to a power
+ * of 2.  They are loaded from the cache file once, when first needed.
+ *
+ * Applying the tuned parameters is opt-in: constructing a solver neither
+ * reads the cache file nor changes the solver until apply() is called on it.
+ *
+ * The cache file is $LIBST_TUNING_FILE, or libst/tuning.txt under
+ * $XDG_CACHE_HOME or $HOME/.cache.  Each line is
+ * "CPU<TAB>SOLVER<TAB>SIZE<TAB>PARAMETERS".
+ */
+class MarchTuner
+{
+
+public:
+
+    static MarchTuner & me()
+    {
+        static MarchTuner inst;
+        return inst;
+    }
+
+    MarchTuner(MarchTuner const & ) = delete;
+    MarchTuner(MarchTuner       &&) = delete;
+    MarchTuner & operator=(MarchTuner const & ) = delete;
+    MarchTuner & operator=(MarchTuner       &&) = delete;
+    ~MarchTuner() = default;
+
+    static std::string cpu_model();
+    static std::string default_path();
+
+    std::string path() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_path;
+    }
+
+    /**
+     * Switch to another cache file and drop the entries loaded from the old
+     * one.
+     */
+    void set_path(std::string const & path)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_path = path;
+        m_entry.clear();
+        m_loaded = false;
+    }
+
+    static std::string key(char const * solver, size_t ncelm);
+
+    bool lookup(std::string const & key, MarchParameter & param);
+    void store(std::string const & key, MarchParameter const & param, bool save);
+
+    /**
+     * Apply the tuned parameters, if any, to the solver.  Return whether
+     * there are.
+     */
+    template< typename ST > bool apply(ST & svr);
+
+    /**
+     * Benchmark every candidate on clones of the solver for the given number
+     * of steps of the alpha scheme (0, 1, or 2), apply the fastest to the
+     * solver, and record it.
+     */
+    template< typename ST > MarchParameter tune(ST & svr, size_t steps, size_t alpha=2, bool save=true);
+
+private:
+
+    MarchTuner() : m_path(default_path()) {}
+
+    void load();
+    void save() const;
+
+    mutable std::mutex m_mutex;
+    std::string m_path;
+    bool m_loaded = false;
+    std::map<std::string, MarchParameter> m_entry;
+
+}; /* end class MarchTuner */
+
+inline
+std::string MarchTuner::cpu_model()
+{
+    std::ifstream ifs("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        if (0 == line.compare(0, 10, "model name"))
+        {
+            const size_t pcolon = line.find(':');
+            if (pcolon != std::string::npos)
+            {
+                const size_t begin = line.find_first_not_of(' ', pcolon+1);
+                return begin == std::string::npos ? std::string() : line.substr(begin);
+            }
+        }
+    }
+    return "unknown";
+}
+
+inline
+std::string MarchTuner::default_path()
+{
+    char const * env = std::getenv("LIBST_TUNING_FILE");
+    if (nullptr != env) { return env; }
+    env = std::getenv("XDG_CACHE_HOME");
+    if (nullptr != env && '\0' != env[0]) { return std::string(env) + "/libst/tuning.txt"; }
+    env = std::getenv("HOME");
+    if (nullptr != env && '\0' != env[0]) { return std::string(env) + "/.cache/libst/tuning.txt"; }
+    return std::string();
+}
+
+inline
+std::string MarchTuner::key(char const * solver, size_t ncelm)
+{
+    static const std::string cpu = cpu_model();
+    size_t bucket = 1;
+    while (bucket <= ncelm / 2) { bucket *= 2; }
+    return Formatter() << cpu << "\t" << solver << "\t" << bucket;
+}
+
+inline
+bool MarchTuner::lookup(std::string const & key, MarchParameter & param)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_loaded) { load(); }
+    auto it = m_entry.find(key);
+    if (it == m_entry.end()) { return false; }
+    param = it->second;
+    return true;
+}
+
+inline
+void MarchTuner::store(std::string const & key, MarchParameter const & param, bool save)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_loaded) { load(); }
+    m_entry[key] = param;
+    if (save) { this->save(); }
+}
+
+template< typename ST >
+inline
+bool MarchTuner::apply(ST & svr)
+{
+    MarchParameter param;
+    if (!lookup(key(ST::name(), svr.grid().ncelm()), param)) { return false; }
+    param.apply(svr);
+    return true;
+}
+
+template< typename ST >
+inline
+MarchParameter MarchTuner::tune(ST & svr, size_t steps, size_t alpha, bool save)
+{
+    using clock_type = std::chrono::steady_clock;
+    constexpr size_t repeat = 3;
+
+    auto march = [alpha](ST & trial, size_t nstep)
+    {
+        switch (alpha)
+        {
+        case 0: trial.template march_alpha<0>(nstep); break;
+        case 1: trial.template march_alpha<1>(nstep); break;
+        case 2: trial.template march_alpha<2>(nstep); break;
+        default:
+            throw std::invalid_argument(Formatter()
+                << "MarchTuner::tune(): alpha=" << alpha << " not in {0, 1, 2}"
+            );
+        }
+    };
+
+    MarchParameter best = MarchParameter::from_solver(svr);
+    double best_time = std::numeric_limits<double>::max();
+    for (MarchParameter const & param : MarchParameter::candidates())
+    {
+        // March a clone so that the solution of the solver is not touched.
+        std::shared_ptr<ST> trial = svr.clone();
+        param.apply(*trial);
+        march(*trial, 1); // warm up
+        double elapsed = std::numeric_limits<double>::max();
+        for (size_t it=0; it<repeat; ++it)
+        {
+            const clock_type::time_point start = clock_type::now();
+            march(*trial, steps);
+            elapsed = std::min(elapsed, std::chrono::duration<double>(clock_type::now() - start).count());
+        }
+        if (elapsed < best_time)
+        {
+            best_time = elapsed;
+            best = param;
+        }
+    }
+    best.apply(svr);
+    store(key(ST::name(), svr.grid().ncelm()), best, save);
+    return best;
+}
+
+inline
+void MarchTuner::load()
+{
+    // A missing or unreadable cache file simply means nothing is tuned yet.
+    m_loaded = true;
+    if (m_path.empty()) { return; }
+    std::ifstream ifs(m_path);
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        const size_t ptab = line.rfind('\t');
+        if (ptab == std::string::npos) { continue; }
+        try { m_entry[line.substr(0, ptab)] = MarchParameter::from_string(line.substr(ptab+1)); }
+        catch (std::invalid_argument const &) { continue; }
+    }
+}
+
+inline
+void MarchTuner::save() const
+{
+    if (m_path.empty()) { return; }
+    // Create the parent directories.
+    for (size_t pos = m_path.find('/', 1); pos != std::string::npos; pos = m_path.find('/', pos+1))
+    {
+        mkdir(m_path.substr(0, pos).c_str(), 0755); // NOLINT(hicpp-signed-bitwise)
+    }
+    // Write a temporary file next to the cache file and rename it over, so
+    // that a concurrent load() or a crash never sees a partial file.
+    const std::string tmp_path = Formatter() << m_path << ".tmp." << getpid();
+    std::ofstream ofs(tmp_path);
+    for (auto const & entry : m_entry)
+    {
+        ofs << entry.first << "\t" << entry.second.to_string() << "\n";
+    }
+    ofs.close();
+    if (!ofs || 0 != std::rename(tmp_path.c_str(), m_path.c_str()))
+    {
+        std::remove(tmp_path.c_str());
+        throw std::runtime_error(Formatter()
+            << "MarchTuner::save(): cannot write " << m_path
+        );
+    }
+}
+
+} /* end namespace spacetime */
+
+/* vim: set et ts=4 sw=4: */
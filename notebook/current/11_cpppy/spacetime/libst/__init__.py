@@ -15,6 +15,9 @@ from ._core import (
     Solver,
     InviscidBurgersSolver,
     LinearScalarSolver,
+    MarchScheduler,
+    get_tuning_file,
+    set_tuning_file,
 )
 
 from ._pstcanvas import (
@@ -30,6 +33,9 @@ __all__ = [
     'Solver',
     'InviscidBurgersSolver',
     'LinearScalarSolver',
+    'MarchScheduler',
+    'get_tuning_file',
+    'set_tuning_file',
     # _pstcanvas
     'PstCanvas',
 ]
@@ -14,6 +14,9 @@ from ._libst import (
     Solver,
     InviscidBurgersSolver,
     LinearScalarSolver,
+    MarchScheduler,
+    get_tuning_file,
+    set_tuning_file,
 )
 
 
@@ -24,6 +27,9 @@ __all__ = [
     'Solution',
     'InviscidBurgersSolver',
     'LinearScalarSolver',
+    'MarchScheduler',
+    'get_tuning_file',
+    'set_tuning_file',
 ]
 
 # vim: set et sw=4 ts=4:
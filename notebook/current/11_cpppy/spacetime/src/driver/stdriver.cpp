@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD 3-Clause License, see COPYING
+ */
+
+/*
+ * Standalone driver of the space-time CESE solvers.  Usage:
+ *
+ *   stdriver CONFIG [key=value ...]
+ *
+ * The key=value pairs on the command line override those in CONFIG.  An
+ * example CONFIG:
+ *
+ *   equation = linear_scalar
+ *   ncelm = 200
+ *   cfl = 0.8
+ *   alpha = 2
+ *   steps = 250
+ *   init = gaussian
+ *   output = result.txt
+ *   output_interval = 50
+ *
+ * See spacetime::RunConfig for all the keys.
+ */
+
+#include "spacetime.hpp"
+#include "spacetime/driver.hpp"
+
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char ** argv)
+{
+    namespace st = spacetime;
+
+    if (argc < 2 || 0 == std::strcmp(argv[1], "-h") || 0 == std::strcmp(argv[1], "--help"))
+    {
+        std::cerr << "usage: " << argv[0] << " CONFIG [key=value ...]" << std::endl;
+        return argc < 2 ? 1 : 0;
+    }
+
+    try
+    {
+        st::RunConfig config = st::RunConfig::from_file(argv[1]);
+        for (int it=2; it<argc; ++it)
+        {
+            std::string const arg(argv[it]); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            const size_t peq = arg.find('=');
+            if (peq == std::string::npos)
+            {
+                throw std::invalid_argument(st::Formatter() << "argument \"" << arg << "\" is not key=value");
+            }
+            config.set(arg.substr(0, peq), arg.substr(peq+1));
+        }
+        st::Driver(config).run();
+    }
+    catch (std::exception const & e)
+    {
+        std::cerr << argv[0] << ": " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+// vim: set et sw=4 ts=4:
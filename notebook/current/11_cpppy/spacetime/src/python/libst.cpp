@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <cstring>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -23,6 +24,15 @@ PyObject * initialize_spacetime(pybind11::module * mod)
     mod->doc() = "_libst: One-dimensional space-time CESE method code";
     spy::WrapGrid::commit(mod, "Grid", "Spatial grid data");
     spy::WrapField::commit(mod, "Field", "Solution data");
+    spy::WrapMarchScheduler::commit(mod, "MarchScheduler", "Work-stealing thread pool marching many solvers");
+    mod->def(
+        "get_tuning_file", [](){ return spacetime::MarchTuner::me().path(); }
+      , "Path of the file caching the tuned marching parameters"
+    );
+    mod->def(
+        "set_tuning_file", [](std::string const & path){ spacetime::MarchTuner::me().set_path(path); }
+      , pybind11::arg("path"), "Switch the file caching the tuned marching parameters"
+    );
     return mod->ptr();
 }
 
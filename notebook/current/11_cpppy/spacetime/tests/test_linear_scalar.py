@@ -1,6 +1,8 @@
 # Copyright (c) 2018, Yung-Yu Chen <yyc@solvcon.net>
 # BSD 3-Clause License, see COPYING
 
+import os
+import tempfile
 import unittest
 
 import numpy as np
@@ -94,6 +96,46 @@ class LinearScalarSolverTC(unittest.TestCase):
         self.assertEqual(self.svr.grid.ncelm, len(v2))
         self.assertEqual(v1, v2)
 
+    def test_bulk_query(self):
+
+        self.svr.march_alpha2(steps=1)
+
+        for odd_plane in (False, True):
+            celms = list(self.svr.celms(odd_plane=odd_plane))
+            selms = list(self.svr.selms(odd_plane=odd_plane))
+            self.assertEqual([e.dx for e in celms],
+                             self.svr.get_celm_dx(odd_plane=odd_plane)
+                             .tolist())
+            self.assertEqual([e.calc_so0(0) for e in celms],
+                             self.svr.get_celm_calc_so0(
+                                 0, odd_plane=odd_plane).tolist())
+            self.assertEqual([e.calc_so1_alpha2(0) for e in celms],
+                             self.svr.get_celm_calc_so1_alpha2(
+                                 0, odd_plane=odd_plane).tolist())
+            self.assertEqual([e.xctr for e in selms],
+                             self.svr.get_selm_xctr(odd_plane=odd_plane)
+                             .tolist())
+            self.assertEqual(self.svr.get_so0p(0, odd_plane=odd_plane)
+                             .tolist(),
+                             self.svr.get_selm_so0p(0, odd_plane=odd_plane)
+                             .tolist())
+
+        # Query by indices.
+        indices = np.array([4, 0, 2, 2])
+        self.assertEqual([self.svr.selm(i).x for i in indices.tolist()],
+                         self.svr.get_selm_x(indices).tolist())
+        self.assertEqual([self.svr.celm(i, odd_plane=True).calc_so0(0)
+                          for i in indices.tolist()],
+                         self.svr.get_celm_calc_so0(
+                             0, indices, odd_plane=True).tolist())
+
+        with self.assertRaisesRegex(IndexError, "out of nvar range"):
+            self.svr.get_selm_so0p(1)
+        with self.assertRaisesRegex(IndexError, "outside the interval"):
+            self.svr.get_celm_x(np.array([self.svr.grid.ncelm]))
+        with self.assertRaisesRegex(IndexError, "indices not 1D"):
+            self.svr.get_selm_x(np.zeros((2, 2), dtype='int32'))
+
     def test_initialized(self):
 
         self.assertEqual(self.svr.get_so0(0).tolist(),
@@ -110,6 +152,59 @@ class LinearScalarSolverTC(unittest.TestCase):
         np.testing.assert_allclose(self.svr.get_cfl(), ones,
                                    rtol=0, atol=1.e-14)
 
+    def test_derived_cache(self):
+
+        svr2 = self._build_solver(self.resolution)[-1]
+        self.assertFalse(svr2.use_derived_cache)
+        self.svr.use_derived_cache = True
+        self.svr.march_alpha2(self.nstep)
+        svr2.march_alpha2(self.nstep)
+        self.assertEqual(self.svr.get_so0(0).tolist(),
+                         svr2.get_so0(0).tolist())
+        self.assertEqual(self.svr.get_so0p(0).tolist(),
+                         svr2.get_so0p(0).tolist())
+
+        # The next cached march sees writes through the element and through
+        # a held view.
+        self.svr.selm(2).set_so0(0, 10.0)
+        svr2.selm(2).set_so0(0, 10.0)
+        so0 = self.svr.so0
+        so0[3:5] = 2.0
+        svr2.so0[3:5] = 2.0
+        self.svr.march_alpha2(1)
+        svr2.march_alpha2(1)
+        self.assertEqual(self.svr.get_so0(0).tolist(),
+                         svr2.get_so0(0).tolist())
+
+    def test_autotune(self):
+
+        old_path = libst.get_tuning_file()
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, 'libst', 'tuning.txt')
+            libst.set_tuning_file(path)
+            try:
+                so0 = self.svr.get_so0(0).tolist()
+                with self.assertRaises(ValueError):
+                    self.svr.autotune(steps=4, alpha=3)
+                param = self.svr.autotune(steps=4, alpha=1)
+                self.assertEqual(so0, self.svr.get_so0(0).tolist())
+                self.assertEqual('use_derived_cache=%d'
+                                 % self.svr.use_derived_cache, param)
+                with open(path) as fobj:
+                    self.assertTrue(fobj.read().endswith(param + '\n'))
+                self.assertEqual([], [name for name in os.listdir(
+                    os.path.dirname(path)) if '.tmp.' in name])
+                # Reload the file for a new solver of the same size, which
+                # takes the tuned parameters only on request.
+                libst.set_tuning_file(path)
+                svr2 = self._build_solver(self.resolution)[-1]
+                svr2.use_derived_cache = not self.svr.use_derived_cache
+                self.assertTrue(svr2.apply_tuning())
+                self.assertEqual(self.svr.use_derived_cache,
+                                 svr2.use_derived_cache)
+            finally:
+                libst.set_tuning_file(old_path)
+
     def test_march_fine_interface(self):
 
         def _march():
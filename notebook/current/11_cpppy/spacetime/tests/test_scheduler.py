@@ -0,0 +1,55 @@
+# Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+# BSD 3-Clause License, see COPYING
+
+import unittest
+
+import numpy as np
+
+import libst
+
+
+class MarchSchedulerTC(unittest.TestCase):
+
+    @staticmethod
+    def _build_solver(cls, resolution):
+
+        grid = libst.Grid(0, 2*np.pi, resolution)
+        svr = cls(grid=grid, time_increment=np.pi/resolution)
+        svr.set_so0(0, np.sin(svr.xctr()))
+        svr.setup_march()
+        return svr
+
+    def test_march(self):
+
+        scheduler = libst.MarchScheduler(nthread=2)
+        self.assertEqual(2, scheduler.nthread)
+        scheduler.grain = 100
+
+        svrs = []
+        refs = []
+        for resolution in (8, 50, 300):
+            for cls in (libst.LinearScalarSolver,
+                        libst.InviscidBurgersSolver):
+                svr = self._build_solver(cls, resolution)
+                svrs.append(svr)
+                refs.append(svr.clone())
+                scheduler.add(svr, steps=10)
+        self.assertEqual(len(svrs), scheduler.njob)
+        with self.assertRaises(ValueError):
+            scheduler.add(svrs[0], steps=1)
+
+        scheduler.run()
+        self.assertEqual(0, scheduler.njob)
+        for svr, ref in zip(svrs, refs):
+            ref.march_alpha2(10)
+            self.assertEqual(ref.get_so0(0).tolist(), svr.get_so0(0).tolist())
+            self.assertEqual(ref.get_so1(0).tolist(), svr.get_so1(0).tolist())
+
+    def test_bad_alpha(self):
+
+        scheduler = libst.MarchScheduler()
+        svr = self._build_solver(libst.LinearScalarSolver, 8)
+        with self.assertRaises(ValueError):
+            scheduler.add(svr, steps=1, alpha=3)
+
+# vim: set et sw=4 ts=4:
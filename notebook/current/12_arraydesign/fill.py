@@ -5,6 +5,8 @@ sys.path.insert(0, 'modmesh')
 
 import modmesh as mm
 
+mm.time_registry.enable()
+
 gd = mm.StaticGrid1d(1000000)
 for it in range(100):
     gd.fill(0)
@@ -0,0 +1,637 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD-style license; see COPYING
+ */
+
+/**
+ * Memory buffer and multi-dimensional array.
+ */
+
+#include "modmesh/base.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define MODMESH_HAS_MMAN 1
+#else
+#define MODMESH_HAS_MMAN 0
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * Source of the memory of ConcreteBuffer.  The memory is aligned to
+ * ALIGNMENT bytes, i.e., a cache line and the widest SIMD register, and its
+ * size rounded up to a multiple of ALIGNMENT.
+ */
+class BufferAllocator
+{
+
+public:
+
+    static constexpr size_t ALIGNMENT = 64;
+
+    static size_t round(size_t nbytes, size_t unit) { return (nbytes + unit - 1) / unit * unit; }
+
+    /// Get the allocator of the name: "aligned", "pool", "mmap", or "hugepage".
+    static BufferAllocator & from_name(std::string const & name);
+
+    BufferAllocator() = default;
+    BufferAllocator(BufferAllocator const & ) = delete;
+    BufferAllocator(BufferAllocator       &&) = delete;
+    BufferAllocator & operator=(BufferAllocator const & ) = delete;
+    BufferAllocator & operator=(BufferAllocator       &&) = delete;
+    virtual ~BufferAllocator() = default;
+
+    virtual char const * name() const = 0;
+    /// Throw std::bad_alloc when out of memory.
+    virtual void * allocate(size_t nbytes) = 0;
+    /// The size must be the same as passed to allocate().
+    virtual void deallocate(void * ptr, size_t nbytes) noexcept = 0;
+
+}; /* end class BufferAllocator */
+
+/**
+ * Allocate from the heap by std::aligned_alloc.
+ */
+class AlignedAllocator
+  : public BufferAllocator
+{
+
+public:
+
+    static AlignedAllocator & me()
+    {
+        static AlignedAllocator inst;
+        return inst;
+    }
+
+    char const * name() const override { return "aligned"; }
+
+    void * allocate(size_t nbytes) override
+    {
+        void * ptr = std::aligned_alloc(ALIGNMENT, round(nbytes, ALIGNMENT));
+        if (!ptr) { throw std::bad_alloc(); }
+        return ptr;
+    }
+
+    void deallocate(void * ptr, size_t) noexcept override { std::free(ptr); }
+
+}; /* end class AlignedAllocator */
+
+/**
+ * Keep the freed memory for the next allocation of the same rounded size,
+ * so that the temporaries allocated over and over in a time loop do not go
+ * back to the system.  At most capacity() bytes are kept.
+ */
+class PoolAllocator
+  : public BufferAllocator
+{
+
+public:
+
+    static PoolAllocator & me()
+    {
+        // Never destroyed, for the buffers freed during exit.
+        static PoolAllocator * inst = new PoolAllocator;
+        return *inst;
+    }
+
+    char const * name() const override { return "pool"; }
+
+    void * allocate(size_t nbytes) override
+    {
+        nbytes = round(nbytes, ALIGNMENT);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_free.find(nbytes);
+            if (it != m_free.end() && !it->second.empty())
+            {
+                void * ptr = it->second.back();
+                it->second.pop_back();
+                m_cached -= nbytes;
+                return ptr;
+            }
+        }
+        return AlignedAllocator::me().allocate(nbytes);
+    }
+
+    void deallocate(void * ptr, size_t nbytes) noexcept override
+    {
+        nbytes = round(nbytes, ALIGNMENT);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_cached + nbytes <= m_capacity)
+            {
+                try
+                {
+                    m_free[nbytes].push_back(ptr);
+                    m_cached += nbytes;
+                    return;
+                }
+                catch (std::bad_alloc const &) {}
+            }
+        }
+        AlignedAllocator::me().deallocate(ptr, nbytes);
+    }
+
+    /// Return the kept memory to the system.
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto & item : m_free)
+        {
+            for (void * ptr : item.second) { AlignedAllocator::me().deallocate(ptr, item.first); }
+        }
+        m_free.clear();
+        m_cached = 0;
+    }
+
+    size_t cached() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_cached;
+    }
+
+    size_t capacity() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_capacity;
+    }
+
+    void set_capacity(size_t value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_capacity = value;
+    }
+
+private:
+
+    PoolAllocator() = default;
+
+    mutable std::mutex m_mutex;
+    std::map<size_t, std::vector<void *>> m_free;
+    size_t m_cached = 0;
+    size_t m_capacity = size_t(1) << 30;
+
+}; /* end class PoolAllocator */
+
+/**
+ * Map anonymous pages from the system.  The pages are committed on first
+ * touch, so that they are placed on the NUMA node of the thread touching
+ * them, and a large buffer is given back to the system as soon as freed.
+ * Without mmap the heap is used.
+ */
+class MmapAllocator
+  : public BufferAllocator
+{
+
+public:
+
+    static MmapAllocator & me()
+    {
+        static MmapAllocator inst;
+        return inst;
+    }
+
+    char const * name() const override { return "mmap"; }
+
+    void * allocate(size_t nbytes) override
+    {
+#if MODMESH_HAS_MMAN
+        void * ptr = mmap(nullptr, round(nbytes, page_size()), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == ptr) { throw std::bad_alloc(); }
+        return ptr;
+#else
+        return AlignedAllocator::me().allocate(nbytes);
+#endif
+    }
+
+    void deallocate(void * ptr, size_t nbytes) noexcept override
+    {
+#if MODMESH_HAS_MMAN
+        munmap(ptr, round(nbytes, page_size()));
+#else
+        AlignedAllocator::me().deallocate(ptr, nbytes);
+#endif
+    }
+
+    static size_t page_size()
+    {
+#if MODMESH_HAS_MMAN
+        static const size_t value = size_t(sysconf(_SC_PAGESIZE));
+        return value;
+#else
+        return 4096;
+#endif
+    }
+
+}; /* end class MmapAllocator */
+
+/**
+ * Map huge pages to cut the TLB misses of sweeping a large array.  The
+ * reserved huge pages (MAP_HUGETLB) are tried first.  Otherwise the mapping
+ * is aligned to HUGE_PAGE and advised for transparent huge pages, which the
+ * kernel may or may not honor.  Without mmap the heap is used.
+ */
+class HugePageAllocator
+  : public BufferAllocator
+{
+
+public:
+
+    static constexpr size_t HUGE_PAGE = size_t(2) << 20;
+
+    static HugePageAllocator & me()
+    {
+        static HugePageAllocator inst;
+        return inst;
+    }
+
+    char const * name() const override { return "hugepage"; }
+
+    void * allocate(size_t nbytes) override
+    {
+#if MODMESH_HAS_MMAN
+        const size_t length = round(nbytes, HUGE_PAGE);
+        constexpr int prot = PROT_READ | PROT_WRITE;
+        constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_HUGETLB
+        void * ptr = mmap(nullptr, length, prot, flags | MAP_HUGETLB, -1, 0);
+        if (MAP_FAILED != ptr) { return ptr; }
+#endif
+        // Over-map by a huge page and trim both ends to align.
+        char * raw = static_cast<char *>(mmap(nullptr, length + HUGE_PAGE, prot, flags, -1, 0));
+        if (MAP_FAILED == static_cast<void *>(raw)) { throw std::bad_alloc(); }
+        char * ret = reinterpret_cast<char *>(round(reinterpret_cast<uintptr_t>(raw), HUGE_PAGE));
+        if (ret != raw) { munmap(raw, ret - raw); }
+        munmap(ret + length, raw + HUGE_PAGE - ret);
+#ifdef MADV_HUGEPAGE
+        madvise(ret, length, MADV_HUGEPAGE);
+#endif
+        return ret;
+#else
+        return AlignedAllocator::me().allocate(nbytes);
+#endif
+    }
+
+    void deallocate(void * ptr, size_t nbytes) noexcept override
+    {
+#if MODMESH_HAS_MMAN
+        munmap(ptr, round(nbytes, HUGE_PAGE));
+#else
+        AlignedAllocator::me().deallocate(ptr, nbytes);
+#endif
+    }
+
+}; /* end class HugePageAllocator */
+
+inline BufferAllocator & BufferAllocator::from_name(std::string const & name)
+{
+    if ("aligned" == name) { return AlignedAllocator::me(); }
+    else if ("pool" == name) { return PoolAllocator::me(); }
+    else if ("mmap" == name) { return MmapAllocator::me(); }
+    else if ("hugepage" == name) { return HugePageAllocator::me(); }
+    MODMESH_EXCEPT(BufferAllocator, std::invalid_argument, "unknown allocator");
+}
+
+/**
+ * Untyped and unresizeable memory buffer.  It is always held by a shared
+ * pointer, so that the arrays viewing it share the ownership.
+ */
+class ConcreteBuffer
+  : public std::enable_shared_from_this<ConcreteBuffer>
+{
+
+private:
+
+    struct ctor_passkey {};
+
+public:
+
+    static std::shared_ptr<ConcreteBuffer> construct(size_t nbytes, BufferAllocator & allocator)
+    {
+        return std::make_shared<ConcreteBuffer>(nbytes, allocator, ctor_passkey());
+    }
+
+    static std::shared_ptr<ConcreteBuffer> construct(size_t nbytes)
+    {
+        return construct(nbytes, AlignedAllocator::me());
+    }
+
+    static std::shared_ptr<ConcreteBuffer> construct() { return construct(0); }
+
+    /// Deep copy from the same allocator.
+    std::shared_ptr<ConcreteBuffer> clone() const
+    {
+        std::shared_ptr<ConcreteBuffer> ret = construct(m_nbytes, *m_allocator);
+        if (m_nbytes) { std::memcpy(ret->data(), data(), m_nbytes); }
+        return ret;
+    }
+
+    ConcreteBuffer(size_t nbytes, BufferAllocator & allocator, ctor_passkey const &)
+      : m_nbytes(nbytes)
+      , m_allocator(&allocator)
+      , m_data(nbytes ? static_cast<char *>(allocator.allocate(nbytes)) : nullptr)
+    {}
+
+    ConcreteBuffer() = delete;
+    ConcreteBuffer(ConcreteBuffer const & ) = delete;
+    ConcreteBuffer(ConcreteBuffer       &&) = delete;
+    ConcreteBuffer & operator=(ConcreteBuffer const & ) = delete;
+    ConcreteBuffer & operator=(ConcreteBuffer       &&) = delete;
+
+    ~ConcreteBuffer()
+    {
+        if (m_data) { m_allocator->deallocate(m_data, m_nbytes); }
+    }
+
+    size_t nbytes() const noexcept { return m_nbytes; }
+    size_t size() const noexcept { return m_nbytes; }
+    BufferAllocator & allocator() const noexcept { return *m_allocator; }
+
+    char const * data() const noexcept { return m_data; }
+    char       * data()       noexcept { return m_data; }
+
+    char   operator[](size_t it) const noexcept { return m_data[it]; }
+    char & operator[](size_t it)       noexcept { return m_data[it]; }
+    char   at(size_t it) const { ensure_range(it); return (*this)[it]; }
+    char & at(size_t it)       { ensure_range(it); return (*this)[it]; }
+
+private:
+
+    void ensure_range(size_t it) const
+    {
+        if (it >= m_nbytes)
+        {
+            MODMESH_EXCEPT(ConcreteBuffer, std::out_of_range, "index out of range");
+        }
+    }
+
+    size_t m_nbytes;
+    BufferAllocator * m_allocator;
+    char * m_data;
+
+}; /* end class ConcreteBuffer */
+
+/**
+ * Multi-dimensional array of a trivially copyable type on a ConcreteBuffer.
+ * The strides count elements.  A newly allocated array is in C order and
+ * starts at the beginning of the buffer, so that it is aligned.  A view
+ * shares the buffer with the array it views.
+ *
+ * Copying makes a contiguous array in new memory from the same allocator.
+ */
+template <typename T>
+class SimpleArray
+{
+
+public:
+
+    using value_type = T;
+    using shape_type = std::vector<size_t>;
+
+    static constexpr size_t ITEMSIZE = sizeof(T);
+
+    static_assert(std::is_trivially_copyable<T>::value, "SimpleArray needs a trivially copyable type");
+
+    static shape_type contiguous_stride(shape_type const & shape)
+    {
+        shape_type ret(shape.size());
+        size_t step = 1;
+        for (size_t it=shape.size(); it>0; --it)
+        {
+            ret[it-1] = step;
+            step *= shape[it-1];
+        }
+        return ret;
+    }
+
+    SimpleArray() : SimpleArray(shape_type{0}) {}
+
+    explicit SimpleArray(size_t length, BufferAllocator & allocator = AlignedAllocator::me())
+      : SimpleArray(shape_type{length}, allocator)
+    {}
+
+    explicit SimpleArray(shape_type const & shape, BufferAllocator & allocator = AlignedAllocator::me())
+      : m_shape(shape)
+      , m_stride(contiguous_stride(shape))
+    {
+        m_buffer = ConcreteBuffer::construct(count(shape) * ITEMSIZE, allocator);
+        m_begin = reinterpret_cast<T *>(m_buffer->data());
+    }
+
+    /// View the buffer from the offset in elements.
+    SimpleArray
+    (
+        shape_type const & shape
+      , shape_type const & stride
+      , std::shared_ptr<ConcreteBuffer> const & buffer
+      , size_t offset = 0
+    )
+      : m_shape(shape)
+      , m_stride(stride)
+      , m_buffer(buffer)
+    {
+        if (!buffer)
+        {
+            MODMESH_EXCEPT(SimpleArray, std::invalid_argument, "null buffer");
+        }
+        if (shape.size() != stride.size())
+        {
+            MODMESH_EXCEPT(SimpleArray, std::invalid_argument, "shape and stride mismatch");
+        }
+        size_t last = offset;
+        for (size_t it=0; it<shape.size(); ++it)
+        {
+            if (0 == shape[it]) { last = offset; break; }
+            last += (shape[it] - 1) * stride[it];
+        }
+        if (count(shape) && (last + 1) * ITEMSIZE > buffer->nbytes())
+        {
+            MODMESH_EXCEPT(SimpleArray, std::out_of_range, "view exceeds buffer");
+        }
+        m_begin = reinterpret_cast<T *>(buffer->data()) + offset;
+    }
+
+    SimpleArray(SimpleArray const & other)
+      : SimpleArray(other.m_shape, other.m_buffer->allocator())
+    {
+        copy_from(other);
+    }
+
+    SimpleArray & operator=(SimpleArray const & other)
+    {
+        if (this != &other)
+        {
+            SimpleArray tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    SimpleArray(SimpleArray &&) noexcept = default;
+    SimpleArray & operator=(SimpleArray &&) noexcept = default;
+    ~SimpleArray() = default;
+
+    size_t ndim() const noexcept { return m_shape.size(); }
+    shape_type const & shape() const noexcept { return m_shape; }
+    size_t shape(size_t axis) const { return m_shape.at(axis); }
+    shape_type const & stride() const noexcept { return m_stride; }
+    size_t stride(size_t axis) const { return m_stride.at(axis); }
+    size_t size() const noexcept { return count(m_shape); }
+    size_t nbytes() const noexcept { return size() * ITEMSIZE; }
+
+    bool is_contiguous() const noexcept
+    {
+        size_t step = 1;
+        for (size_t it=m_shape.size(); it>0; --it)
+        {
+            if (m_shape[it-1] > 1 && m_stride[it-1] != step) { return false; }
+            step *= m_shape[it-1];
+        }
+        return true;
+    }
+
+    std::shared_ptr<ConcreteBuffer> const & buffer() const noexcept { return m_buffer; }
+    /// Offset of the first element from the beginning of the buffer.
+    size_t offset() const noexcept { return m_begin - reinterpret_cast<T const *>(m_buffer->data()); }
+
+    T const * data() const noexcept { return m_begin; }
+    T       * data()       noexcept { return m_begin; }
+
+    /// Element in the memory order; only meaningful when contiguous.
+    T const & operator[](size_t it) const noexcept { return m_begin[it]; }
+    T       & operator[](size_t it)       noexcept { return m_begin[it]; }
+
+    template <typename ... Args>
+    T const & operator()(Args ... args) const noexcept { return m_begin[index({size_t(args)...})]; }
+    template <typename ... Args>
+    T       & operator()(Args ... args)       noexcept { return m_begin[index({size_t(args)...})]; }
+
+    template <typename ... Args>
+    T const & at(Args ... args) const { return m_begin[checked_index({size_t(args)...})]; }
+    template <typename ... Args>
+    T       & at(Args ... args)       { return m_begin[checked_index({size_t(args)...})]; }
+
+    /// Memory offset in elements of the multi-dimensional index.
+    size_t index(std::initializer_list<size_t> idx) const noexcept
+    {
+        size_t ret = 0;
+        size_t axis = 0;
+        for (size_t val : idx) { ret += val * m_stride[axis++]; }
+        return ret;
+    }
+
+    size_t checked_index(std::initializer_list<size_t> idx) const
+    {
+        if (idx.size() != m_shape.size())
+        {
+            MODMESH_EXCEPT(SimpleArray, std::out_of_range, "wrong number of indices");
+        }
+        size_t axis = 0;
+        for (size_t val : idx)
+        {
+            if (val >= m_shape[axis++])
+            {
+                MODMESH_EXCEPT(SimpleArray, std::out_of_range, "index out of range");
+            }
+        }
+        return index(idx);
+    }
+
+    void fill(T const & value)
+    {
+        if (is_contiguous()) { std::fill(m_begin, m_begin + size(), value); }
+        else { for_each_offset([&](size_t src) { m_begin[src] = value; }); }
+    }
+
+    /// Copy the elements of an array of the same shape.
+    void copy_from(SimpleArray const & other)
+    {
+        if (other.m_shape != m_shape)
+        {
+            MODMESH_EXCEPT(SimpleArray, std::invalid_argument, "shape mismatch");
+        }
+        if (is_contiguous() && other.is_contiguous())
+        {
+            if (size()) { std::memcpy(m_begin, other.m_begin, nbytes()); }
+        }
+        else
+        {
+            // Walk the source in C order and the destination along with it.
+            std::vector<size_t> dst;
+            dst.reserve(size());
+            for_each_offset([&](size_t off) { dst.push_back(off); });
+            size_t it = 0;
+            other.for_each_offset([&](size_t src) { m_begin[dst[it++]] = other.m_begin[src]; });
+        }
+    }
+
+    /// View the same memory in another shape; the array must be contiguous.
+    SimpleArray reshape(shape_type const & shape) const
+    {
+        if (!is_contiguous())
+        {
+            MODMESH_EXCEPT(SimpleArray, std::invalid_argument, "reshape needs a contiguous array");
+        }
+        if (count(shape) != size())
+        {
+            MODMESH_EXCEPT(SimpleArray, std::invalid_argument, "reshape cannot change size");
+        }
+        return SimpleArray(shape, contiguous_stride(shape), m_buffer, offset());
+    }
+
+    /// Call func(offset) for every element in C order.
+    template <typename F>
+    void for_each_offset(F && func) const
+    {
+        const size_t nelem = size();
+        if (0 == nelem) { return; }
+        std::vector<size_t> idx(m_shape.size(), 0);
+        size_t off = 0;
+        for (size_t ielem=0; ielem<nelem; ++ielem)
+        {
+            func(off);
+            for (size_t axis=m_shape.size(); axis>0; --axis)
+            {
+                off += m_stride[axis-1];
+                if (++idx[axis-1] < m_shape[axis-1]) { break; }
+                off -= m_stride[axis-1] * m_shape[axis-1];
+                idx[axis-1] = 0;
+            }
+        }
+    }
+
+private:
+
+    static size_t count(shape_type const & shape)
+    {
+        size_t ret = 1;
+        for (size_t val : shape) { ret *= val; }
+        return ret;
+    }
+
+    shape_type m_shape;
+    shape_type m_stride;
+    std::shared_ptr<ConcreteBuffer> m_buffer;
+    T * m_begin = nullptr;
+
+}; /* end class SimpleArray */
+
+} /* end namespace modmesh */
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
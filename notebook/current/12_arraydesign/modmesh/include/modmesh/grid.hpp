@@ -10,7 +10,11 @@
  */
 
 #include "modmesh/base.hpp"
-#include "modmesh/profile.hpp"
+#include "modmesh/buffer.hpp"
+#include "modmesh/kernel.hpp"
+
+#include <array>
+#include <stdexcept>
 
 namespace modmesh
 {
@@ -33,102 +37,302 @@ class StaticGrid1d
 
 public:
 
-    StaticGrid1d() : m_nx(0), m_coord(nullptr) {}
+    StaticGrid1d() : m_nx(0), m_coord(0) {}
 
     StaticGrid1d(serial_type nx)
       : m_nx(nx)
-      , m_coord(allocate(nx))
+      , m_coord(nx)
     {}
 
-    StaticGrid1d(StaticGrid1d const & other)
-      : m_nx(other.m_nx)
-      , m_coord(allocate(other.m_nx))
+    StaticGrid1d(StaticGrid1d const & ) = default;
+    StaticGrid1d(StaticGrid1d       &&) = default;
+    StaticGrid1d & operator=(StaticGrid1d const & ) = default;
+    StaticGrid1d & operator=(StaticGrid1d       &&) = default;
+    ~StaticGrid1d() = default;
+
+    size_t nx() const { return m_nx; }
+    real_type const * coord() const { return m_coord.data(); }
+    real_type       * coord()       { return m_coord.data(); }
+
+    size_t size() const { return m_nx; }
+    real_type   operator[] (size_t it) const noexcept { return m_coord[it]; }
+    real_type & operator[] (size_t it)       noexcept { return m_coord[it]; }
+    real_type   at (size_t it) const { ensure_range(it); return (*this)[it]; }
+    real_type & at (size_t it)       { ensure_range(it); return (*this)[it]; }
+
+    // The kernel times itself.
+    void fill(real_type val) { kernel::fill(m_coord, val); }
+
+    /// Multiply by a.
+    void scale(real_type a) { kernel::scale(m_coord, a); }
+    /// Add a times the other grid.
+    void axpy(real_type a, StaticGrid1d const & x) { kernel::axpy(m_coord, x.m_coord, a); }
+
+    real_type sum() const { return kernel::sum(m_coord); }
+    real_type dot(StaticGrid1d const & other) const { return kernel::dot(m_coord, other.m_coord); }
+    real_type min() const { return kernel::min(m_coord); }
+    real_type max() const { return kernel::max(m_coord); }
+
+private:
+
+    void ensure_range(size_t it) const
     {
-        if (m_coord)
+        if (it >= m_nx)
         {
-            std::copy(other.m_coord.get(), m_coord.get(), m_coord.get()+m_nx);
+            MODMESH_EXCEPT(StaticGrid1d, std::out_of_range, "index out of range");
         }
     }
 
-    StaticGrid1d & operator=(StaticGrid1d const & other)
+    serial_type m_nx;
+    SimpleArray<real_type> m_coord;
+
+}; /* end class StaticGrid1d */
+
+/**
+ * Memory layout of the points of a multi-dimensional grid.
+ */
+enum class GridLayout
+{
+    /// C order; the last axis is contiguous and every row starts aligned.
+    ROW_MAJOR,
+    /// The points are grouped in cubic tiles stored one after another.
+    TILED,
+}; /* end enum class GridLayout */
+
+/**
+ * Point array of a multi-dimensional structured grid, with ghost layers and
+ * aligned storage.  The index of a point along an axis runs from -nghost to
+ * n+nghost-1, where n is the number of interior points on the axis.
+ *
+ * In GridLayout::TILED, the index space including the ghost layers is padded
+ * to multiples of the tile edge and cut into tiles.  The tiles and the points
+ * in a tile are both in C order.  A stencil then touches a few tiles at a
+ * time instead of a few rows spanning the whole grid.
+ *
+ * Like numpy.empty(), a newly constructed array leaves the point values and
+ * the coordinates uninitialized.  Call fill() before reading them.
+ */
+template <size_t ND>
+class StaticGridArray
+  : public StaticGridBase<ND>
+{
+
+public:
+
+    using serial_type = typename StaticGridBase<ND>::serial_type;
+    using real_type = typename StaticGridBase<ND>::real_type;
+    // Signed to address ghost points.
+    using index_type = int32_t;
+    using shape_type = std::array<serial_type, ND>;
+    using index_array = std::array<index_type, ND>;
+
+    static constexpr size_t ALIGNMENT = BufferAllocator::ALIGNMENT;
+    static constexpr serial_type DEFAULT_TILE = ND < 3 ? 16 : 8;
+
+    StaticGridArray() : m_shape{}, m_nghost(0), m_layout(GridLayout::ROW_MAJOR), m_tile(0), m_extent{}, m_stride{}, m_size(0) {}
+
+    StaticGridArray(shape_type const & shape, serial_type nghost, GridLayout layout, serial_type tile)
+      : m_shape(shape)
+      , m_nghost(nghost)
+      , m_layout(layout)
+      , m_tile(tile)
     {
-        if (this != &other)
+        if (GridLayout::TILED == layout && (0 == tile || 0 != (tile & (tile-1))))
         {
-            m_nx = other.m_nx;
-            m_coord = allocate(m_nx);
-            std::copy(other.m_coord.get(), m_coord.get(), m_coord.get()+m_nx);
+            MODMESH_EXCEPT(StaticGridArray, std::invalid_argument, "tile edge must be a power of 2");
         }
-        return *this;
+        initialize();
     }
 
-    StaticGrid1d(StaticGrid1d && other) noexcept
-      : m_nx(other.m_nx)
-      , m_coord(std::move(other.m_coord))
-    {}
+    StaticGridArray(StaticGridArray const & ) = default;
+    StaticGridArray & operator=(StaticGridArray const & ) = default;
+    StaticGridArray(StaticGridArray &&) noexcept = default;
+    StaticGridArray & operator=(StaticGridArray &&) noexcept = default;
+    ~StaticGridArray() = default;
+
+    shape_type const & shape() const { return m_shape; }
+    serial_type nghost() const { return m_nghost; }
+    GridLayout layout() const { return m_layout; }
+    serial_type tile() const { return m_tile; }
+
+    /// Number of allocated points along each axis, including ghost and padding.
+    shape_type const & extent() const { return m_extent; }
+    /// Distance in points between neighbors along each axis in ROW_MAJOR.
+    std::array<size_t, ND> const & stride() const { return m_stride; }
+    /// Number of allocated points.
+    size_t size() const { return m_size; }
+
+    real_type const * data() const { return m_data.data(); }
+    real_type       * data()       { return m_data.data(); }
+
+    real_type const * coord(size_t axis) const { return m_coord[axis].data(); }
+    real_type       * coord(size_t axis)       { return m_coord[axis].data(); }
 
-    StaticGrid1d & operator=(StaticGrid1d && other) noexcept
+    size_t offset(index_array const & idx) const noexcept
     {
-        if (this != &other)
+        size_t ret = 0;
+        if (GridLayout::ROW_MAJOR == m_layout)
         {
-            m_nx = other.m_nx;
-            m_coord = std::move(other.m_coord);
+            for (size_t it=0; it<ND; ++it)
+            {
+                ret += (idx[it] + m_nghost) * m_stride[it];
+            }
         }
-        return *this;
+        else
+        {
+            size_t inner = 0;
+            for (size_t it=0; it<ND; ++it)
+            {
+                const size_t pos = idx[it] + m_nghost;
+                ret = ret * (m_extent[it] >> m_shift) + (pos >> m_shift);
+                inner = (inner << m_shift) + (pos & (m_tile-1));
+            }
+            ret = (ret << (m_shift*ND)) + inner;
+        }
+        return ret;
     }
 
-    ~StaticGrid1d() = default;
+    bool in_range(index_array const & idx) const noexcept
+    {
+        for (size_t it=0; it<ND; ++it)
+        {
+            if (idx[it] < -index_type(m_nghost) || idx[it] >= index_type(m_shape[it] + m_nghost))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
 
-    size_t nx() const { return m_nx; }
-    real_type * const coord() const { return m_coord.get(); }
-    real_type *       coord()       { return m_coord.get(); }
+    // The kernel times itself.
+    void fill(real_type val) { kernel::fill(m_data, val); }
 
-    size_t size() const { return m_nx; }
-    real_type   operator[] (size_t it) const noexcept { return m_coord[it]; }
-    real_type & operator[] (size_t it)       noexcept { return m_coord[it]; }
-    real_type   at (size_t it) const { ensure_range(it); return (*this)[it]; }
-    real_type & at (size_t it)       { ensure_range(it); return (*this)[it]; }
+protected:
 
-    void fill(real_type val)
+    void ensure_range(index_array const & idx) const
     {
-        MODMESH_TIME("StaticGrid1d::fill");
-        std::fill(m_coord.get(), m_coord.get()+m_nx, val);
+        if (!in_range(idx))
+        {
+            MODMESH_EXCEPT(StaticGridArray, std::out_of_range, "index out of range");
+        }
     }
 
 private:
 
-    std::unique_ptr<real_type[]> allocate(serial_type nx)
+    void initialize()
     {
-        if (nx)
+        constexpr size_t nalign = ALIGNMENT / sizeof(real_type);
+        m_shift = 0;
+        for (size_t it=0; it<ND; ++it)
+        {
+            m_extent[it] = m_shape[it] + 2*m_nghost;
+        }
+        if (GridLayout::TILED == m_layout)
         {
-            return std::unique_ptr<real_type[]>(new real_type[nx]);
+            while ((serial_type(1) << m_shift) < m_tile) { ++m_shift; }
+            for (size_t it=0; it<ND; ++it)
+            {
+                m_extent[it] = (m_extent[it] + m_tile - 1) / m_tile * m_tile;
+            }
         }
         else
         {
-            return std::unique_ptr<real_type[]>();
+            m_extent[ND-1] = (m_extent[ND-1] + nalign - 1) / nalign * nalign;
         }
-    }
-
-    void ensure_range(size_t it) const
-    {
-        if (it >= m_nx)
+        m_size = 1;
+        for (size_t it=ND; it>0; --it)
         {
-            MODMESH_EXCEPT(StaticGrid1d, std::out_of_range, "index out of range");
+            m_stride[it-1] = m_size;
+            m_size *= m_extent[it-1];
+        }
+        m_data = SimpleArray<real_type>(m_size);
+        for (size_t it=0; it<ND; ++it)
+        {
+            m_coord[it] = SimpleArray<real_type>(m_shape[it]);
         }
     }
 
-    serial_type m_nx;
-    std::unique_ptr<real_type[]> m_coord;
+    shape_type m_shape;
+    serial_type m_nghost;
+    GridLayout m_layout;
+    serial_type m_tile;
+    serial_type m_shift = 0;
+    shape_type m_extent;
+    std::array<size_t, ND> m_stride;
+    size_t m_size;
+    SimpleArray<real_type> m_data;
+    std::array<SimpleArray<real_type>, ND> m_coord;
 
-}; /* end class StaticGrid1d */
+}; /* end class StaticGridArray */
 
+/**
+ * 2D grid.
+ */
 class StaticGrid2d
-  : public StaticGridBase<2>
+  : public StaticGridArray<2>
 {
+
+public:
+
+    using base_type = StaticGridArray<2>;
+
+    StaticGrid2d() = default;
+
+    StaticGrid2d
+    (
+        serial_type nx, serial_type ny, serial_type nghost=0
+      , GridLayout layout=GridLayout::ROW_MAJOR, serial_type tile=DEFAULT_TILE
+    )
+      : base_type({nx, ny}, nghost, layout, tile)
+    {}
+
+    size_t nx() const { return shape()[0]; }
+    size_t ny() const { return shape()[1]; }
+
+    real_type * xcoord() { return coord(0); }
+    real_type * ycoord() { return coord(1); }
+
+    real_type   operator() (index_type i, index_type j) const noexcept { return data()[offset({i, j})]; }
+    real_type & operator() (index_type i, index_type j)       noexcept { return data()[offset({i, j})]; }
+    real_type   at (index_type i, index_type j) const { ensure_range({i, j}); return (*this)(i, j); }
+    real_type & at (index_type i, index_type j)       { ensure_range({i, j}); return (*this)(i, j); }
+
 }; /* end class StaticGrid2d */
 
+/**
+ * 3D grid.
+ */
 class StaticGrid3d
-  : public StaticGridBase<3>
+  : public StaticGridArray<3>
 {
+
+public:
+
+    using base_type = StaticGridArray<3>;
+
+    StaticGrid3d() = default;
+
+    StaticGrid3d
+    (
+        serial_type nx, serial_type ny, serial_type nz, serial_type nghost=0
+      , GridLayout layout=GridLayout::ROW_MAJOR, serial_type tile=DEFAULT_TILE
+    )
+      : base_type({nx, ny, nz}, nghost, layout, tile)
+    {}
+
+    size_t nx() const { return shape()[0]; }
+    size_t ny() const { return shape()[1]; }
+    size_t nz() const { return shape()[2]; }
+
+    real_type * xcoord() { return coord(0); }
+    real_type * ycoord() { return coord(1); }
+    real_type * zcoord() { return coord(2); }
+
+    real_type   operator() (index_type i, index_type j, index_type k) const noexcept { return data()[offset({i, j, k})]; }
+    real_type & operator() (index_type i, index_type j, index_type k)       noexcept { return data()[offset({i, j, k})]; }
+    real_type   at (index_type i, index_type j, index_type k) const { ensure_range({i, j, k}); return (*this)(i, j, k); }
+    real_type & at (index_type i, index_type j, index_type k)       { ensure_range({i, j, k}); return (*this)(i, j, k); }
+
 }; /* end class StaticGrid3d */
 
 } /* end namespace modmesh */
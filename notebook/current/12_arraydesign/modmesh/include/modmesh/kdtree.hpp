@@ -0,0 +1,472 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD-style license; see COPYING
+ */
+
+/**
+ * k-d tree over points with SIMD leaf buckets.
+ */
+
+#include "modmesh/base.hpp"
+#include "modmesh/buffer.hpp"
+#include "modmesh/kernel.hpp"
+#include "modmesh/profile.hpp"
+#include "modmesh/spatial.hpp"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * k-d tree over points, split at the median along the widest axis until at
+ * most BUCKET points remain.  Every split puts a whole number of buckets on
+ * the left, so that all leaves but the last of a subtree are full, and the
+ * nodes of a subtree of n points take 2*ceil(n/BUCKET)-1 consecutive slots
+ * in pre-order.  The subtrees are therefore built as independent tasks into
+ * their own slots.
+ *
+ * The points of a leaf are stored by axis in an aligned bucket, so that the
+ * distances to or the containment of BUCKET points are computed by a few
+ * SIMD instructions.  Unused lanes hold infinity.
+ */
+template <size_t ND>
+class KdTree
+  : public SpaceBase<ND>
+{
+
+public:
+
+    using serial_type = typename SpaceBase<ND>::serial_type;
+    using real_type = typename SpaceBase<ND>::real_type;
+    using box_type = BoundBox<ND>;
+    using serial_array = SimpleArray<serial_type>;
+    using real_array = SimpleArray<real_type>;
+
+    static constexpr serial_type INVALID = std::numeric_limits<serial_type>::max();
+    /// Points in a leaf.
+    static constexpr size_t BUCKET = 8;
+    static constexpr size_t STACK_SIZE = 64;
+
+    struct Node
+    {
+        /// Split coordinate of an inner node.
+        real_type split;
+        /// Split axis of an inner node, or ND for a leaf.
+        serial_type axis;
+        /// Right child of an inner node (the left is the next node), or the
+        /// bucket of a leaf.
+        serial_type child;
+
+        bool is_leaf() const { return ND == axis; }
+    };
+
+    KdTree() = default;
+
+    /// Index over the (n, ND) points.
+    explicit KdTree(real_array const & crd)
+      : m_crd(crd)
+    {
+        if (2 != m_crd.ndim() || ND != m_crd.shape(1) || !m_crd.is_contiguous())
+        {
+            MODMESH_EXCEPT(KdTree, std::invalid_argument, "coordinates must be contiguous (n, ND)");
+        }
+        if (m_crd.shape(0) >= INVALID)
+        {
+            MODMESH_EXCEPT(KdTree, std::invalid_argument, "too many points");
+        }
+        build();
+    }
+
+    KdTree(KdTree const & ) = default;
+    KdTree(KdTree       &&) = default;
+    KdTree & operator=(KdTree const & ) = default;
+    KdTree & operator=(KdTree       &&) = default;
+    ~KdTree() = default;
+
+    size_t size() const { return m_crd.shape(0); }
+    size_t nnode() const { return m_node.size(); }
+    size_t nbucket() const { return m_id.size() / BUCKET; }
+    std::vector<Node> const & nodes() const { return m_node; }
+    real_array const & coord() const { return m_crd; }
+
+    /// Number of levels of the tree.
+    size_t depth() const
+    {
+        size_t ret = 0;
+        for (size_t nb=nbucket(); nb; nb=(nb+1)/2)
+        {
+            ++ret;
+            if (1 == nb) { break; }
+        }
+        return ret;
+    }
+
+    /// Call func(point) for every point in the box.
+    template <typename F>
+    void range(box_type const & query, F && func) const
+    {
+        if (m_node.empty()) { return; }
+        serial_type stack[STACK_SIZE];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top)
+        {
+            const serial_type inode = stack[--top];
+            Node const & node = m_node[inode];
+            if (node.is_leaf())
+            {
+                unsigned mask = bucket_contains(node.child, query);
+                serial_type const * id = m_id.data() + node.child * BUCKET;
+                for (; mask; mask &= mask - 1) { func(id[count_trailing_zeros(mask)]); }
+            }
+            else
+            {
+                if (query.hi[node.axis] >= node.split) { stack[top++] = node.child; }
+                if (query.lo[node.axis] <= node.split) { stack[top++] = inode + 1; }
+            }
+        }
+    }
+
+    /**
+     * The k nearest points of the point by increasing distance.  The slots
+     * beyond the number of points get INVALID and infinity.
+     */
+    void nearest(real_type const * pt, size_t k, serial_type * ids, real_type * dist) const
+    {
+        using entry_type = std::pair<real_type, serial_type>;
+        // Max-heap of the best candidates by squared distance, on the stack
+        // for small k.
+        constexpr size_t nsmall = 16;
+        entry_type small[nsmall];
+        std::vector<entry_type> large;
+        entry_type * heap = small;
+        if (k > nsmall)
+        {
+            large.resize(k);
+            heap = large.data();
+        }
+        std::fill(heap, heap+k, entry_type(std::numeric_limits<real_type>::infinity(), INVALID));
+        if (k && !m_node.empty())
+        {
+            // Nodes with the lower bound of their squared distances.
+            std::pair<serial_type, real_type> stack[STACK_SIZE];
+            size_t top = 0;
+            stack[top++] = {0, 0};
+            alignas(BufferAllocator::ALIGNMENT) real_type d2[BUCKET];
+            while (top)
+            {
+                const auto entry = stack[--top];
+                if (entry.second >= heap[0].first) { continue; }
+                Node const & node = m_node[entry.first];
+                if (node.is_leaf())
+                {
+                    bucket_distance2(node.child, pt, d2);
+                    serial_type const * id = m_id.data() + node.child * BUCKET;
+                    for (size_t it=0; it<BUCKET; ++it)
+                    {
+                        if (d2[it] < heap[0].first)
+                        {
+                            std::pop_heap(heap, heap+k);
+                            heap[k-1] = {d2[it], id[it]};
+                            std::push_heap(heap, heap+k);
+                        }
+                    }
+                }
+                else
+                {
+                    const real_type diff = pt[node.axis] - node.split;
+                    const serial_type near = diff <= 0 ? entry.first + 1 : node.child;
+                    const serial_type far = diff <= 0 ? node.child : entry.first + 1;
+                    stack[top++] = {far, std::max(entry.second, diff * diff)};
+                    stack[top++] = {near, entry.second};
+                }
+            }
+        }
+        std::sort_heap(heap, heap+k);
+        for (size_t it=0; it<k; ++it)
+        {
+            ids[it] = heap[it].second;
+            dist[it] = std::sqrt(heap[it].first);
+        }
+    }
+
+    /**
+     * Points in every one of the (nquery, 2, ND) boxes, in the CSR format:
+     * the points of query i are ids[offset[i]:offset[i+1]].
+     */
+    std::pair<serial_array, serial_array> range(real_array const & query) const
+    {
+        MODMESH_TIME("KdTree::range");
+        if (3 != query.ndim() || 2 != query.shape(1) || ND != query.shape(2) || !query.is_contiguous())
+        {
+            MODMESH_EXCEPT(KdTree, std::invalid_argument, "query boxes must be contiguous (nquery, 2, ND)");
+        }
+        return spatial::range<ND>(query, [this](box_type const & box, auto && emit) { range(box, emit); });
+    }
+
+    /// The k nearest points of every one of the (nquery, ND) points, as
+    /// (nquery, k) arrays of the points and the distances.
+    std::pair<serial_array, real_array> nearest(real_array const & query, size_t k) const
+    {
+        MODMESH_TIME("KdTree::nearest");
+        if (2 != query.ndim() || ND != query.shape(1) || !query.is_contiguous())
+        {
+            MODMESH_EXCEPT(KdTree, std::invalid_argument, "query points must be contiguous (nquery, ND)");
+        }
+        return spatial::nearest<ND>
+        (
+            query, k
+          , [this](real_type const * pt, size_t kk, serial_type * ids, real_type * dist) { nearest(pt, kk, ids, dist); }
+        );
+    }
+
+private:
+
+    static unsigned count_trailing_zeros(unsigned value)
+    {
+        unsigned ret = 0;
+        for (; !(value & 1); value >>= 1) { ++ret; }
+        return ret;
+    }
+
+    /// Number of nodes of a subtree over the points.
+    static size_t subtree_nnode(size_t count) { return 2 * ((count + BUCKET - 1) / BUCKET) - 1; }
+
+    /// Squared distances from the point to the points of the bucket.
+    void bucket_distance2(size_t ibucket, real_type const * pt, real_type * d2) const
+    {
+        real_type const * lane = m_lane.data() + ibucket * ND * BUCKET;
+#if defined(__AVX__)
+        for (size_t it=0; it<BUCKET; it+=4)
+        {
+            __m256d acc = _mm256_setzero_pd();
+            for (size_t idm=0; idm<ND; ++idm)
+            {
+                const __m256d diff = _mm256_sub_pd(_mm256_load_pd(lane + idm*BUCKET + it), _mm256_set1_pd(pt[idm]));
+                acc = _mm256_add_pd(acc, _mm256_mul_pd(diff, diff));
+            }
+            _mm256_store_pd(d2 + it, acc);
+        }
+#elif defined(__SSE2__)
+        for (size_t it=0; it<BUCKET; it+=2)
+        {
+            __m128d acc = _mm_setzero_pd();
+            for (size_t idm=0; idm<ND; ++idm)
+            {
+                const __m128d diff = _mm_sub_pd(_mm_load_pd(lane + idm*BUCKET + it), _mm_set1_pd(pt[idm]));
+                acc = _mm_add_pd(acc, _mm_mul_pd(diff, diff));
+            }
+            _mm_store_pd(d2 + it, acc);
+        }
+#else
+        std::fill(d2, d2+BUCKET, real_type(0));
+        for (size_t idm=0; idm<ND; ++idm)
+        {
+            for (size_t it=0; it<BUCKET; ++it)
+            {
+                const real_type diff = lane[idm*BUCKET + it] - pt[idm];
+                d2[it] += diff * diff;
+            }
+        }
+#endif
+    }
+
+    /// Bit mask of the points of the bucket in the box.
+    unsigned bucket_contains(size_t ibucket, box_type const & box) const
+    {
+        real_type const * lane = m_lane.data() + ibucket * ND * BUCKET;
+        unsigned ret = 0;
+#if defined(__AVX__)
+        for (size_t it=0; it<BUCKET; it+=4)
+        {
+            __m256d in = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+            for (size_t idm=0; idm<ND; ++idm)
+            {
+                const __m256d val = _mm256_load_pd(lane + idm*BUCKET + it);
+                in = _mm256_and_pd(in, _mm256_cmp_pd(val, _mm256_set1_pd(box.lo[idm]), _CMP_GE_OQ));
+                in = _mm256_and_pd(in, _mm256_cmp_pd(val, _mm256_set1_pd(box.hi[idm]), _CMP_LE_OQ));
+            }
+            ret |= unsigned(_mm256_movemask_pd(in)) << it;
+        }
+#elif defined(__SSE2__)
+        for (size_t it=0; it<BUCKET; it+=2)
+        {
+            __m128d in = _mm_castsi128_pd(_mm_set1_epi64x(-1));
+            for (size_t idm=0; idm<ND; ++idm)
+            {
+                const __m128d val = _mm_load_pd(lane + idm*BUCKET + it);
+                in = _mm_and_pd(in, _mm_cmpge_pd(val, _mm_set1_pd(box.lo[idm])));
+                in = _mm_and_pd(in, _mm_cmple_pd(val, _mm_set1_pd(box.hi[idm])));
+            }
+            ret |= unsigned(_mm_movemask_pd(in)) << it;
+        }
+#else
+        for (size_t it=0; it<BUCKET; ++it)
+        {
+            bool in = true;
+            for (size_t idm=0; idm<ND; ++idm)
+            {
+                const real_type val = lane[idm*BUCKET + it];
+                in = in && val >= box.lo[idm] && val <= box.hi[idm];
+            }
+            ret |= unsigned(in) << it;
+        }
+#endif
+        // Padding lanes are at infinity and only pass an unbounded box.
+        return ret & m_mask[ibucket];
+    }
+
+    struct Entry
+    {
+        std::array<real_type, ND> crd;
+        serial_type id;
+    };
+
+    /// Range of points waiting to be split under a node.
+    struct Pending
+    {
+        serial_type node;
+        serial_type begin;
+        serial_type end;
+    };
+
+    void build()
+    {
+        MODMESH_TIME("KdTree::build");
+        const size_t npoint = size();
+        const size_t nbucket = (npoint + BUCKET - 1) / BUCKET;
+        // Points are moved by value while splitting, to keep the selection
+        // in contiguous memory.
+        std::vector<Entry> entry(npoint);
+        for (size_t it=0; it<npoint; ++it)
+        {
+            std::copy_n(m_crd.data() + it*ND, ND, entry[it].crd.data());
+            entry[it].id = serial_type(it);
+        }
+        m_node.assign(npoint ? subtree_nnode(npoint) : 0, Node{});
+        m_lane = real_array(nbucket * ND * BUCKET);
+        m_id.assign(nbucket * BUCKET, INVALID);
+        m_mask.assign(nbucket, 0);
+        if (0 == npoint) { return; }
+
+        // Split the upper levels on the calling thread until there are
+        // enough subtrees to go around the threads.
+        KernelPool & pool = KernelPool::me();
+        std::vector<Pending> pending{{0, 0, serial_type(npoint)}};
+        const size_t ntask = 4 * pool.nthread();
+        const size_t min_task = 4096;
+        while (pending.size() < ntask)
+        {
+            auto largest = std::max_element
+            (
+                pending.begin(), pending.end()
+              , [](Pending const & a, Pending const & b) { return a.end - a.begin < b.end - b.begin; }
+            );
+            if (largest->end - largest->begin < min_task) { break; }
+            const Pending job = *largest;
+            pending.erase(largest);
+            const serial_type mid = split(entry, job.node, job.begin, job.end);
+            pending.push_back({job.node + 1, job.begin, mid});
+            pending.push_back({m_node[job.node].child, mid, job.end});
+        }
+
+        pool.run_tasks
+        (
+            pending.size()
+          , [&](size_t itask)
+            {
+                std::vector<Pending> stack{pending[itask]};
+                while (!stack.empty())
+                {
+                    const Pending top = stack.back();
+                    stack.pop_back();
+                    if (top.end - top.begin <= BUCKET)
+                    {
+                        make_leaf(entry, top.node, top.begin, top.end);
+                        continue;
+                    }
+                    const serial_type mid = split(entry, top.node, top.begin, top.end);
+                    stack.push_back({m_node[top.node].child, mid, top.end});
+                    stack.push_back({top.node + 1, top.begin, mid});
+                }
+            }
+        );
+    }
+
+    /**
+     * Split the points [begin, end) under the node at the median along the
+     * widest axis, keeping a whole number of buckets on the left.  Return
+     * the first point of the right child.
+     */
+    serial_type split(std::vector<Entry> & entry, serial_type inode, serial_type begin, serial_type end)
+    {
+        box_type box = box_type::empty();
+        for (size_t it=begin; it<end; ++it) { box.expand(entry[it].crd.data()); }
+        serial_type axis = 0;
+        for (serial_type it=1; it<ND; ++it)
+        {
+            if (box.hi[it] - box.lo[it] > box.hi[axis] - box.lo[axis]) { axis = it; }
+        }
+        const size_t nleft = ((end - begin) / BUCKET + 1) / 2 * BUCKET;
+        const serial_type mid = serial_type(begin + nleft);
+        std::nth_element
+        (
+            entry.begin() + begin, entry.begin() + mid, entry.begin() + end
+          , [axis](Entry const & a, Entry const & b) { return a.crd[axis] < b.crd[axis]; }
+        );
+        Node & node = m_node[inode];
+        node.split = entry[mid].crd[axis];
+        node.axis = axis;
+        node.child = serial_type(inode + 1 + subtree_nnode(nleft));
+        return mid;
+    }
+
+    void make_leaf(std::vector<Entry> const & entry, serial_type inode, serial_type begin, serial_type end)
+    {
+        const size_t ibucket = begin / BUCKET;
+        Node & node = m_node[inode];
+        node.split = 0;
+        node.axis = ND;
+        node.child = serial_type(ibucket);
+        real_type * lane = m_lane.data() + ibucket * ND * BUCKET;
+        for (size_t it=0; it<BUCKET; ++it)
+        {
+            const bool used = begin + it < end;
+            for (size_t idm=0; idm<ND; ++idm)
+            {
+                lane[idm*BUCKET + it] = used ? entry[begin + it].crd[idm] : std::numeric_limits<real_type>::infinity();
+            }
+            m_id[ibucket*BUCKET + it] = used ? entry[begin + it].id : INVALID;
+        }
+        m_mask[ibucket] = uint8_t((1u << (end - begin)) - 1);
+    }
+
+    real_array m_crd = real_array(std::vector<size_t>{0, ND});
+    std::vector<Node> m_node;
+    /// Coordinates of the buckets, (nbucket, ND, BUCKET).
+    real_array m_lane;
+    std::vector<serial_type> m_id;
+    /// Lanes in use by every bucket.
+    std::vector<uint8_t> m_mask;
+
+}; /* end class KdTree */
+
+using KdTree2d = KdTree<2>;
+using KdTree3d = KdTree<3>;
+
+} /* end namespace modmesh */
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
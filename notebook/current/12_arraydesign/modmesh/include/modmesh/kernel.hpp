@@ -0,0 +1,446 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD-style license; see COPYING
+ */
+
+/**
+ * Parallel elementwise kernels on contiguous arrays of real numbers.
+ */
+
+#include "modmesh/base.hpp"
+#include "modmesh/buffer.hpp"
+#include "modmesh/profile.hpp"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * Worker threads splitting an index range into one contiguous chunk per
+ * thread.  The calling thread takes the first chunk.  Ranges shorter than
+ * threshold() run serially on the calling thread, and so does a range
+ * started from a worker.  Calls from several threads take turns.
+ */
+class KernelPool
+{
+
+public:
+
+    /// Chunks start at multiples of this, i.e., on cache lines of doubles.
+    static constexpr size_t GRAIN = 8;
+
+    static KernelPool & me()
+    {
+        // Never destroyed, so that exit does not wait for the workers.
+        static KernelPool * inst = new KernelPool;
+        return *inst;
+    }
+
+    size_t nthread() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_worker.size() + 1;
+    }
+
+    void set_nthread(size_t value)
+    {
+        std::lock_guard<std::mutex> run_lock(m_run_mutex);
+        stop();
+        start(value ? value : std::max(std::thread::hardware_concurrency(), 1u));
+    }
+
+    /// Number of elements below which a kernel stays serial.
+    size_t threshold() const { return m_threshold.load(std::memory_order_relaxed); }
+    void set_threshold(size_t value) { m_threshold.store(value, std::memory_order_relaxed); }
+
+    /// Number of bytes above which fill and copy bypass the cache with
+    /// non-temporal stores, i.e., the destination is too large to stay in
+    /// the cache for the next use.
+    size_t stream_threshold() const { return m_stream_threshold.load(std::memory_order_relaxed); }
+    void set_stream_threshold(size_t value) { m_stream_threshold.store(value, std::memory_order_relaxed); }
+
+    /// Number of chunks run() splits a range of the size into.
+    size_t nchunk(size_t size) const
+    {
+        if (size < threshold() || t_in_worker) { return 1; }
+        return std::max(std::min(nthread(), size / GRAIN), size_t(1));
+    }
+
+    /// Call func(begin, end, ichunk) for the chunks of [0, size).
+    template <typename F>
+    void run(size_t size, F && func) { run(size, nchunk(size), std::forward<F>(func)); }
+
+    /// Same as above but with at most nck chunks.
+    template <typename F>
+    void run(size_t size, size_t nck, F && func)
+    {
+        if (nck <= 1 || t_in_worker)
+        {
+            func(size_t(0), size, size_t(0));
+            return;
+        }
+        std::lock_guard<std::mutex> run_lock(m_run_mutex);
+        const size_t nck_run = std::min(nck, m_worker.size() + 1);
+        auto chunk = [&func, size, nck_run](size_t ick)
+        {
+            const size_t begin = bound(size, nck_run, ick);
+            const size_t end = bound(size, nck_run, ick+1);
+            if (begin < end) { func(begin, end, ick); }
+        };
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = chunk;
+            m_nchunk = nck_run;
+            m_pending = nck_run - 1;
+            m_error = nullptr;
+            ++m_generation;
+        }
+        m_work_cv.notify_all();
+        std::exception_ptr error;
+        // The calling thread works like a worker for its chunk.
+        t_in_worker = true;
+        try { chunk(0); }
+        catch (...) { error = std::current_exception(); }
+        t_in_worker = false;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done_cv.wait(lock, [this] { return 0 == m_pending; });
+        m_job = nullptr;
+        if (!error) { error = m_error; }
+        if (error) { std::rethrow_exception(error); }
+    }
+
+    /// Call func(itask) for every task in [0, ntask).  The threads take the
+    /// tasks one at a time, which balances tasks of uneven cost.
+    template <typename F>
+    void run_tasks(size_t ntask, F && func)
+    {
+        const size_t nck = t_in_worker ? 1 : std::min(nthread(), ntask);
+        std::atomic<size_t> next{0};
+        // One GRAIN per chunk so that no chunk is empty.
+        run
+        (
+            nck * GRAIN, nck
+          , [&](size_t, size_t, size_t)
+            {
+                for (size_t it=next++; it<ntask; it=next++) { func(it); }
+            }
+        );
+    }
+
+private:
+
+    /// Start of the chunk, rounded to GRAIN.
+    static size_t bound(size_t size, size_t nchunk, size_t ichunk)
+    {
+        if (ichunk >= nchunk) { return size; }
+        return std::min(size * ichunk / nchunk / GRAIN * GRAIN, size);
+    }
+
+    KernelPool()
+    {
+        start(std::max(std::thread::hardware_concurrency(), 1u));
+    }
+
+    void start(size_t nthread)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = false;
+        for (size_t it=1; it<nthread; ++it)
+        {
+            m_worker.emplace_back([this, it, generation=m_generation] { work(it, generation); });
+        }
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_work_cv.notify_all();
+        for (std::thread & worker : m_worker) { worker.join(); }
+        m_worker.clear();
+    }
+
+    /// Run the chunk of every job posted after the generation.
+    void work(size_t ichunk, size_t generation)
+    {
+        t_in_worker = true;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_work_cv.wait(lock, [&] { return m_stop || m_generation != generation; });
+            if (m_stop) { return; }
+            generation = m_generation;
+            if (ichunk >= m_nchunk) { continue; }
+            // The job stays until every chunk is done.
+            std::function<void(size_t)> const & job = m_job;
+            lock.unlock();
+            std::exception_ptr error;
+            try { job(ichunk); }
+            catch (...) { error = std::current_exception(); }
+            lock.lock();
+            if (error && !m_error) { m_error = error; }
+            if (0 == --m_pending) { m_done_cv.notify_one(); }
+        }
+    }
+
+    static thread_local bool t_in_worker;
+
+    mutable std::mutex m_mutex;
+    // Serialize run() and set_nthread().
+    std::mutex m_run_mutex;
+    std::condition_variable m_work_cv;
+    std::condition_variable m_done_cv;
+    std::vector<std::thread> m_worker;
+    std::function<void(size_t)> m_job;
+    size_t m_nchunk = 0;
+    size_t m_pending = 0;
+    size_t m_generation = 0;
+    std::exception_ptr m_error;
+    bool m_stop = false;
+    std::atomic<size_t> m_threshold{size_t(1) << 16};
+    std::atomic<size_t> m_stream_threshold{size_t(32) << 20};
+
+}; /* end class KernelPool */
+
+inline thread_local bool KernelPool::t_in_worker = false;
+
+namespace kernel
+{
+
+namespace detail
+{
+
+/// Fill with non-temporal stores, which skip reading the lines into cache.
+inline void stream_fill(double * dst, size_t size, double value)
+{
+#if defined(__SSE2__)
+    size_t it = 0;
+    for (; it<size && reinterpret_cast<uintptr_t>(dst+it) % 16; ++it) { dst[it] = value; }
+    const __m128d vec = _mm_set1_pd(value);
+    for (; it+2<=size; it+=2) { _mm_stream_pd(dst+it, vec); }
+    for (; it<size; ++it) { dst[it] = value; }
+    _mm_sfence();
+#else
+    std::fill(dst, dst+size, value);
+#endif
+}
+
+/// Copy with non-temporal stores.
+inline void stream_copy(double * dst, double const * src, size_t size)
+{
+#if defined(__SSE2__)
+    size_t it = 0;
+    for (; it<size && reinterpret_cast<uintptr_t>(dst+it) % 16; ++it) { dst[it] = src[it]; }
+    for (; it+2<=size; it+=2) { _mm_stream_pd(dst+it, _mm_loadu_pd(src+it)); }
+    for (; it<size; ++it) { dst[it] = src[it]; }
+    _mm_sfence();
+#else
+    std::copy(src, src+size, dst);
+#endif
+}
+
+inline bool use_stream(size_t size)
+{
+    return size * sizeof(double) >= KernelPool::me().stream_threshold();
+}
+
+/// Reduce the chunks with func(begin, end) and combine the partial results
+/// in the chunk order, so that the result does not depend on the timing.
+template <typename F, typename C>
+double reduce(size_t size, double init, F && func, C && combine)
+{
+    KernelPool & pool = KernelPool::me();
+    std::vector<double> partial(pool.nchunk(size), init);
+    pool.run(size, partial.size(), [&](size_t begin, size_t end, size_t ick) { partial[ick] = func(begin, end); });
+    double ret = init;
+    for (double val : partial) { ret = combine(ret, val); }
+    return ret;
+}
+
+} /* end namespace detail */
+
+inline void fill(double * dst, size_t size, double value)
+{
+    MODMESH_TIME_BYTES("kernel::fill", size * sizeof(double));
+    const bool stream = detail::use_stream(size);
+    KernelPool::me().run
+    (
+        size
+      , [=](size_t begin, size_t end, size_t)
+        {
+            if (stream) { detail::stream_fill(dst+begin, end-begin, value); }
+            else { std::fill(dst+begin, dst+end, value); }
+        }
+    );
+}
+
+inline void copy(double * dst, double const * src, size_t size)
+{
+    MODMESH_TIME_BYTES("kernel::copy", 2 * size * sizeof(double));
+    const bool stream = detail::use_stream(size);
+    KernelPool::me().run
+    (
+        size
+      , [=](size_t begin, size_t end, size_t)
+        {
+            if (stream) { detail::stream_copy(dst+begin, src+begin, end-begin); }
+            else { std::copy(src+begin, src+end, dst+begin); }
+        }
+    );
+}
+
+/// y *= a
+inline void scale(double * y, size_t size, double a)
+{
+    MODMESH_TIME_BYTES("kernel::scale", 2 * size * sizeof(double));
+    KernelPool::me().run
+    (
+        size
+      , [=](size_t begin, size_t end, size_t)
+        {
+            for (size_t it=begin; it<end; ++it) { y[it] *= a; }
+        }
+    );
+}
+
+/// y += a * x
+inline void axpy(double * y, double const * x, size_t size, double a)
+{
+    MODMESH_TIME_BYTES("kernel::axpy", 3 * size * sizeof(double));
+    KernelPool::me().run
+    (
+        size
+      , [=](size_t begin, size_t end, size_t)
+        {
+            for (size_t it=begin; it<end; ++it) { y[it] += a * x[it]; }
+        }
+    );
+}
+
+inline double sum(double const * x, size_t size)
+{
+    MODMESH_TIME_BYTES("kernel::sum", size * sizeof(double));
+    return detail::reduce
+    (
+        size, 0.0
+      , [=](size_t begin, size_t end)
+        {
+            // Independent accumulators let the additions overlap.
+            double acc[4] = {0.0, 0.0, 0.0, 0.0};
+            size_t it = begin;
+            for (; it+4<=end; it+=4)
+            {
+                acc[0] += x[it]; acc[1] += x[it+1]; acc[2] += x[it+2]; acc[3] += x[it+3];
+            }
+            for (; it<end; ++it) { acc[0] += x[it]; }
+            return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+        }
+      , [](double a, double b) { return a + b; }
+    );
+}
+
+inline double dot(double const * x, double const * y, size_t size)
+{
+    MODMESH_TIME_BYTES("kernel::dot", 2 * size * sizeof(double));
+    return detail::reduce
+    (
+        size, 0.0
+      , [=](size_t begin, size_t end)
+        {
+            double acc[4] = {0.0, 0.0, 0.0, 0.0};
+            size_t it = begin;
+            for (; it+4<=end; it+=4)
+            {
+                acc[0] += x[it] * y[it]; acc[1] += x[it+1] * y[it+1];
+                acc[2] += x[it+2] * y[it+2]; acc[3] += x[it+3] * y[it+3];
+            }
+            for (; it<end; ++it) { acc[0] += x[it] * y[it]; }
+            return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+        }
+      , [](double a, double b) { return a + b; }
+    );
+}
+
+inline double min(double const * x, size_t size)
+{
+    MODMESH_TIME_BYTES("kernel::min", size * sizeof(double));
+    return detail::reduce
+    (
+        size, std::numeric_limits<double>::infinity()
+      , [=](size_t begin, size_t end)
+        {
+            double ret = std::numeric_limits<double>::infinity();
+            for (size_t it=begin; it<end; ++it) { ret = x[it] < ret ? x[it] : ret; }
+            return ret;
+        }
+      , [](double a, double b) { return b < a ? b : a; }
+    );
+}
+
+inline double max(double const * x, size_t size)
+{
+    MODMESH_TIME_BYTES("kernel::max", size * sizeof(double));
+    return detail::reduce
+    (
+        size, -std::numeric_limits<double>::infinity()
+      , [=](size_t begin, size_t end)
+        {
+            double ret = -std::numeric_limits<double>::infinity();
+            for (size_t it=begin; it<end; ++it) { ret = x[it] > ret ? x[it] : ret; }
+            return ret;
+        }
+      , [](double a, double b) { return b > a ? b : a; }
+    );
+}
+
+/// Kernels on contiguous arrays.
+inline void ensure_contiguous(SimpleArray<double> const & arr)
+{
+    if (!arr.is_contiguous())
+    {
+        MODMESH_EXCEPT(kernel, std::invalid_argument, "array must be contiguous");
+    }
+}
+
+inline void ensure_same_size(SimpleArray<double> const & x, SimpleArray<double> const & y)
+{
+    ensure_contiguous(x);
+    ensure_contiguous(y);
+    if (x.size() != y.size())
+    {
+        MODMESH_EXCEPT(kernel, std::invalid_argument, "array size mismatch");
+    }
+}
+
+inline void fill(SimpleArray<double> & dst, double value) { ensure_contiguous(dst); fill(dst.data(), dst.size(), value); }
+inline void copy(SimpleArray<double> & dst, SimpleArray<double> const & src) { ensure_same_size(dst, src); copy(dst.data(), src.data(), dst.size()); }
+inline void scale(SimpleArray<double> & y, double a) { ensure_contiguous(y); scale(y.data(), y.size(), a); }
+inline void axpy(SimpleArray<double> & y, SimpleArray<double> const & x, double a) { ensure_same_size(y, x); axpy(y.data(), x.data(), y.size(), a); }
+inline double sum(SimpleArray<double> const & x) { ensure_contiguous(x); return sum(x.data(), x.size()); }
+inline double dot(SimpleArray<double> const & x, SimpleArray<double> const & y) { ensure_same_size(x, y); return dot(x.data(), y.data(), x.size()); }
+inline double min(SimpleArray<double> const & x) { ensure_contiguous(x); return min(x.data(), x.size()); }
+inline double max(SimpleArray<double> const & x) { ensure_contiguous(x); return max(x.data(), x.size()); }
+
+} /* end namespace kernel */
+
+} /* end namespace modmesh */
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,561 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD-style license; see COPYING
+ */
+
+/**
+ * Location of points in the cells of an unstructured mesh.
+ */
+
+#include "modmesh/base.hpp"
+#include "modmesh/buffer.hpp"
+#include "modmesh/kernel.hpp"
+#include "modmesh/mesh.hpp"
+#include "modmesh/profile.hpp"
+#include "modmesh/spatial.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * Find the cells of a mesh containing points, with the coordinates of the
+ * points in the reference cells of VTK: a triangle or tetrahedron gets the
+ * barycentric coordinates of the nodes after the first, and a quadrilateral,
+ * pyramid, prism, or hexahedron the parameters in [0, 1] of its shape
+ * functions.  Polygons of more nodes have no reference coordinates and get
+ * NaN.
+ *
+ * A point is first searched for by walking from a hint cell to the neighbor
+ * across the face its reference coordinates are the farthest outside of,
+ * so that one solve both tests a cell and picks the next.  When there is no
+ * hint, or the walk leaves the mesh or takes more than WALK_MAX steps, the
+ * cells whose bounding boxes contain the point are tested from a
+ * SpatialIndex.
+ * A batch is located in parallel in the Morton order of the points, and the
+ * cell of the previous point is the hint.
+ *
+ * The locator shares the node coordinates and the connectivity with the
+ * mesh; moving the nodes calls for a new locator.
+ */
+template <size_t ND>
+class PointLocator
+  : public SpaceBase<ND>
+{
+
+public:
+
+    using serial_type = typename SpaceBase<ND>::serial_type;
+    using real_type = typename SpaceBase<ND>::real_type;
+    using serial_array = SimpleArray<serial_type>;
+    using real_array = SimpleArray<real_type>;
+    using mesh_type = std::conditional_t<2 == ND, StaticMesh2d, StaticMesh3d>;
+    using index_type = SpatialIndex<ND>;
+
+    static constexpr serial_type INVALID = std::numeric_limits<serial_type>::max();
+    /// Most cells a walk visits.
+    static constexpr size_t WALK_MAX = 32;
+    /// How far out of a reference cell a point is still in it.
+    static constexpr real_type TOLERANCE = 1.e-10;
+
+    PointLocator() = default;
+
+    explicit PointLocator(mesh_type const & mesh)
+      : m_ndcrd(share(mesh.ndcrd()))
+      , m_clnds_offset(share(mesh.clnds_offset()))
+      , m_clnds(share(mesh.clnds()))
+      , m_clfcs_offset(share(mesh.clfcs_offset()))
+      , m_clnbs_full(share(mesh.clnbs_full()))
+    {
+        MODMESH_TIME("PointLocator::PointLocator");
+        const size_t ncl = ncell();
+        real_array box(std::vector<size_t>{ncl, 2, ND});
+        KernelPool::me().run
+        (
+            ncl
+          , [&](size_t begin, size_t end, size_t)
+            {
+                for (size_t icl=begin; icl<end; ++icl)
+                {
+                    BoundBox<ND> cbox = BoundBox<ND>::empty();
+                    for (size_t it=m_clnds_offset[icl]; it<m_clnds_offset[icl+1]; ++it)
+                    {
+                        cbox.expand(m_ndcrd.data() + m_clnds[it]*ND);
+                    }
+                    std::copy_n(cbox.lo.data(), ND, box.data() + icl*2*ND);
+                    std::copy_n(cbox.hi.data(), ND, box.data() + icl*2*ND + ND);
+                }
+            }
+        );
+        m_index = index_type::boxes(box);
+    }
+
+    PointLocator(PointLocator const & ) = default;
+    PointLocator(PointLocator       &&) = default;
+    PointLocator & operator=(PointLocator const & ) = default;
+    PointLocator & operator=(PointLocator       &&) = default;
+    ~PointLocator() = default;
+
+    size_t ncell() const { return m_clnds_offset.size() ? m_clnds_offset.size() - 1 : 0; }
+    index_type const & index() const { return m_index; }
+
+    /**
+     * Cell containing the point, or INVALID if none, walking from the hint
+     * cell if it is valid.  The reference coordinates go to local.
+     */
+    serial_type locate(real_type const * pt, real_type * local, serial_type hint=INVALID) const
+    {
+        if (hint < ncell())
+        {
+            const serial_type icl = walk(hint, pt, local);
+            if (INVALID != icl) { return icl; }
+        }
+        BoundBox<ND> box;
+        std::copy_n(pt, ND, box.lo.data());
+        std::copy_n(pt, ND, box.hi.data());
+        serial_type ret = INVALID;
+        real_type tmp[ND];
+        m_index.range
+        (
+            box
+          , [&](serial_type icl)
+            {
+                if (INVALID == ret && contains(icl, pt, tmp))
+                {
+                    ret = icl;
+                    std::copy_n(tmp, ND, local);
+                }
+            }
+        );
+        if (INVALID == ret) { std::fill(local, local+ND, std::numeric_limits<real_type>::quiet_NaN()); }
+        return ret;
+    }
+
+    /**
+     * Cells containing the (npoint, ND) points, INVALID for those outside
+     * the mesh, and the (npoint, ND) reference coordinates.
+     */
+    std::pair<serial_array, real_array> locate(real_array const & pts) const
+    {
+        MODMESH_TIME("PointLocator::locate");
+        if (2 != pts.ndim() || ND != pts.shape(1) || !pts.is_contiguous())
+        {
+            MODMESH_EXCEPT(PointLocator, std::invalid_argument, "points must be contiguous (npoint, ND)");
+        }
+        const size_t npt = pts.shape(0);
+        const serial_array order = spatial::query_order<ND>(pts);
+        serial_array cells(npt);
+        real_array local(std::vector<size_t>{npt, ND});
+        KernelPool::me().run
+        (
+            npt
+          , [&](size_t begin, size_t end, size_t)
+            {
+                serial_type hint = INVALID;
+                for (size_t it=begin; it<end; ++it)
+                {
+                    const size_t ipt = order[it];
+                    const serial_type icl = locate(pts.data() + ipt*ND, local.data() + ipt*ND, hint);
+                    cells[ipt] = icl;
+                    if (INVALID != icl) { hint = icl; }
+                }
+            }
+        );
+        return {cells, local};
+    }
+
+    /// Whether the cell contains the point, with the reference coordinates
+    /// in local.
+    bool contains(serial_type icl, real_type const * pt, real_type * local) const
+    {
+        return mesh_type::cell_nface(m_clnds_offset[icl+1] - m_clnds_offset[icl]) == exit(icl, pt, local);
+    }
+
+private:
+
+    template <typename T>
+    static SimpleArray<T> share(SimpleArray<T> const & arr)
+    {
+        return SimpleArray<T>(arr.shape(), arr.stride(), arr.buffer(), arr.offset());
+    }
+
+    real_type const * node(serial_type ind) const { return m_ndcrd.data() + ind*ND; }
+
+    /**
+     * Walk from the cell across the faces the point is outside of and
+     * return the cell containing it, or INVALID if the walk leaves the mesh,
+     * runs too long, or gets lost.
+     */
+    serial_type walk(serial_type icl, real_type const * pt, real_type * local) const
+    {
+        for (size_t step=0; step<WALK_MAX; ++step)
+        {
+            const size_t nfc = mesh_type::cell_nface(m_clnds_offset[icl+1] - m_clnds_offset[icl]);
+            const size_t ifc = exit(icl, pt, local, true);
+            if (nfc == ifc) { return icl; }
+            if (ifc > nfc) { return INVALID; }
+            icl = m_clnbs_full[m_clfcs_offset[icl] + ifc];
+            if (INVALID == icl) { return INVALID; }
+        }
+        return INVALID;
+    }
+
+    /**
+     * Local face of the cell the point is the farthest outside of, the
+     * number of faces if the cell contains the point, or more if neither is
+     * known.  The reference coordinates go to local.  A rough guess of the
+     * face is enough to walk on.
+     */
+    size_t exit(serial_type icl, real_type const * pt, real_type * local, bool rough=false) const
+    {
+        const size_t nnd = m_clnds_offset[icl+1] - m_clnds_offset[icl];
+        serial_type const * nds = m_clnds.data() + m_clnds_offset[icl];
+        const size_t nfc = mesh_type::cell_nface(nnd);
+        if (ND < 3 && nnd > 4)
+        {
+            // Polygon as a fan of triangles.
+            std::fill(local, local+ND, std::numeric_limits<real_type>::quiet_NaN());
+            for (size_t it=1; it+1<nnd; ++it)
+            {
+                const serial_type tri[3] = {nds[0], nds[it], nds[it+1]};
+                real_type bary[ND];
+                if (simplex(tri, pt, bary) && 3 == reference_exit(3, bary)) { return nfc; }
+            }
+            return farthest(nnd, nds, pt);
+        }
+        const bool solved = nnd == ND + 1 ? simplex(nds, pt, local) : newton(nnd, nds, pt, local, rough);
+        const size_t ifc = solved ? reference_exit(nnd, local) : nfc + 1;
+        return ifc > nfc ? farthest(nnd, nds, pt) : ifc;
+    }
+
+    /**
+     * Local face the reference coordinates are the farthest outside of, the
+     * number of faces if they are in the reference cell, or more if they
+     * are outside of none of the faces.
+     */
+    static size_t reference_exit(size_t nnd, real_type const * local)
+    {
+        const real_type s = local[0];
+        const real_type t = local[1];
+        const real_type u = local[ND-1];
+        // How far out of every local face.
+        real_type out[6];
+        size_t nfc = 0;
+        bool beyond = false;
+        if (ND < 3)
+        {
+            if (3 == nnd) { out[0] = -t; out[1] = s+t-1; out[2] = -s; nfc = 3; }
+            else { out[0] = -t; out[1] = s-1; out[2] = t-1; out[3] = -s; nfc = 4; }
+        }
+        else
+        {
+            switch (nnd)
+            {
+            case 4: out[0] = -u; out[1] = -t; out[2] = s+t+u-1; out[3] = -s; nfc = 4; break;
+            // Beyond the apex is out of no face.
+            case 5: out[0] = -u; out[1] = -t; out[2] = s-1; out[3] = t-1; out[4] = -s; nfc = 5; beyond = u > 1 + TOLERANCE; break;
+            case 6: out[0] = -u; out[1] = u-1; out[2] = -t; out[3] = s+t-1; out[4] = -s; nfc = 5; break;
+            default: out[0] = -u; out[1] = u-1; out[2] = -t; out[3] = s-1; out[4] = t-1; out[5] = -s; nfc = 6; break;
+            }
+        }
+        size_t ret = nfc;
+        real_type farthest = TOLERANCE;
+        for (size_t ifc=0; ifc<nfc; ++ifc)
+        {
+            if (out[ifc] > farthest)
+            {
+                farthest = out[ifc];
+                ret = ifc;
+            }
+        }
+        return nfc == ret && beyond ? nfc + 1 : ret;
+    }
+
+    /**
+     * Local face the point is the farthest outside of by the planes of the
+     * faces, or more than the number of faces if none.
+     */
+    size_t farthest(size_t nnd, serial_type const * nds, real_type const * pt) const
+    {
+        real_type center[ND] = {};
+        for (size_t it=0; it<nnd; ++it)
+        {
+            for (size_t idm=0; idm<ND; ++idm) { center[idm] += node(nds[it])[idm]; }
+        }
+        for (size_t idm=0; idm<ND; ++idm) { center[idm] /= nnd; }
+
+        const size_t nfc = mesh_type::cell_nface(nnd);
+        real_type farthest = 0;
+        size_t ret = nfc + 1;
+        for (size_t ifc=0; ifc<nfc; ++ifc)
+        {
+            serial_type fcnds[mesh_type::FCND_MAX];
+            const size_t nfcnd = mesh_type::cell_face(nnd, nds, ifc, fcnds);
+            real_type normal[ND];
+            real_type origin[ND] = {};
+            face_normal(nfcnd, fcnds, normal);
+            for (size_t it=0; it<nfcnd; ++it)
+            {
+                for (size_t idm=0; idm<ND; ++idm) { origin[idm] += node(fcnds[it])[idm] / nfcnd; }
+            }
+            real_type out = 0;
+            real_type in = 0;
+            real_type len2 = 0;
+            for (size_t idm=0; idm<ND; ++idm)
+            {
+                out += normal[idm] * (pt[idm] - origin[idm]);
+                in += normal[idm] * (center[idm] - origin[idm]);
+                len2 += normal[idm] * normal[idm];
+            }
+            // Orient the normal away from the center.
+            const real_type dist = (in > 0 ? -out : out) / std::sqrt(len2);
+            if (dist > farthest)
+            {
+                farthest = dist;
+                ret = ifc;
+            }
+        }
+        return ret;
+    }
+
+    /// Normal of the face, not normalized; a quadrilateral takes the cross
+    /// product of the diagonals.
+    void face_normal(size_t nfcnd, serial_type const * fcnds, real_type * normal) const
+    {
+        if (ND < 3)
+        {
+            normal[0] = node(fcnds[1])[1] - node(fcnds[0])[1];
+            normal[ND-1] = node(fcnds[0])[0] - node(fcnds[1])[0];
+            return;
+        }
+        real_type a[3];
+        real_type b[3];
+        for (size_t idm=0; idm<3; ++idm)
+        {
+            if (4 == nfcnd)
+            {
+                a[idm] = node(fcnds[2])[idm] - node(fcnds[0])[idm];
+                b[idm] = node(fcnds[3])[idm] - node(fcnds[1])[idm];
+            }
+            else
+            {
+                a[idm] = node(fcnds[1])[idm] - node(fcnds[0])[idm];
+                b[idm] = node(fcnds[2])[idm] - node(fcnds[0])[idm];
+            }
+        }
+        normal[0] = a[1]*b[2] - a[2]*b[1];
+        normal[1] = a[2]*b[0] - a[0]*b[2];
+        normal[ND-1] = a[0]*b[1] - a[1]*b[0];
+    }
+
+    /// Barycentric coordinates of the point in the simplex of ND+1 nodes,
+    /// by Cramer's rule.  False if the simplex is degenerate.
+    bool simplex(serial_type const * nds, real_type const * pt, real_type * local) const
+    {
+        real_type mat[ND][ND];
+        real_type rhs[ND];
+        for (size_t idm=0; idm<ND; ++idm)
+        {
+            for (size_t jt=0; jt<ND; ++jt) { mat[idm][jt] = node(nds[jt+1])[idm] - node(nds[0])[idm]; }
+            rhs[idm] = pt[idm] - node(nds[0])[idm];
+        }
+        return solve(mat, rhs, local);
+    }
+
+    /// Solve the ND by ND system by the adjugate.
+    static bool solve(real_type const (&m)[ND][ND], real_type const * rhs, real_type * sol)
+    {
+        constexpr size_t Z = ND - 1;
+        if (ND < 3)
+        {
+            const real_type det = m[0][0]*m[Z][Z] - m[0][Z]*m[Z][0];
+            if (!(std::abs(det) > 0)) { return false; }
+            sol[0] = (m[Z][Z]*rhs[0] - m[0][Z]*rhs[Z]) / det;
+            sol[Z] = (m[0][0]*rhs[Z] - m[Z][0]*rhs[0]) / det;
+            return true;
+        }
+        const real_type c0 = m[1][1]*m[Z][Z] - m[1][Z]*m[Z][1];
+        const real_type c1 = m[1][Z]*m[Z][0] - m[1][0]*m[Z][Z];
+        const real_type c2 = m[1][0]*m[Z][1] - m[1][1]*m[Z][0];
+        const real_type det = m[0][0]*c0 + m[0][1]*c1 + m[0][Z]*c2;
+        if (!(std::abs(det) > 0)) { return false; }
+        sol[0] = (c0*rhs[0] + (m[0][Z]*m[Z][1] - m[0][1]*m[Z][Z])*rhs[1] + (m[0][1]*m[1][Z] - m[0][Z]*m[1][1])*rhs[Z]) / det;
+        sol[1] = (c1*rhs[0] + (m[0][0]*m[Z][Z] - m[0][Z]*m[Z][0])*rhs[1] + (m[0][Z]*m[1][0] - m[0][0]*m[1][Z])*rhs[Z]) / det;
+        sol[Z] = (c2*rhs[0] + (m[0][1]*m[Z][0] - m[0][0]*m[Z][1])*rhs[1] + (m[0][0]*m[1][1] - m[0][1]*m[1][0])*rhs[Z]) / det;
+        return true;
+    }
+
+    /// Shape functions of the cell of the number of nodes at the reference
+    /// coordinates, and their derivatives.
+    static void shape(size_t nnd, real_type const * r, real_type * fun, real_type (*der)[ND])
+    {
+        const real_type s = r[0];
+        const real_type t = r[1];
+        if (ND < 3)
+        {
+            // Quadrilateral.
+            const real_type fs[4] = {1-s, s, s, 1-s};
+            const real_type ft[4] = {1-t, 1-t, t, t};
+            const real_type ds[4] = {-1, 1, 1, -1};
+            const real_type dt[4] = {-1, -1, 1, 1};
+            for (size_t it=0; it<4; ++it)
+            {
+                fun[it] = fs[it] * ft[it];
+                der[it][0] = ds[it] * ft[it];
+                der[it][ND-1] = fs[it] * dt[it];
+            }
+            return;
+        }
+        const real_type u = r[ND-1];
+        switch (nnd)
+        {
+        case 5:
+        {
+            // Pyramid: a quadrilateral shrinking to the apex.
+            const real_type fs[4] = {1-s, s, s, 1-s};
+            const real_type ft[4] = {1-t, 1-t, t, t};
+            const real_type ds[4] = {-1, 1, 1, -1};
+            const real_type dt[4] = {-1, -1, 1, 1};
+            for (size_t it=0; it<4; ++it)
+            {
+                fun[it] = fs[it] * ft[it] * (1-u);
+                der[it][0] = ds[it] * ft[it] * (1-u);
+                der[it][1] = fs[it] * dt[it] * (1-u);
+                der[it][ND-1] = -fs[it] * ft[it];
+            }
+            fun[4] = u;
+            der[4][0] = 0;
+            der[4][1] = 0;
+            der[4][ND-1] = 1;
+            break;
+        }
+        case 6:
+        {
+            // Prism: a triangle extruded.
+            const real_type tri[3] = {1-s-t, s, t};
+            const real_type ds[3] = {-1, 1, 0};
+            const real_type dt[3] = {-1, 0, 1};
+            for (size_t it=0; it<3; ++it)
+            {
+                fun[it] = tri[it] * (1-u);
+                fun[it+3] = tri[it] * u;
+                der[it][0] = ds[it] * (1-u);
+                der[it][1] = dt[it] * (1-u);
+                der[it][ND-1] = -tri[it];
+                der[it+3][0] = ds[it] * u;
+                der[it+3][1] = dt[it] * u;
+                der[it+3][ND-1] = tri[it];
+            }
+            break;
+        }
+        default:
+        {
+            // Hexahedron.
+            const real_type fs[4] = {1-s, s, s, 1-s};
+            const real_type ft[4] = {1-t, 1-t, t, t};
+            const real_type ds[4] = {-1, 1, 1, -1};
+            const real_type dt[4] = {-1, -1, 1, 1};
+            for (size_t it=0; it<4; ++it)
+            {
+                fun[it] = fs[it] * ft[it] * (1-u);
+                fun[it+4] = fs[it] * ft[it] * u;
+                der[it][0] = ds[it] * ft[it] * (1-u);
+                der[it][1] = fs[it] * dt[it] * (1-u);
+                der[it][ND-1] = -fs[it] * ft[it];
+                der[it+4][0] = ds[it] * ft[it] * u;
+                der[it+4][1] = fs[it] * dt[it] * u;
+                der[it+4][ND-1] = fs[it] * ft[it];
+            }
+            break;
+        }
+        }
+    }
+
+    /// Reference coordinates of the point in the cell by Newton's method on
+    /// the shape functions.  False if it does not converge.  A rough guess
+    /// stops at the first step far out of the cell.
+    bool newton(size_t nnd, serial_type const * nds, real_type const * pt, real_type * local, bool rough) const
+    {
+        constexpr size_t niter = 20;
+        for (size_t idm=0; idm<ND; ++idm) { local[idm] = 0.5; }
+        if (3 == ND && 6 == nnd) { local[0] = local[1] = real_type(1) / 3; }
+        if (3 == ND && 5 == nnd)
+        {
+            // The Jacobian is singular at the apex.
+            real_type dist2 = 0;
+            real_type size2 = 0;
+            for (size_t idm=0; idm<ND; ++idm)
+            {
+                dist2 += (pt[idm] - node(nds[4])[idm]) * (pt[idm] - node(nds[4])[idm]);
+                size2 += (node(nds[0])[idm] - node(nds[4])[idm]) * (node(nds[0])[idm] - node(nds[4])[idm]);
+            }
+            if (dist2 <= TOLERANCE * TOLERANCE * size2)
+            {
+                local[ND-1] = 1;
+                return true;
+            }
+            local[ND-1] = 0.2;
+        }
+        real_type crd[8][ND];
+        for (size_t it=0; it<nnd; ++it) { std::copy_n(node(nds[it]), ND, crd[it]); }
+        real_type fun[8];
+        real_type der[8][ND];
+        for (size_t iter=0; iter<niter; ++iter)
+        {
+            shape(nnd, local, fun, der);
+            real_type jac[ND][ND] = {};
+            real_type res[ND];
+            for (size_t idm=0; idm<ND; ++idm) { res[idm] = -pt[idm]; }
+            for (size_t it=0; it<nnd; ++it)
+            {
+                for (size_t idm=0; idm<ND; ++idm)
+                {
+                    res[idm] += fun[it] * crd[it][idm];
+                    for (size_t jt=0; jt<ND; ++jt) { jac[idm][jt] += der[it][jt] * crd[it][idm]; }
+                }
+            }
+            real_type delta[ND];
+            if (!solve(jac, res, delta)) { return false; }
+            real_type step = 0;
+            real_type reach = 0;
+            for (size_t idm=0; idm<ND; ++idm)
+            {
+                local[idm] -= delta[idm];
+                step = std::max(step, std::abs(delta[idm]));
+                reach = std::max(reach, std::abs(local[idm] - real_type(0.5)));
+            }
+            // The error is about the square of the step.
+            if (step < 1.e-8) { return true; }
+            // Far out of the cell is not worth converging.
+            if (!(reach < 4)) { return false; }
+            // Once converging, out by more than the step is out for sure.
+            if (iter > 0 && reach - real_type(0.5) > 2 * step + TOLERANCE) { return true; }
+            if (rough && reach > 1) { return true; }
+        }
+        return false;
+    }
+
+    real_array m_ndcrd;
+    serial_array m_clnds_offset;
+    serial_array m_clnds;
+    serial_array m_clfcs_offset;
+    serial_array m_clnbs_full;
+    index_type m_index;
+
+}; /* end class PointLocator */
+
+using PointLocator2d = PointLocator<2>;
+using PointLocator3d = PointLocator<3>;
+
+} /* end namespace modmesh */
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,729 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD-style license; see COPYING
+ */
+
+/**
+ * Unstructured mesh.
+ */
+
+#include "modmesh/base.hpp"
+#include "modmesh/buffer.hpp"
+#include "modmesh/kernel.hpp"
+#include "modmesh/profile.hpp"
+#include "modmesh/reorder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * Unstructured mesh of ND-dimensional cells.  The cell type follows from the
+ * number of nodes: a polygon of 3 or more nodes in 2D, and a tetrahedron (4),
+ * pyramid (5), prism (6), or hexahedron (8) in 3D, with the VTK node order.
+ *
+ * Every connectivity is in the compressed sparse row (CSR) format: the items
+ * of entity i are items[offset[i]:offset[i+1]].  The cells and node
+ * coordinates are given, and the faces and neighbors are derived:
+ *
+ *   - clnds: nodes of every cell.
+ *   - clfcs: faces of every cell in the order of the local faces.  It shares
+ *     the offsets with clnbs_full.
+ *   - clnbs_full: cell across every local face, or INVALID on the boundary.
+ *   - clnbs: neighbor cells of every cell, without the boundary.
+ *   - fcnds: nodes of every face, ordered as in the first cell owning it.
+ *   - fccls: the (nface, 2) array of the two cells of every face.  The
+ *     second is INVALID on the boundary.
+ *
+ * The faces are numbered in the order they first appear going through the
+ * cells.
+ */
+template <size_t ND>
+class StaticMesh
+  : public SpaceBase<ND>
+{
+
+public:
+
+    using serial_type = typename SpaceBase<ND>::serial_type;
+    using real_type = typename SpaceBase<ND>::real_type;
+    using serial_array = SimpleArray<serial_type>;
+    using real_array = SimpleArray<real_type>;
+
+    static constexpr serial_type INVALID = std::numeric_limits<serial_type>::max();
+    /// Most nodes of a face.
+    static constexpr size_t FCND_MAX = ND < 3 ? 2 : 4;
+
+    static_assert(ND == 2 || ND == 3, "StaticMesh supports only 2D and 3D");
+
+    /// Number of faces of a cell of nnode nodes; 0 if not a valid cell.
+    static size_t cell_nface(size_t nnode)
+    {
+        if (ND < 3) { return nnode >= 3 ? nnode : 0; }
+        switch (nnode)
+        {
+        case 4: return 4;
+        case 5: return 5;
+        case 6: return 5;
+        case 8: return 6;
+        default: return 0;
+        }
+    }
+
+    /// Write the nodes of the local face of a cell into fcnds and return
+    /// how many there are.
+    static size_t cell_face(size_t nnode, serial_type const * clnds, size_t ifc, serial_type * fcnds)
+    {
+        if (ND < 3)
+        {
+            fcnds[0] = clnds[ifc];
+            fcnds[1] = clnds[(ifc+1) % nnode];
+            return 2;
+        }
+        // Local nodes of the faces, padded by -1.
+        static constexpr int8_t tetra[4][4] = {{0, 2, 1, -1}, {0, 1, 3, -1}, {1, 2, 3, -1}, {2, 0, 3, -1}};
+        static constexpr int8_t pyramid[5][4] = {{0, 3, 2, 1}, {0, 1, 4, -1}, {1, 2, 4, -1}, {2, 3, 4, -1}, {3, 0, 4, -1}};
+        static constexpr int8_t prism[5][4] = {{0, 2, 1, -1}, {3, 4, 5, -1}, {0, 1, 4, 3}, {1, 2, 5, 4}, {2, 0, 3, 5}};
+        static constexpr int8_t hexa[6][4] = {{0, 3, 2, 1}, {4, 5, 6, 7}, {0, 1, 5, 4}, {1, 2, 6, 5}, {2, 3, 7, 6}, {3, 0, 4, 7}};
+        int8_t const * local = nullptr;
+        switch (nnode)
+        {
+        case 4: local = tetra[ifc]; break;
+        case 5: local = pyramid[ifc]; break;
+        case 6: local = prism[ifc]; break;
+        default: local = hexa[ifc]; break;
+        }
+        size_t ret = 0;
+        for (; ret<4 && local[ret] >= 0; ++ret) { fcnds[ret] = clnds[local[ret]]; }
+        return ret;
+    }
+
+    StaticMesh() = default;
+
+    /**
+     * @param ndcrd  (nnode, ND) node coordinates.
+     * @param clnds_offset  (ncell+1) offsets of the cell nodes.
+     * @param clnds  Nodes of the cells.
+     */
+    StaticMesh(real_array const & ndcrd, serial_array const & clnds_offset, serial_array const & clnds)
+      : m_ndcrd(ndcrd)
+      , m_clnds_offset(clnds_offset)
+      , m_clnds(clnds)
+    {
+        validate();
+        build_faces();
+    }
+
+    StaticMesh(StaticMesh const & ) = default;
+    StaticMesh(StaticMesh       &&) = default;
+    StaticMesh & operator=(StaticMesh const & ) = default;
+    StaticMesh & operator=(StaticMesh       &&) = default;
+    ~StaticMesh() = default;
+
+    size_t nnode() const { return m_ndcrd.ndim() ? m_ndcrd.shape(0) : 0; }
+    size_t ncell() const { return m_clnds_offset.size() ? m_clnds_offset.size() - 1 : 0; }
+    size_t nface() const { return m_fcnds_offset.size() ? m_fcnds_offset.size() - 1 : 0; }
+    /// Number of faces on the boundary.
+    size_t nbface() const { return m_nbface; }
+
+    real_array const & ndcrd() const { return m_ndcrd; }
+    real_array       & ndcrd()       { return m_ndcrd; }
+    serial_array const & clnds_offset() const { return m_clnds_offset; }
+    serial_array const & clnds() const { return m_clnds; }
+    serial_array const & clfcs_offset() const { return m_clfcs_offset; }
+    serial_array const & clfcs() const { return m_clfcs; }
+    serial_array const & clnbs_full() const { return m_clnbs_full; }
+    serial_array const & clnbs_offset() const { return m_clnbs_offset; }
+    serial_array const & clnbs() const { return m_clnbs; }
+    serial_array const & fcnds_offset() const { return m_fcnds_offset; }
+    serial_array const & fcnds() const { return m_fcnds; }
+    serial_array const & fccls() const { return m_fccls; }
+
+    size_t cell_nnode(size_t icl) const { return m_clnds_offset[icl+1] - m_clnds_offset[icl]; }
+    serial_type const * cell_nodes(size_t icl) const { return m_clnds.data() + m_clnds_offset[icl]; }
+
+    /// (ncell, ND) centroids of the cells, averaged over the nodes.
+    real_array cell_centroid() const
+    {
+        MODMESH_TIME("StaticMesh::cell_centroid");
+        real_array ret(std::vector<size_t>{ncell(), ND});
+        KernelPool::me().run
+        (
+            ncell()
+          , [&](size_t begin, size_t end, size_t)
+            {
+                for (size_t icl=begin; icl<end; ++icl)
+                {
+                    const size_t nnd = cell_nnode(icl);
+                    serial_type const * nds = cell_nodes(icl);
+                    for (size_t idm=0; idm<ND; ++idm)
+                    {
+                        real_type sum = 0;
+                        for (size_t it=0; it<nnd; ++it) { sum += m_ndcrd(nds[it], idm); }
+                        ret(icl, idm) = sum / nnd;
+                    }
+                }
+            }
+        );
+        return ret;
+    }
+
+    /// Largest difference between the indices of neighbor cells.
+    size_t cell_bandwidth() const
+    {
+        size_t ret = 0;
+        for (size_t icl=0; icl<ncell(); ++icl)
+        {
+            for (size_t it=m_clnbs_offset[icl]; it<m_clnbs_offset[icl+1]; ++it)
+            {
+                ret = std::max(ret, size_t(m_clnbs[it] > icl ? m_clnbs[it] - icl : icl - m_clnbs[it]));
+            }
+        }
+        return ret;
+    }
+
+    /// Largest difference between the indices of the nodes of a cell.
+    size_t node_bandwidth() const
+    {
+        size_t ret = 0;
+        for (size_t icl=0; icl<ncell(); ++icl)
+        {
+            auto range = std::minmax_element(cell_nodes(icl), cell_nodes(icl) + cell_nnode(icl));
+            ret = std::max(ret, size_t(*range.second - *range.first));
+        }
+        return ret;
+    }
+
+    /// Cells sharing a node, as the graph for ordering the nodes.
+    std::pair<serial_array, serial_array> node_graph() const
+    {
+        MODMESH_TIME("StaticMesh::node_graph");
+        // Cells of every node.
+        serial_array ndcls_offset(nnode()+1);
+        std::fill(ndcls_offset.data(), ndcls_offset.data()+ndcls_offset.size(), serial_type(0));
+        for (size_t it=0; it<m_clnds.size(); ++it) { ++ndcls_offset[m_clnds[it]+1]; }
+        for (size_t ind=0; ind<nnode(); ++ind) { ndcls_offset[ind+1] += ndcls_offset[ind]; }
+        serial_array ndcls(m_clnds.size());
+        {
+            std::vector<serial_type> pos(ndcls_offset.data(), ndcls_offset.data()+nnode());
+            for (size_t icl=0; icl<ncell(); ++icl)
+            {
+                for (size_t it=m_clnds_offset[icl]; it<m_clnds_offset[icl+1]; ++it) { ndcls[pos[m_clnds[it]]++] = serial_type(icl); }
+            }
+        }
+        // Other nodes of the cells of every node, marked by the node to
+        // skip the repeated ones.
+        serial_array xadj(nnode()+1);
+        xadj[0] = 0;
+        KernelPool & pool = KernelPool::me();
+        const size_t nck = pool.nchunk(nnode());
+        std::vector<std::vector<serial_type>> chunk_adjncy(nck);
+        std::vector<size_t> chunk_begin(nck, 0);
+        pool.run
+        (
+            nnode(), nck
+          , [&](size_t begin, size_t end, size_t ick)
+            {
+                std::vector<serial_type> mark(nnode(), INVALID);
+                std::vector<serial_type> & out = chunk_adjncy[ick];
+                chunk_begin[ick] = begin;
+                for (size_t ind=begin; ind<end; ++ind)
+                {
+                    const size_t size = out.size();
+                    for (size_t it=ndcls_offset[ind]; it<ndcls_offset[ind+1]; ++it)
+                    {
+                        serial_type const * nds = cell_nodes(ndcls[it]);
+                        for (size_t jt=0; jt<cell_nnode(ndcls[it]); ++jt)
+                        {
+                            if (nds[jt] != ind && mark[nds[jt]] != ind)
+                            {
+                                mark[nds[jt]] = serial_type(ind);
+                                out.push_back(nds[jt]);
+                            }
+                        }
+                    }
+                    xadj[ind+1] = serial_type(out.size() - size);
+                }
+            }
+        );
+        for (size_t ind=0; ind<nnode(); ++ind) { xadj[ind+1] += xadj[ind]; }
+        serial_array ret(xadj[nnode()]);
+        for (size_t ick=0; ick<nck; ++ick)
+        {
+            std::copy(chunk_adjncy[ick].begin(), chunk_adjncy[ick].end(), ret.data() + xadj[chunk_begin[ick]]);
+        }
+        return {xadj, ret};
+    }
+
+    /// Order of the cells; the old cell of every new cell.
+    serial_array cell_order(ReorderMethod method) const
+    {
+        if (ReorderMethod::RCM == method) { return reorder::rcm(m_clnbs_offset, m_clnbs); }
+        return reorder::curve(cell_centroid(), method);
+    }
+
+    /// Order of the nodes; the old node of every new node.
+    serial_array node_order(ReorderMethod method) const
+    {
+        if (ReorderMethod::RCM == method)
+        {
+            auto graph = node_graph();
+            return reorder::rcm(graph.first, graph.second);
+        }
+        return reorder::curve(m_ndcrd, method);
+    }
+
+    /**
+     * Mesh with the cells and the nodes in the orders.  The faces are
+     * derived again and thus numbered in the new order of the cells.  Use
+     * reorder::permute() for the arrays on the cells and the nodes.
+     */
+    StaticMesh renumber(serial_array const & cell_order, serial_array const & node_order) const
+    {
+        MODMESH_TIME("StaticMesh::renumber");
+        const serial_array node_new = reorder::inverse(node_order, nnode());
+        reorder::validate(cell_order, ncell());
+        serial_array clnds_offset(ncell()+1);
+        clnds_offset[0] = 0;
+        for (size_t icl=0; icl<ncell(); ++icl)
+        {
+            clnds_offset[icl+1] = clnds_offset[icl] + serial_type(cell_nnode(cell_order[icl]));
+        }
+        serial_array clnds(m_clnds.size());
+        KernelPool::me().run
+        (
+            ncell()
+          , [&](size_t begin, size_t end, size_t)
+            {
+                for (size_t icl=begin; icl<end; ++icl)
+                {
+                    serial_type const * nds = cell_nodes(cell_order[icl]);
+                    for (size_t it=0; it<cell_nnode(cell_order[icl]); ++it) { clnds[clnds_offset[icl]+it] = node_new[nds[it]]; }
+                }
+            }
+        );
+        return StaticMesh(reorder::permute(m_ndcrd, node_order), clnds_offset, clnds);
+    }
+
+private:
+
+    void validate() const
+    {
+        if (2 != m_ndcrd.ndim() || ND != m_ndcrd.shape(1))
+        {
+            MODMESH_EXCEPT(StaticMesh, std::invalid_argument, "ndcrd must be (nnode, ND)");
+        }
+        if (1 != m_clnds_offset.ndim() || 0 == m_clnds_offset.size() || 0 != m_clnds_offset[0])
+        {
+            MODMESH_EXCEPT(StaticMesh, std::invalid_argument, "clnds_offset must be 1D and start with 0");
+        }
+        if (1 != m_clnds.ndim() || m_clnds_offset[ncell()] != m_clnds.size())
+        {
+            MODMESH_EXCEPT(StaticMesh, std::invalid_argument, "clnds_offset must end with the size of clnds");
+        }
+        if (!m_ndcrd.is_contiguous() || !m_clnds_offset.is_contiguous() || !m_clnds.is_contiguous())
+        {
+            MODMESH_EXCEPT(StaticMesh, std::invalid_argument, "arrays must be contiguous");
+        }
+        for (size_t icl=0; icl<ncell(); ++icl)
+        {
+            if (m_clnds_offset[icl+1] < m_clnds_offset[icl] || 0 == cell_nface(cell_nnode(icl)))
+            {
+                MODMESH_EXCEPT(StaticMesh, std::invalid_argument, "invalid number of cell nodes");
+            }
+        }
+        for (size_t it=0; it<m_clnds.size(); ++it)
+        {
+            if (m_clnds[it] >= nnode())
+            {
+                MODMESH_EXCEPT(StaticMesh, std::out_of_range, "cell node out of range");
+            }
+        }
+    }
+
+    using face_key = std::array<serial_type, FCND_MAX>;
+
+    static uint64_t hash(face_key const & key)
+    {
+        uint64_t ret = 0;
+        for (serial_type val : key)
+        {
+            // splitmix64 finalizer over the running value.
+            ret = (ret ^ val) * 0x9E3779B97F4A7C15ull;
+            ret = (ret ^ (ret >> 30)) * 0xBF58476D1CE4E5B9ull;
+            ret = (ret ^ (ret >> 27)) * 0x94D049BB133111EBull;
+            ret ^= ret >> 31;
+        }
+        return ret;
+    }
+
+    /**
+     * Derive the faces.  Every local face of every cell is an instance keyed
+     * by its sorted nodes.  The instances are scattered into buckets by the
+     * hash of the key, and each bucket pairs its instances with an
+     * open-addressing table.  The buckets are independent and run in
+     * parallel.
+     */
+    void build_faces()
+    {
+        MODMESH_TIME("StaticMesh::build_faces");
+        KernelPool & pool = KernelPool::me();
+        const size_t ncl = ncell();
+
+        m_clfcs_offset = serial_array(ncl+1);
+        m_clfcs_offset[0] = 0;
+        for (size_t icl=0; icl<ncl; ++icl)
+        {
+            m_clfcs_offset[icl+1] = m_clfcs_offset[icl] + serial_type(cell_nface(cell_nnode(icl)));
+        }
+        const size_t ninst = m_clfcs_offset[ncl];
+
+        // Key, hash, and cell of the instances.
+        std::vector<face_key> key(ninst);
+        std::vector<uint64_t> code(ninst);
+        std::vector<serial_type> owner(ninst);
+        pool.run
+        (
+            ncl
+          , [&](size_t begin, size_t end, size_t)
+            {
+                for (size_t icl=begin; icl<end; ++icl)
+                {
+                    for (size_t ist=m_clfcs_offset[icl]; ist<m_clfcs_offset[icl+1]; ++ist)
+                    {
+                        face_key & fkey = key[ist];
+                        fkey.fill(INVALID);
+                        cell_face(cell_nnode(icl), cell_nodes(icl), ist - m_clfcs_offset[icl], fkey.data());
+                        std::sort(fkey.begin(), fkey.end());
+                        code[ist] = hash(fkey);
+                        owner[ist] = serial_type(icl);
+                    }
+                }
+            }
+        );
+
+        // Scatter the instances into buckets, keeping the instance order in
+        // every bucket.
+        constexpr size_t nbucket = 1024;
+        const size_t nck = pool.nchunk(ninst);
+        std::vector<size_t> bucket_count(nck * nbucket, 0);
+        pool.run
+        (
+            ninst, nck
+          , [&](size_t begin, size_t end, size_t ick)
+            {
+                size_t * count = bucket_count.data() + ick * nbucket;
+                for (size_t ist=begin; ist<end; ++ist) { ++count[code[ist] % nbucket]; }
+            }
+        );
+        std::vector<size_t> bucket_offset(nbucket+1, 0);
+        {
+            size_t sum = 0;
+            for (size_t ibk=0; ibk<nbucket; ++ibk)
+            {
+                bucket_offset[ibk] = sum;
+                for (size_t ick=0; ick<nck; ++ick)
+                {
+                    const size_t val = bucket_count[ick*nbucket+ibk];
+                    bucket_count[ick*nbucket+ibk] = sum;
+                    sum += val;
+                }
+            }
+            bucket_offset[nbucket] = sum;
+        }
+        std::vector<serial_type> order(ninst);
+        pool.run
+        (
+            ninst, nck
+          , [&](size_t begin, size_t end, size_t ick)
+            {
+                size_t * pos = bucket_count.data() + ick * nbucket;
+                for (size_t ist=begin; ist<end; ++ist) { order[pos[code[ist] % nbucket]++] = serial_type(ist); }
+            }
+        );
+
+        // Pair the instances sharing a face.
+        std::vector<serial_type> mate(ninst, INVALID);
+        pool.run
+        (
+            nbucket, nck
+          , [&](size_t begin, size_t end, size_t)
+            {
+                std::vector<serial_type> table;
+                for (size_t ibk=begin; ibk<end; ++ibk)
+                {
+                    const size_t size = bucket_offset[ibk+1] - bucket_offset[ibk];
+                    size_t nslot = 16;
+                    while (nslot < 2*size) { nslot *= 2; }
+                    table.assign(nslot, INVALID);
+                    for (size_t it=bucket_offset[ibk]; it<bucket_offset[ibk+1]; ++it)
+                    {
+                        const serial_type ist = order[it];
+                        size_t islot = (code[ist] / nbucket) & (nslot-1);
+                        while (INVALID != table[islot] && key[table[islot]] != key[ist]) { islot = (islot+1) & (nslot-1); }
+                        const serial_type first = table[islot];
+                        if (INVALID == first) { table[islot] = ist; }
+                        else if (INVALID != mate[first])
+                        {
+                            MODMESH_EXCEPT(StaticMesh, std::invalid_argument, "face shared by more than two cells");
+                        }
+                        else
+                        {
+                            mate[first] = ist;
+                            mate[ist] = first;
+                        }
+                    }
+                }
+            }
+        );
+
+        // Number the faces by their first instances.
+        std::vector<size_t> chunk_nface(nck+1, 0);
+        pool.run
+        (
+            ninst, nck
+          , [&](size_t begin, size_t end, size_t ick)
+            {
+                size_t count = 0;
+                for (size_t ist=begin; ist<end; ++ist) { count += mate[ist] > ist; }
+                chunk_nface[ick+1] = count;
+            }
+        );
+        for (size_t ick=0; ick<nck; ++ick) { chunk_nface[ick+1] += chunk_nface[ick]; }
+        const size_t nfc = chunk_nface[nck];
+        m_clfcs = serial_array(ninst);
+        m_clnbs_full = serial_array(ninst);
+        m_fccls = serial_array(std::vector<size_t>{nfc, 2});
+        serial_array fcnnd(nfc);
+        pool.run
+        (
+            ninst, nck
+          , [&](size_t begin, size_t end, size_t ick)
+            {
+                size_t ifc = chunk_nface[ick];
+                for (size_t ist=begin; ist<end; ++ist)
+                {
+                    if (mate[ist] < ist) { continue; }
+                    m_clfcs[ist] = serial_type(ifc);
+                    m_fccls(ifc, 0) = owner[ist];
+                    m_fccls(ifc, 1) = INVALID == mate[ist] ? INVALID : owner[mate[ist]];
+                    fcnnd[ifc] = serial_type(std::count_if(key[ist].begin(), key[ist].end(), [](serial_type val) { return INVALID != val; }));
+                    ++ifc;
+                }
+            }
+        );
+        pool.run
+        (
+            ninst, nck
+          , [&](size_t begin, size_t end, size_t)
+            {
+                for (size_t ist=begin; ist<end; ++ist)
+                {
+                    if (mate[ist] < ist) { m_clfcs[ist] = m_clfcs[mate[ist]]; }
+                    m_clnbs_full[ist] = INVALID == mate[ist] ? INVALID : owner[mate[ist]];
+                }
+            }
+        );
+
+        // Face nodes in the order of the owning cell.
+        m_fcnds_offset = serial_array(nfc+1);
+        m_fcnds_offset[0] = 0;
+        m_nbface = 0;
+        for (size_t ifc=0; ifc<nfc; ++ifc)
+        {
+            m_fcnds_offset[ifc+1] = m_fcnds_offset[ifc] + fcnnd[ifc];
+            m_nbface += INVALID == m_fccls(ifc, 1);
+        }
+        m_fcnds = serial_array(m_fcnds_offset[nfc]);
+        pool.run
+        (
+            ncl
+          , [&](size_t begin, size_t end, size_t)
+            {
+                for (size_t icl=begin; icl<end; ++icl)
+                {
+                    for (size_t ist=m_clfcs_offset[icl]; ist<m_clfcs_offset[icl+1]; ++ist)
+                    {
+                        const serial_type ifc = m_clfcs[ist];
+                        if (mate[ist] < ist) { continue; }
+                        cell_face(cell_nnode(icl), cell_nodes(icl), ist - m_clfcs_offset[icl], m_fcnds.data() + m_fcnds_offset[ifc]);
+                    }
+                }
+            }
+        );
+
+        // Compact neighbors.
+        m_clnbs_offset = serial_array(ncl+1);
+        m_clnbs_offset[0] = 0;
+        for (size_t icl=0; icl<ncl; ++icl)
+        {
+            serial_type count = 0;
+            for (size_t ist=m_clfcs_offset[icl]; ist<m_clfcs_offset[icl+1]; ++ist) { count += INVALID != m_clnbs_full[ist]; }
+            m_clnbs_offset[icl+1] = m_clnbs_offset[icl] + count;
+        }
+        m_clnbs = serial_array(m_clnbs_offset[ncl]);
+        pool.run
+        (
+            ncl
+          , [&](size_t begin, size_t end, size_t)
+            {
+                for (size_t icl=begin; icl<end; ++icl)
+                {
+                    size_t pos = m_clnbs_offset[icl];
+                    for (size_t ist=m_clfcs_offset[icl]; ist<m_clfcs_offset[icl+1]; ++ist)
+                    {
+                        if (INVALID != m_clnbs_full[ist]) { m_clnbs[pos++] = m_clnbs_full[ist]; }
+                    }
+                }
+            }
+        );
+    }
+
+    real_array m_ndcrd = real_array(std::vector<size_t>{0, ND});
+    serial_array m_clnds_offset = serial_array(1);
+    serial_array m_clnds = serial_array(0);
+    serial_array m_clfcs_offset = serial_array(1);
+    serial_array m_clfcs = serial_array(0);
+    serial_array m_clnbs_full = serial_array(0);
+    serial_array m_clnbs_offset = serial_array(1);
+    serial_array m_clnbs = serial_array(0);
+    serial_array m_fcnds_offset = serial_array(1);
+    serial_array m_fcnds = serial_array(0);
+    serial_array m_fccls = serial_array(std::vector<size_t>{0, 2});
+    size_t m_nbface = 0;
+
+}; /* end class StaticMesh */
+
+/**
+ * 2D unstructured mesh.
+ */
+class StaticMesh2d
+  : public StaticMesh<2>
+{
+
+public:
+
+    using base_type = StaticMesh<2>;
+    using base_type::base_type;
+
+    StaticMesh2d() = default;
+    StaticMesh2d(base_type const & other) : base_type(other) {}
+    StaticMesh2d(base_type && other) : base_type(std::move(other)) {}
+
+    /// Mesh of nx by ny quadrilaterals, or twice as many triangles, on
+    /// [0, lx] x [0, ly].
+    static StaticMesh2d rectangle
+    (
+        serial_type nx, serial_type ny, real_type lx=1, real_type ly=1, bool triangle=false
+    )
+    {
+        const size_t nnd = size_t(nx+1) * (ny+1);
+        real_array ndcrd(std::vector<size_t>{nnd, 2});
+        for (size_t j=0; j<=ny; ++j)
+        {
+            for (size_t i=0; i<=nx; ++i)
+            {
+                ndcrd(j*(nx+1)+i, 0) = lx * i / nx;
+                ndcrd(j*(nx+1)+i, 1) = ly * j / ny;
+            }
+        }
+        const size_t ncl = size_t(nx) * ny * (triangle ? 2 : 1);
+        const size_t nclnd = triangle ? 3 : 4;
+        serial_array offset(ncl+1);
+        serial_array clnds(ncl*nclnd);
+        for (size_t icl=0; icl<=ncl; ++icl) { offset[icl] = serial_type(icl*nclnd); }
+        size_t pos = 0;
+        for (size_t j=0; j<ny; ++j)
+        {
+            for (size_t i=0; i<nx; ++i)
+            {
+                const serial_type n0 = serial_type(j*(nx+1)+i);
+                const serial_type n1 = n0 + 1;
+                const serial_type n2 = n1 + nx + 1;
+                const serial_type n3 = n0 + nx + 1;
+                if (triangle)
+                {
+                    for (serial_type nd : {n0, n1, n2, n0, n2, n3}) { clnds[pos++] = nd; }
+                }
+                else
+                {
+                    for (serial_type nd : {n0, n1, n2, n3}) { clnds[pos++] = nd; }
+                }
+            }
+        }
+        return StaticMesh2d(ndcrd, offset, clnds);
+    }
+
+}; /* end class StaticMesh2d */
+
+/**
+ * 3D unstructured mesh.
+ */
+class StaticMesh3d
+  : public StaticMesh<3>
+{
+
+public:
+
+    using base_type = StaticMesh<3>;
+    using base_type::base_type;
+
+    StaticMesh3d() = default;
+    StaticMesh3d(base_type const & other) : base_type(other) {}
+    StaticMesh3d(base_type && other) : base_type(std::move(other)) {}
+
+    /// Mesh of nx by ny by nz hexahedra on [0, lx] x [0, ly] x [0, lz].
+    static StaticMesh3d box
+    (
+        serial_type nx, serial_type ny, serial_type nz, real_type lx=1, real_type ly=1, real_type lz=1
+    )
+    {
+        const size_t nnd = size_t(nx+1) * (ny+1) * (nz+1);
+        auto node = [=](size_t i, size_t j, size_t k) { return serial_type((k*(ny+1)+j)*(nx+1)+i); };
+        real_array ndcrd(std::vector<size_t>{nnd, 3});
+        for (size_t k=0; k<=nz; ++k)
+        {
+            for (size_t j=0; j<=ny; ++j)
+            {
+                for (size_t i=0; i<=nx; ++i)
+                {
+                    ndcrd(node(i, j, k), 0) = lx * i / nx;
+                    ndcrd(node(i, j, k), 1) = ly * j / ny;
+                    ndcrd(node(i, j, k), 2) = lz * k / nz;
+                }
+            }
+        }
+        const size_t ncl = size_t(nx) * ny * nz;
+        serial_array offset(ncl+1);
+        serial_array clnds(ncl*8);
+        for (size_t icl=0; icl<=ncl; ++icl) { offset[icl] = serial_type(icl*8); }
+        size_t pos = 0;
+        for (size_t k=0; k<nz; ++k)
+        {
+            for (size_t j=0; j<ny; ++j)
+            {
+                for (size_t i=0; i<nx; ++i)
+                {
+                    for (serial_type nd : {node(i, j, k), node(i+1, j, k), node(i+1, j+1, k), node(i, j+1, k),
+                                           node(i, j, k+1), node(i+1, j, k+1), node(i+1, j+1, k+1), node(i, j+1, k+1)})
+                    {
+                        clnds[pos++] = nd;
+                    }
+                }
+            }
+        }
+        return StaticMesh3d(ndcrd, offset, clnds);
+    }
+
+}; /* end class StaticMesh3d */
+
+} /* end namespace modmesh */
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
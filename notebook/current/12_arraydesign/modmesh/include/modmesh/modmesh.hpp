@@ -6,7 +6,18 @@
  */
 
 #include "modmesh/base.hpp"
+#include "modmesh/buffer.hpp"
 #include "modmesh/profile.hpp"
+#include "modmesh/kernel.hpp"
+#include "modmesh/reorder.hpp"
 #include "modmesh/grid.hpp"
+#include "modmesh/mesh.hpp"
+#include "modmesh/partition.hpp"
+#include "modmesh/submesh.hpp"
+#include "modmesh/spatial.hpp"
+#include "modmesh/kdtree.hpp"
+#include "modmesh/locate.hpp"
+#include "modmesh/poisson.hpp"
+#include "modmesh/polyfit.hpp"
 
 // vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,655 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD-style license; see COPYING
+ */
+
+/**
+ * Graph of mesh connectivity and its partitioning.
+ */
+
+#include "modmesh/base.hpp"
+#include "modmesh/buffer.hpp"
+#include "modmesh/kernel.hpp"
+#include "modmesh/mesh.hpp"
+#include "modmesh/profile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * Undirected graph in the CSR format: the neighbors of vertex i are
+ * adjncy[xadj[i]:xadj[i+1]], and every edge is stored in both directions.
+ * The vertices and the edges carry integer weights.
+ */
+class StaticGraph
+{
+
+public:
+
+    using serial_type = uint32_t;
+    using weight_type = int64_t;
+    using serial_array = SimpleArray<serial_type>;
+
+    StaticGraph() = default;
+
+    /// Graph with unit weights.
+    StaticGraph(serial_array const & xadj, serial_array const & adjncy)
+      : StaticGraph(xadj, adjncy, filled(xadj.size() ? xadj.size()-1 : 0, 1), filled(adjncy.size(), 1))
+    {}
+
+    StaticGraph(serial_array const & xadj, serial_array const & adjncy, serial_array const & vwgt, serial_array const & adjwgt)
+      : m_xadj(xadj)
+      , m_adjncy(adjncy)
+      , m_vwgt(vwgt)
+      , m_adjwgt(adjwgt)
+    {
+        validate();
+    }
+
+    /// Dual graph of the mesh, whose vertices are the cells and whose edges
+    /// are the interior faces.
+    template <size_t ND>
+    static StaticGraph dual(StaticMesh<ND> const & mesh)
+    {
+        return StaticGraph(mesh.clnbs_offset(), mesh.clnbs());
+    }
+
+    StaticGraph(StaticGraph const & ) = default;
+    StaticGraph(StaticGraph       &&) = default;
+    StaticGraph & operator=(StaticGraph const & ) = default;
+    StaticGraph & operator=(StaticGraph       &&) = default;
+    ~StaticGraph() = default;
+
+    size_t nvertex() const { return m_xadj.size() - 1; }
+    /// Number of undirected edges.
+    size_t nedge() const { return m_adjncy.size() / 2; }
+
+    serial_array const & xadj() const { return m_xadj; }
+    serial_array const & adjncy() const { return m_adjncy; }
+    serial_array const & vwgt() const { return m_vwgt; }
+    serial_array const & adjwgt() const { return m_adjwgt; }
+
+    /// Total weight of the edges between different parts.
+    weight_type edge_cut(serial_array const & part) const
+    {
+        ensure_part(part);
+        weight_type ret = 0;
+        for (size_t iv=0; iv<nvertex(); ++iv)
+        {
+            for (size_t ie=m_xadj[iv]; ie<m_xadj[iv+1]; ++ie)
+            {
+                if (part[iv] != part[m_adjncy[ie]]) { ret += m_adjwgt[ie]; }
+            }
+        }
+        return ret / 2;
+    }
+
+    /// Heaviest part over the average part weight; 1 is perfectly balanced.
+    double imbalance(serial_array const & part, size_t nparts) const
+    {
+        ensure_part(part);
+        std::vector<weight_type> pwgt(nparts, 0);
+        weight_type total = 0;
+        for (size_t iv=0; iv<nvertex(); ++iv)
+        {
+            if (part[iv] >= nparts)
+            {
+                MODMESH_EXCEPT(StaticGraph, std::out_of_range, "part out of range");
+            }
+            pwgt[part[iv]] += m_vwgt[iv];
+            total += m_vwgt[iv];
+        }
+        if (0 == total) { return 1; }
+        return double(*std::max_element(pwgt.begin(), pwgt.end())) * nparts / total;
+    }
+
+private:
+
+    static serial_array filled(size_t size, serial_type value)
+    {
+        serial_array ret(size);
+        std::fill(ret.data(), ret.data()+size, value);
+        return ret;
+    }
+
+    void validate() const
+    {
+        if (1 != m_xadj.ndim() || 0 == m_xadj.size() || 0 != m_xadj[0] || m_xadj[nvertex()] != m_adjncy.size())
+        {
+            MODMESH_EXCEPT(StaticGraph, std::invalid_argument, "xadj must start with 0 and end with the size of adjncy");
+        }
+        if (m_vwgt.size() != nvertex() || m_adjwgt.size() != m_adjncy.size())
+        {
+            MODMESH_EXCEPT(StaticGraph, std::invalid_argument, "weights must match vertices and edges");
+        }
+        for (size_t iv=0; iv<nvertex(); ++iv)
+        {
+            if (m_xadj[iv+1] < m_xadj[iv])
+            {
+                MODMESH_EXCEPT(StaticGraph, std::invalid_argument, "xadj must not decrease");
+            }
+        }
+        for (size_t ie=0; ie<m_adjncy.size(); ++ie)
+        {
+            if (m_adjncy[ie] >= nvertex())
+            {
+                MODMESH_EXCEPT(StaticGraph, std::out_of_range, "adjacent vertex out of range");
+            }
+        }
+    }
+
+    void ensure_part(serial_array const & part) const
+    {
+        if (part.size() != nvertex())
+        {
+            MODMESH_EXCEPT(StaticGraph, std::invalid_argument, "part must have one entry per vertex");
+        }
+    }
+
+    serial_array m_xadj = filled(1, 0);
+    serial_array m_adjncy = serial_array(0);
+    serial_array m_vwgt = serial_array(0);
+    serial_array m_adjwgt = serial_array(0);
+
+}; /* end class StaticGraph */
+
+/**
+ * Multilevel recursive bisection.  Every bisection coarsens the graph by
+ * heavy-edge matching, bisects the coarsest graph by growing a region from
+ * a few random seeds, and projects the bisection back level by level while
+ * refining it with Fiduccia-Mattheyses (FM) moves.  The bisections of the
+ * same level of the recursion are independent and run on KernelPool.
+ *
+ * The result only depends on the graph, the options and the seed; not on
+ * the number of threads.
+ */
+class GraphPartitioner
+{
+
+public:
+
+    using serial_type = StaticGraph::serial_type;
+    using weight_type = StaticGraph::weight_type;
+    using serial_array = StaticGraph::serial_array;
+
+    GraphPartitioner() = default;
+
+    /// Seed of the random visiting orders.
+    uint64_t seed() const { return m_seed; }
+    void set_seed(uint64_t value) { m_seed = value; }
+
+    /// Largest allowed part weight over the average part weight.
+    double ubfactor() const { return m_ubfactor; }
+    void set_ubfactor(double value)
+    {
+        if (!(value >= 1))
+        {
+            MODMESH_EXCEPT(GraphPartitioner, std::invalid_argument, "ubfactor must be at least 1");
+        }
+        m_ubfactor = value;
+    }
+
+    /// Number of vertices below which coarsening stops.
+    size_t coarsen_to() const { return m_coarsen_to; }
+    void set_coarsen_to(size_t value) { m_coarsen_to = std::max(value, size_t(2)); }
+
+    /// Maximum number of FM passes per level.
+    size_t niter() const { return m_niter; }
+    void set_niter(size_t value) { m_niter = value; }
+
+    /// Number of region-growing trials on the coarsest graph.
+    size_t ntrial() const { return m_ntrial; }
+    void set_ntrial(size_t value) { m_ntrial = std::max(value, size_t(1)); }
+
+    /// Part of every vertex, in [0, nparts).
+    serial_array partition(StaticGraph const & graph, size_t nparts) const
+    {
+        MODMESH_TIME("GraphPartitioner::partition");
+        if (0 == nparts)
+        {
+            MODMESH_EXCEPT(GraphPartitioner, std::invalid_argument, "nparts must be positive");
+        }
+        serial_array ret(graph.nvertex());
+        std::fill(ret.data(), ret.data()+ret.size(), serial_type(0));
+
+        // The imbalance compounds over the levels of the recursion.
+        const size_t nlevel = size_t(std::ceil(std::log2(double(nparts))));
+        const double ubfactor = nlevel ? std::pow(m_ubfactor, 1.0/nlevel) : m_ubfactor;
+
+        std::vector<Task> tasks(1);
+        tasks[0].graph = WorkGraph(graph);
+        tasks[0].label.resize(graph.nvertex());
+        std::iota(tasks[0].label.begin(), tasks[0].label.end(), serial_type(0));
+        tasks[0].first = 0;
+        tasks[0].npart = serial_type(nparts);
+        tasks[0].id = 1;
+        while (!tasks.empty())
+        {
+            std::vector<Task> next(2 * tasks.size());
+            KernelPool::me().run_tasks
+            (
+                tasks.size()
+              , [&](size_t itask)
+                {
+                    Task & task = tasks[itask];
+                    if (1 == task.npart)
+                    {
+                        for (serial_type iv : task.label) { ret[iv] = task.first; }
+                        return;
+                    }
+                    split(task, ubfactor, next[2*itask], next[2*itask+1]);
+                    task = Task();
+                }
+            );
+            next.erase
+            (
+                std::remove_if(next.begin(), next.end(), [](Task const & task) { return 0 == task.npart; })
+              , next.end()
+            );
+            tasks.swap(next);
+        }
+        return ret;
+    }
+
+private:
+
+    /// Graph being bisected, with weights for the contracted vertices.
+    struct WorkGraph
+    {
+        WorkGraph() : xadj(1, 0) {}
+
+        explicit WorkGraph(StaticGraph const & graph)
+          : xadj(graph.xadj().data(), graph.xadj().data() + graph.xadj().size())
+          , adjncy(graph.adjncy().data(), graph.adjncy().data() + graph.adjncy().size())
+          , vwgt(graph.vwgt().data(), graph.vwgt().data() + graph.vwgt().size())
+          , adjwgt(graph.adjwgt().data(), graph.adjwgt().data() + graph.adjwgt().size())
+        {}
+
+        size_t size() const { return vwgt.size(); }
+
+        weight_type total() const { return std::accumulate(vwgt.begin(), vwgt.end(), weight_type(0)); }
+
+        std::vector<serial_type> xadj;
+        std::vector<serial_type> adjncy;
+        std::vector<weight_type> vwgt;
+        std::vector<weight_type> adjwgt; // Coarse edges sum their weights.
+    };
+
+    /// Sub-graph to be split into npart parts numbered from first.
+    struct Task
+    {
+        WorkGraph graph;
+        // Vertex of the input graph of every vertex.
+        std::vector<serial_type> label;
+        serial_type first = 0;
+        serial_type npart = 0;
+        // Position in the recursion tree, for seeding.
+        uint64_t id = 0;
+    };
+
+    static constexpr serial_type INVALID = std::numeric_limits<serial_type>::max();
+
+    /// Bisect the task and put the two halves into the children.
+    void split(Task const & task, double ubfactor, Task & left, Task & right) const
+    {
+        MODMESH_TIME("GraphPartitioner::split");
+        WorkGraph const & graph = task.graph;
+        left.npart = task.npart / 2;
+        right.npart = task.npart - left.npart;
+        left.first = task.first;
+        right.first = task.first + left.npart;
+        left.id = 2 * task.id;
+        right.id = 2 * task.id + 1;
+
+        std::mt19937_64 rng(m_seed * 0x9E3779B97F4A7C15ull + task.id);
+        std::vector<uint8_t> where = bisect(graph, double(left.npart) / task.npart, ubfactor, rng);
+
+        // Number the vertices of either side in the original order.
+        std::vector<serial_type> local(graph.size());
+        serial_type count[2] = {0, 0};
+        for (size_t iv=0; iv<graph.size(); ++iv) { local[iv] = count[where[iv]]++; }
+        Task * child[2] = {&left, &right};
+        for (size_t side=0; side<2; ++side)
+        {
+            WorkGraph & sub = child[side]->graph;
+            std::vector<serial_type> & label = child[side]->label;
+            sub.vwgt.reserve(count[side]);
+            sub.xadj.reserve(count[side] + 1);
+            label.reserve(count[side]);
+            for (size_t iv=0; iv<graph.size(); ++iv)
+            {
+                if (side != where[iv]) { continue; }
+                for (size_t ie=graph.xadj[iv]; ie<graph.xadj[iv+1]; ++ie)
+                {
+                    const serial_type jv = graph.adjncy[ie];
+                    if (side != where[jv]) { continue; }
+                    sub.adjncy.push_back(local[jv]);
+                    sub.adjwgt.push_back(graph.adjwgt[ie]);
+                }
+                sub.xadj.push_back(serial_type(sub.adjncy.size()));
+                sub.vwgt.push_back(graph.vwgt[iv]);
+                label.push_back(task.label[iv]);
+            }
+        }
+    }
+
+    /**
+     * Multilevel bisection giving the fraction frac of the weight to side
+     * 0.  Return the side of every vertex.
+     */
+    std::vector<uint8_t> bisect(WorkGraph const & graph, double frac, double ubfactor, std::mt19937_64 & rng) const
+    {
+        const weight_type total = graph.total();
+        weight_type target[2];
+        target[0] = weight_type(std::llround(frac * total));
+        target[1] = total - target[0];
+
+        // Coarsen.
+        std::vector<WorkGraph> levels;
+        std::vector<std::vector<serial_type>> cmaps;
+        WorkGraph const * fine = &graph;
+        std::vector<serial_type> mate;
+        const weight_type maxvwgt = std::max(weight_type(1.5 * total / m_coarsen_to), weight_type(1));
+        while (fine->size() > m_coarsen_to)
+        {
+            match(*fine, maxvwgt, rng, mate);
+            size_t npair = 0;
+            for (size_t iv=0; iv<fine->size(); ++iv) { npair += mate[iv] > iv; }
+            // Stop when few vertices match, e.g., in a star.
+            if (npair < 0.05 * fine->size()) { break; }
+            std::vector<serial_type> cmap;
+            levels.push_back(contract(*fine, mate, cmap));
+            cmaps.push_back(std::move(cmap));
+            fine = &levels.back();
+        }
+
+        // Bisect the coarsest graph.
+        std::vector<uint8_t> where = grow(*fine, target, ubfactor, rng);
+
+        // Project back and refine.
+        for (size_t ilevel=levels.size(); ilevel>0; --ilevel)
+        {
+            WorkGraph const & finer = ilevel > 1 ? levels[ilevel-2] : graph;
+            std::vector<serial_type> const & cmap = cmaps[ilevel-1];
+            std::vector<uint8_t> projected(finer.size());
+            for (size_t iv=0; iv<finer.size(); ++iv) { projected[iv] = where[cmap[iv]]; }
+            where.swap(projected);
+            refine(finer, where, target, ubfactor);
+        }
+        return where;
+    }
+
+    /**
+     * Heavy-edge matching: visit the vertices in a random order and match
+     * every unmatched one with the unmatched neighbor across the heaviest
+     * edge.  mate gets the partner of every vertex, or the vertex itself.
+     */
+    static void match(WorkGraph const & graph, weight_type maxvwgt, std::mt19937_64 & rng, std::vector<serial_type> & mate)
+    {
+        MODMESH_TIME("GraphPartitioner::match");
+        const size_t nv = graph.size();
+        // Shuffle blocks of consecutive vertices instead of single vertices,
+        // so that a block shares the cache lines of its neighbors.
+        constexpr size_t block = 16;
+        std::vector<serial_type> order((nv + block - 1) / block);
+        std::iota(order.begin(), order.end(), serial_type(0));
+        std::shuffle(order.begin(), order.end(), rng);
+        mate.assign(nv, INVALID);
+        for (size_t ib=0; ib<order.size()*block; ++ib)
+        {
+            const serial_type iv = serial_type(order[ib / block] * block + ib % block);
+            if (iv >= nv) { continue; }
+            if (INVALID != mate[iv]) { continue; }
+            serial_type best = iv;
+            weight_type bestwgt = 0;
+            for (size_t ie=graph.xadj[iv]; ie<graph.xadj[iv+1]; ++ie)
+            {
+                const serial_type jv = graph.adjncy[ie];
+                if (INVALID == mate[jv] && jv != iv && graph.adjwgt[ie] > bestwgt
+                 && graph.vwgt[iv] + graph.vwgt[jv] <= maxvwgt)
+                {
+                    best = jv;
+                    bestwgt = graph.adjwgt[ie];
+                }
+            }
+            mate[iv] = best;
+            mate[best] = iv;
+        }
+    }
+
+    /**
+     * Merge the matched pairs.  cmap gets the coarse vertex of every
+     * vertex, numbered in the order of the lower vertex of the pairs.
+     */
+    static WorkGraph contract(WorkGraph const & graph, std::vector<serial_type> const & mate, std::vector<serial_type> & cmap)
+    {
+        MODMESH_TIME("GraphPartitioner::contract");
+        const size_t nv = graph.size();
+        cmap.resize(nv);
+        size_t ncoarse = 0;
+        for (size_t iv=0; iv<nv; ++iv)
+        {
+            if (mate[iv] >= iv) { cmap[iv] = cmap[mate[iv]] = serial_type(ncoarse++); }
+        }
+        WorkGraph ret;
+        ret.xadj.reserve(ncoarse + 1);
+        ret.vwgt.reserve(ncoarse);
+        ret.adjncy.reserve(graph.adjncy.size());
+        ret.adjwgt.reserve(graph.adjncy.size());
+        // Position of the coarse neighbors in the row being built.
+        std::vector<serial_type> pos(ncoarse, INVALID);
+        for (size_t iv=0; iv<nv; ++iv)
+        {
+            const serial_type jv = mate[iv];
+            if (jv < iv) { continue; }
+            const serial_type icv = cmap[iv];
+            const size_t row = ret.adjncy.size();
+            ret.vwgt.push_back(graph.vwgt[iv] + (jv != iv ? graph.vwgt[jv] : 0));
+            for (serial_type kv : {serial_type(iv), jv})
+            {
+                for (size_t ie=graph.xadj[kv]; ie<graph.xadj[kv+1]; ++ie)
+                {
+                    const serial_type jcv = cmap[graph.adjncy[ie]];
+                    if (jcv == icv) { continue; }
+                    if (INVALID == pos[jcv])
+                    {
+                        pos[jcv] = serial_type(ret.adjncy.size());
+                        ret.adjncy.push_back(jcv);
+                        ret.adjwgt.push_back(graph.adjwgt[ie]);
+                    }
+                    else
+                    {
+                        ret.adjwgt[pos[jcv]] += graph.adjwgt[ie];
+                    }
+                }
+                if (jv == iv) { break; }
+            }
+            for (size_t ie=row; ie<ret.adjncy.size(); ++ie) { pos[ret.adjncy[ie]] = INVALID; }
+            ret.xadj.push_back(serial_type(ret.adjncy.size()));
+        }
+        return ret;
+    }
+
+    /// Grow side 0 from random seeds in breadth-first order, refine, and
+    /// keep the best trial.
+    std::vector<uint8_t> grow(WorkGraph const & graph, weight_type const target[2], double ubfactor, std::mt19937_64 & rng) const
+    {
+        MODMESH_TIME("GraphPartitioner::grow");
+        const size_t nv = graph.size();
+        std::vector<uint8_t> best(nv, 1);
+        if (0 == nv) { return best; }
+        Score best_score{std::numeric_limits<weight_type>::max(), std::numeric_limits<weight_type>::max()};
+        std::vector<uint8_t> where(nv);
+        std::vector<serial_type> queue;
+        queue.reserve(nv);
+        for (size_t itrial=0; itrial<m_ntrial; ++itrial)
+        {
+            std::fill(where.begin(), where.end(), uint8_t(1));
+            weight_type grown = 0;
+            size_t head = 0;
+            queue.clear();
+            std::uniform_int_distribution<size_t> pick(0, nv-1);
+            while (grown < target[0])
+            {
+                if (head == queue.size())
+                {
+                    // Start a new region in another component.
+                    serial_type iv = serial_type(pick(rng));
+                    for (size_t it=0; it<nv && 0 == where[iv]; ++it) { iv = serial_type((iv + 1) % nv); }
+                    if (0 == where[iv]) { break; }
+                    queue.push_back(iv);
+                }
+                const serial_type iv = queue[head++];
+                if (0 == where[iv]) { continue; }
+                where[iv] = 0;
+                grown += graph.vwgt[iv];
+                for (size_t ie=graph.xadj[iv]; ie<graph.xadj[iv+1]; ++ie)
+                {
+                    if (where[graph.adjncy[ie]]) { queue.push_back(graph.adjncy[ie]); }
+                }
+            }
+            const Score score = refine(graph, where, target, ubfactor);
+            if (score < best_score)
+            {
+                best_score = score;
+                best = where;
+            }
+        }
+        return best;
+    }
+
+    /// Weight over the limits, then the edge cut; lower is better.
+    using Score = std::pair<weight_type, weight_type>;
+
+    /**
+     * FM refinement.  A pass moves boundary vertices one at a time from the
+     * heavier side, relative to the target, by the highest gain (decrease of
+     * the edge cut), even if negative, and then rolls back to the best state
+     * it went through.  Return the score of the result.
+     */
+    Score refine(WorkGraph const & graph, std::vector<uint8_t> & where, weight_type const target[2], double ubfactor) const
+    {
+        MODMESH_TIME("GraphPartitioner::refine");
+        const size_t nv = graph.size();
+        weight_type limit[2];
+        for (size_t side=0; side<2; ++side)
+        {
+            // Allow at least the heaviest vertex over the target.
+            limit[side] = std::max(weight_type(ubfactor * target[side]), target[side] + 1);
+        }
+
+        // Internal and external degrees.
+        std::vector<weight_type> ideg(nv, 0);
+        std::vector<weight_type> edeg(nv, 0);
+        weight_type pwgt[2] = {0, 0};
+        weight_type cut = 0;
+        for (size_t iv=0; iv<nv; ++iv)
+        {
+            pwgt[where[iv]] += graph.vwgt[iv];
+            for (size_t ie=graph.xadj[iv]; ie<graph.xadj[iv+1]; ++ie)
+            {
+                (where[graph.adjncy[ie]] == where[iv] ? ideg : edeg)[iv] += graph.adjwgt[ie];
+            }
+            cut += edeg[iv];
+        }
+        cut /= 2;
+        auto score = [&]()
+        {
+            return Score(std::max(pwgt[0] - limit[0], weight_type(0)) + std::max(pwgt[1] - limit[1], weight_type(0)), cut);
+        };
+
+        auto move = [&](serial_type iv)
+        {
+            const uint8_t to = where[iv] ^ 1;
+            pwgt[where[iv]] -= graph.vwgt[iv];
+            pwgt[to] += graph.vwgt[iv];
+            cut -= edeg[iv] - ideg[iv];
+            std::swap(ideg[iv], edeg[iv]);
+            where[iv] = to;
+            for (size_t ie=graph.xadj[iv]; ie<graph.xadj[iv+1]; ++ie)
+            {
+                const serial_type jv = graph.adjncy[ie];
+                const weight_type wgt = graph.adjwgt[ie];
+                if (where[jv] == to) { ideg[jv] += wgt; edeg[jv] -= wgt; }
+                else { ideg[jv] -= wgt; edeg[jv] += wgt; }
+            }
+        };
+
+        using entry = std::pair<weight_type, serial_type>;
+        std::priority_queue<entry> queue[2];
+        std::vector<uint8_t> locked(nv, 0);
+        std::vector<serial_type> moved;
+        const size_t patience = std::min(std::max(nv / 100, size_t(25)), size_t(200));
+        Score best = score();
+        for (size_t iter=0; iter<m_niter; ++iter)
+        {
+            for (size_t side=0; side<2; ++side) { queue[side] = std::priority_queue<entry>(); }
+            for (size_t iv=0; iv<nv; ++iv)
+            {
+                if (edeg[iv] > 0) { queue[where[iv]].emplace(edeg[iv] - ideg[iv], serial_type(iv)); }
+            }
+            moved.clear();
+            size_t nbest = 0;
+            const Score start = best;
+            while (moved.size() - nbest < patience)
+            {
+                const uint8_t from = pwgt[0] - target[0] >= pwgt[1] - target[1] ? 0 : 1;
+                serial_type iv = INVALID;
+                while (!queue[from].empty())
+                {
+                    const entry top = queue[from].top();
+                    queue[from].pop();
+                    const serial_type jv = top.second;
+                    // Skip the entries made stale by earlier moves.
+                    if (locked[jv] || where[jv] != from || top.first != edeg[jv] - ideg[jv]) { continue; }
+                    if (pwgt[1-from] + graph.vwgt[jv] > limit[1-from] && pwgt[from] <= limit[from]) { continue; }
+                    iv = jv;
+                    break;
+                }
+                if (INVALID == iv) { break; }
+                move(iv);
+                locked[iv] = 1;
+                moved.push_back(iv);
+                for (size_t ie=graph.xadj[iv]; ie<graph.xadj[iv+1]; ++ie)
+                {
+                    const serial_type jv = graph.adjncy[ie];
+                    if (!locked[jv] && edeg[jv] > 0) { queue[where[jv]].emplace(edeg[jv] - ideg[jv], jv); }
+                }
+                const Score current = score();
+                if (current < best)
+                {
+                    best = current;
+                    nbest = moved.size();
+                }
+            }
+            // Roll back the moves after the best state.
+            for (size_t it=moved.size(); it>nbest; --it) { move(moved[it-1]); }
+            for (serial_type iv : moved) { locked[iv] = 0; }
+            if (!(best < start)) { break; }
+        }
+        return best;
+    }
+
+    uint64_t m_seed = 0;
+    double m_ubfactor = 1.03;
+    size_t m_coarsen_to = 100;
+    size_t m_niter = 8;
+    size_t m_ntrial = 4;
+
+}; /* end class GraphPartitioner */
+
+} /* end namespace modmesh */
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,512 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD-style license; see COPYING
+ */
+
+/**
+ * Solvers of the Poisson equation on structured grids.
+ */
+
+#include "modmesh/base.hpp"
+#include "modmesh/grid.hpp"
+#include "modmesh/kernel.hpp"
+#include "modmesh/profile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace modmesh
+{
+
+/**
+ * Solve -(u_xx + u_yy) = f on the interior of a StaticGrid2d by the
+ * five-point stencil, with the Dirichlet values of u in the first ghost
+ * layer.  The Laplace equation has f = 0.  The grids of u and f must be in
+ * GridLayout::ROW_MAJOR with at least one ghost layer.
+ *
+ * A sweep of red-black SOR updates the points of i+j even and then those of
+ * i+j odd, in place.  Every thread takes a block of rows and updates the
+ * black row behind the red row, so that a sweep reads the grid about once.
+ *
+ * A V-cycle smooths with red-black Gauss-Seidel and corrects with the
+ * error from the coarser grid of half the points, down to a few points.
+ * A coarse grid spans the same domain with uniform spacing, and the
+ * correction is interpolated linearly; point 2I+1 of a grid of 2^k-1 points
+ * per axis is point I of the coarser one.  The residual is restricted by
+ * the transpose of the interpolation while it is computed, row by row, and
+ * its largest magnitude comes with it.
+ */
+class PoissonSolver2d
+{
+
+public:
+
+    using serial_type = StaticGrid2d::serial_type;
+    using real_type = StaticGrid2d::real_type;
+    using index_type = StaticGrid2d::index_type;
+
+    /// Sweeps before and after the coarse-grid correction.
+    static constexpr size_t NPRE = 2;
+    static constexpr size_t NPOST = 2;
+
+    PoissonSolver2d(serial_type nx, serial_type ny, real_type hx=1, real_type hy=1)
+      : m_hx(hx)
+      , m_hy(hy)
+    {
+        if (0 == nx || 0 == ny || !(hx > 0) || !(hy > 0))
+        {
+            MODMESH_EXCEPT(PoissonSolver2d, std::invalid_argument, "grid must have points and positive spacing");
+        }
+        m_shape.push_back({nx, ny});
+        m_spacing.push_back({hx, hy});
+        while (nx >= 3 && ny >= 3)
+        {
+            m_transfer.push_back({Transfer(nx, nx/2), Transfer(ny, ny/2)});
+            nx /= 2;
+            ny /= 2;
+            hx *= m_transfer.back()[0].ratio;
+            hy *= m_transfer.back()[1].ratio;
+            m_shape.push_back({nx, ny});
+            m_spacing.push_back({hx, hy});
+            m_u.emplace_back(nx, ny, 1);
+            m_f.emplace_back(nx, ny, 1);
+            m_u.back().fill(0);
+            m_f.back().fill(0);
+        }
+    }
+
+    PoissonSolver2d(PoissonSolver2d const & ) = default;
+    PoissonSolver2d(PoissonSolver2d       &&) = default;
+    PoissonSolver2d & operator=(PoissonSolver2d const & ) = default;
+    PoissonSolver2d & operator=(PoissonSolver2d       &&) = default;
+    ~PoissonSolver2d() = default;
+
+    size_t nx() const { return m_shape[0][0]; }
+    size_t ny() const { return m_shape[0][1]; }
+    real_type hx() const { return m_hx; }
+    real_type hy() const { return m_hy; }
+    /// Number of grids in a V-cycle, the finest included.
+    size_t nlevel() const { return m_shape.size(); }
+
+    /// Largest magnitude of the residual f + u_xx + u_yy.
+    real_type residual(StaticGrid2d const & u, StaticGrid2d const & f) const
+    {
+        MODMESH_TIME("PoissonSolver2d::residual");
+        validate(u, f);
+        const Stencil st(m_hx, m_hy);
+        KernelPool & pool = KernelPool::me();
+        std::vector<real_type> partial(pool.nchunk(u.nx() * u.ny()), 0);
+        pool.run
+        (
+            u.nx(), partial.size()
+          , [&](size_t begin, size_t end, size_t ick)
+            {
+                std::vector<real_type> row(u.ny());
+                real_type mx = 0;
+                for (size_t i=begin; i<end; ++i)
+                {
+                    mx = std::max(mx, residual_row(u, f, st, index_type(i), row.data()));
+                }
+                partial[ick] = mx;
+            }
+        );
+        return *std::max_element(partial.begin(), partial.end());
+    }
+
+    /**
+     * Run red-black SOR sweeps with the relaxation factor omega (1 for
+     * Gauss-Seidel) and return the largest change of u in the last one.
+     */
+    real_type sor(StaticGrid2d & u, StaticGrid2d const & f, real_type omega=1, size_t nsweep=1) const
+    {
+        MODMESH_TIME("PoissonSolver2d::sor");
+        validate(u, f);
+        if (!(omega > 0 && omega < 2))
+        {
+            MODMESH_EXCEPT(PoissonSolver2d, std::invalid_argument, "omega must be in (0, 2)");
+        }
+        const Stencil st(m_hx, m_hy);
+        real_type ret = 0;
+        for (size_t it=0; it<nsweep; ++it) { ret = sweep(u, f, st, omega); }
+        return ret;
+    }
+
+    /**
+     * Run a V-cycle and return the largest magnitude of the residual after
+     * the smoothing before the correction.  The cycle stops there if it is
+     * at most tolerance.
+     */
+    real_type vcycle(StaticGrid2d & u, StaticGrid2d const & f, real_type tolerance=0)
+    {
+        MODMESH_TIME("PoissonSolver2d::vcycle");
+        validate(u, f);
+        return cycle(0, u, f, tolerance);
+    }
+
+    /**
+     * Run V-cycles until the largest magnitude of the residual is at most
+     * tolerance, or max_cycle of them.  Return the number of cycles and the
+     * residual.
+     */
+    std::pair<size_t, real_type> solve(StaticGrid2d & u, StaticGrid2d const & f, real_type tolerance, size_t max_cycle=100)
+    {
+        MODMESH_TIME("PoissonSolver2d::solve");
+        validate(u, f);
+        real_type norm = 0;
+        for (size_t it=0; it<max_cycle; ++it)
+        {
+            norm = cycle(0, u, f, tolerance);
+            if (norm <= tolerance) { return {it+1, norm}; }
+        }
+        return {max_cycle, norm};
+    }
+
+private:
+
+    static constexpr size_t RED = 0;
+    static constexpr size_t BLACK = 1;
+
+    /// Linear interpolation along an axis from a coarse grid spanning the
+    /// same domain.
+    struct Transfer
+    {
+        Transfer(serial_type nfine, serial_type ncoarse)
+          : ratio(real_type(nfine+1) / real_type(ncoarse+1))
+          , lower(nfine)
+          , weight(nfine)
+        {
+            // Fine point i is at (i+1)*(ncoarse+1)/(nfine+1) - 1 along the
+            // coarse grid, whose ghost points are -1 and ncoarse.
+            for (serial_type i=0; i<nfine; ++i)
+            {
+                const serial_type pos = (i+1) * (ncoarse+1);
+                lower[i] = index_type(pos / (nfine+1)) - 1;
+                weight[i] = real_type(pos % (nfine+1)) / real_type(nfine+1);
+            }
+        }
+        // Fine spacings in a coarse spacing.
+        real_type ratio;
+        // Coarse point below and the weight of the one above, per fine point.
+        std::vector<index_type> lower;
+        std::vector<real_type> weight;
+    }; /* end struct Transfer */
+
+    struct Stencil
+    {
+        Stencil(real_type hx, real_type hy)
+          : ax(1 / (hx*hx))
+          , ay(1 / (hy*hy))
+          , cx(ax / (2*(ax+ay)))
+          , cy(ay / (2*(ax+ay)))
+          , cf(1 / (2*(ax+ay)))
+        {}
+        real_type ax, ay;
+        // Gauss-Seidel update.
+        real_type cx, cy, cf;
+    }; /* end struct Stencil */
+
+    void validate(StaticGrid2d const & u, StaticGrid2d const & f) const
+    {
+        auto fit = [&](StaticGrid2d const & grid)
+        {
+            return GridLayout::ROW_MAJOR == grid.layout() && grid.nghost() >= 1
+                && grid.nx() == nx() && grid.ny() == ny();
+        };
+        if (!fit(u) || !fit(f))
+        {
+            MODMESH_EXCEPT(PoissonSolver2d, std::invalid_argument, "grids must be row-major of the solver shape with a ghost layer");
+        }
+    }
+
+    /// V-cycle from the level; u and f are the grids of the level.
+    real_type cycle(size_t level, StaticGrid2d & u, StaticGrid2d const & f, real_type tolerance)
+    {
+        const Stencil st(m_spacing[level][0], m_spacing[level][1]);
+        auto smooth = [&](size_t nsweep)
+        {
+            for (size_t it=0; it<nsweep; ++it) { sweep(u, f, st, 1); }
+        };
+        if (level + 1 == nlevel())
+        {
+            // The coarsest grid has a few points along an axis.
+            smooth(2 * (u.nx() + u.ny()));
+            return 0;
+        }
+        smooth(NPRE);
+        StaticGrid2d & cu = m_u[level];
+        StaticGrid2d & cf = m_f[level];
+        const real_type norm = restrict_residual(u, f, st, m_transfer[level], cf);
+        if (0 == level && norm <= tolerance) { return norm; }
+        cu.fill(0);
+        cycle(level+1, cu, cf, 0);
+        prolong(cu, m_transfer[level], u);
+        smooth(NPOST);
+        return norm;
+    }
+
+    /// One red-black sweep; the largest change.
+    static real_type sweep(StaticGrid2d & u, StaticGrid2d const & f, Stencil const & st, real_type omega)
+    {
+        KernelPool & pool = KernelPool::me();
+        std::vector<real_type> partial(pool.nchunk(u.nx() * u.ny()), 0);
+        // The red row and the black row behind it.  The first and the last
+        // rows of a block are next to other blocks; their black points wait
+        // for the red points of all blocks, and they are updated without
+        // SIMD, which would touch the points of the other color.
+        pool.run
+        (
+            u.nx(), partial.size()
+          , [&](size_t begin, size_t end, size_t ick)
+            {
+                real_type mx = 0;
+                for (size_t i=begin; i<end; ++i)
+                {
+                    mx = std::max(mx, relax_row(u, f, st, omega, index_type(i), RED, i != begin && i+1 != end));
+                    if (i > begin + 1) { mx = std::max(mx, relax_row(u, f, st, omega, index_type(i-1), BLACK, true)); }
+                }
+                partial[ick] = mx;
+            }
+        );
+        pool.run
+        (
+            u.nx(), partial.size()
+          , [&](size_t begin, size_t end, size_t ick)
+            {
+                if (begin == end) { return; }
+                real_type mx = relax_row(u, f, st, omega, index_type(begin), BLACK, false);
+                if (end - 1 > begin) { mx = std::max(mx, relax_row(u, f, st, omega, index_type(end-1), BLACK, false)); }
+                partial[ick] = std::max(partial[ick], mx);
+            }
+        );
+        return *std::max_element(partial.begin(), partial.end());
+    }
+
+    /// Relax the points of the color in row i; the largest change.
+    static real_type relax_row
+    (
+        StaticGrid2d & u, StaticGrid2d const & f, Stencil const & st, real_type omega
+      , index_type i, size_t color, bool simd
+    )
+    {
+        const size_t ny = u.ny();
+        const size_t ustride = u.stride()[0];
+        real_type * row = u.data() + u.offset({i, 0});
+        real_type const * up = row - ustride;
+        real_type const * dn = row + ustride;
+        real_type const * src = f.data() + f.offset({i, 0});
+        real_type mx = 0;
+        size_t j = 0;
+#if defined(__AVX__)
+        if (simd)
+        {
+            const __m256d vcx = _mm256_set1_pd(st.cx);
+            const __m256d vcy = _mm256_set1_pd(st.cy);
+            const __m256d vcf = _mm256_set1_pd(st.cf);
+            const __m256d vom = _mm256_set1_pd(omega);
+            const __m256d sign = _mm256_set1_pd(-0.0);
+            // Lanes of the color from an even column.
+            const __m256i mask = 0 == ((i + color) & 1) ? _mm256_set_epi64x(0, -1, 0, -1) : _mm256_set_epi64x(-1, 0, -1, 0);
+            __m256d vmx = _mm256_setzero_pd();
+            for (; j+4<=ny; j+=4)
+            {
+                const __m256d old = _mm256_loadu_pd(row+j);
+                const __m256d vert = _mm256_add_pd(_mm256_loadu_pd(up+j), _mm256_loadu_pd(dn+j));
+                const __m256d horz = _mm256_add_pd(_mm256_loadu_pd(row+j-1), _mm256_loadu_pd(row+j+1));
+                __m256d gs = _mm256_mul_pd(vcx, vert);
+                gs = _mm256_add_pd(gs, _mm256_mul_pd(vcy, horz));
+                gs = _mm256_add_pd(gs, _mm256_mul_pd(vcf, _mm256_loadu_pd(src+j)));
+                __m256d delta = _mm256_mul_pd(vom, _mm256_sub_pd(gs, old));
+                delta = _mm256_and_pd(delta, _mm256_castsi256_pd(mask));
+                _mm256_maskstore_pd(row+j, mask, _mm256_add_pd(old, delta));
+                vmx = _mm256_max_pd(vmx, _mm256_andnot_pd(sign, delta));
+            }
+            real_type lanes[4];
+            _mm256_storeu_pd(lanes, vmx);
+            mx = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+        }
+#else
+        (void)simd;
+#endif
+        // First column of the color from j.
+        j += (i + j + color) & 1;
+        for (; j<ny; j+=2)
+        {
+            const real_type gs = st.cx * (up[j] + dn[j]) + st.cy * (row[j-1] + row[j+1]) + st.cf * src[j];
+            const real_type delta = omega * (gs - row[j]);
+            row[j] += delta;
+            mx = std::max(mx, std::abs(delta));
+        }
+        return mx;
+    }
+
+    /// Residual of row i into out; the largest magnitude.
+    static real_type residual_row(StaticGrid2d const & u, StaticGrid2d const & f, Stencil const & st, index_type i, real_type * out)
+    {
+        const size_t ny = u.ny();
+        const size_t ustride = u.stride()[0];
+        real_type const * row = u.data() + u.offset({i, 0});
+        real_type const * up = row - ustride;
+        real_type const * dn = row + ustride;
+        real_type const * src = f.data() + f.offset({i, 0});
+        real_type mx = 0;
+        size_t j = 0;
+#if defined(__AVX__)
+        {
+            const __m256d vax = _mm256_set1_pd(st.ax);
+            const __m256d vay = _mm256_set1_pd(st.ay);
+            const __m256d two = _mm256_set1_pd(2);
+            const __m256d sign = _mm256_set1_pd(-0.0);
+            __m256d vmx = _mm256_setzero_pd();
+            for (; j+4<=ny; j+=4)
+            {
+                const __m256d mid = _mm256_mul_pd(two, _mm256_loadu_pd(row+j));
+                const __m256d vert = _mm256_sub_pd(_mm256_add_pd(_mm256_loadu_pd(up+j), _mm256_loadu_pd(dn+j)), mid);
+                const __m256d horz = _mm256_sub_pd(_mm256_add_pd(_mm256_loadu_pd(row+j-1), _mm256_loadu_pd(row+j+1)), mid);
+                __m256d res = _mm256_add_pd(_mm256_loadu_pd(src+j), _mm256_mul_pd(vax, vert));
+                res = _mm256_add_pd(res, _mm256_mul_pd(vay, horz));
+                _mm256_storeu_pd(out+j, res);
+                vmx = _mm256_max_pd(vmx, _mm256_andnot_pd(sign, res));
+            }
+            real_type lanes[4];
+            _mm256_storeu_pd(lanes, vmx);
+            mx = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+        }
+#endif
+        for (; j<ny; ++j)
+        {
+            const real_type res = src[j] + st.ax * (up[j] + dn[j] - 2*row[j]) + st.ay * (row[j-1] + row[j+1] - 2*row[j]);
+            out[j] = res;
+            mx = std::max(mx, std::abs(res));
+        }
+        return mx;
+    }
+
+    /**
+     * Restrict the residual onto the coarse right-hand side, computing the
+     * fine residual a row at a time; the largest magnitude of the fine
+     * residual.
+     */
+    static real_type restrict_residual
+    (
+        StaticGrid2d const & u, StaticGrid2d const & f, Stencil const & st
+      , std::array<Transfer, 2> const & tr, StaticGrid2d & coarse
+    )
+    {
+        const size_t nx = u.nx();
+        const size_t ny = u.ny();
+        const size_t cny = coarse.ny();
+        Transfer const & tx = tr[0];
+        Transfer const & ty = tr[1];
+        // The transpose of the interpolation sums the fine points over a
+        // coarse cell.
+        const real_type scale = 1 / (tx.ratio * ty.ratio);
+        KernelPool & pool = KernelPool::me();
+        std::vector<real_type> partial(pool.nchunk(nx * ny), 0);
+        pool.run
+        (
+            coarse.nx(), partial.size()
+          , [&](size_t begin, size_t end, size_t ick)
+            {
+                if (begin == end) { return; }
+                const index_type cbegin = index_type(begin);
+                const index_type cend = index_type(end);
+                for (index_type ic=cbegin; ic<cend; ++ic)
+                {
+                    real_type * dst = coarse.data() + coarse.offset({ic, 0});
+                    std::fill(dst, dst+cny, real_type(0));
+                }
+                // Fine residual row and its restriction along the row,
+                // including the coarse ghost columns.
+                std::vector<real_type> row(ny);
+                std::vector<real_type> line(cny+2);
+                real_type mx = 0;
+                // Fine rows between the coarse rows begin-1 and end.
+                size_t i = std::lower_bound(tx.lower.begin(), tx.lower.end(), cbegin-1) - tx.lower.begin();
+                for (; i<nx && tx.lower[i]<cend; ++i)
+                {
+                    mx = std::max(mx, residual_row(u, f, st, index_type(i), row.data()));
+                    std::fill(line.begin(), line.end(), real_type(0));
+                    for (size_t j=0; j<ny; ++j)
+                    {
+                        const size_t jc = size_t(ty.lower[j] + 1);
+                        line[jc] += (1 - ty.weight[j]) * row[j];
+                        line[jc+1] += ty.weight[j] * row[j];
+                    }
+                    const index_type lo = tx.lower[i];
+                    const real_type w = tx.weight[i];
+                    if (lo >= cbegin)
+                    {
+                        real_type * dst = coarse.data() + coarse.offset({lo, 0});
+                        for (size_t jc=0; jc<cny; ++jc) { dst[jc] += scale * (1 - w) * line[jc+1]; }
+                    }
+                    if (lo+1 < cend)
+                    {
+                        real_type * dst = coarse.data() + coarse.offset({lo+1, 0});
+                        for (size_t jc=0; jc<cny; ++jc) { dst[jc] += scale * w * line[jc+1]; }
+                    }
+                }
+                partial[ick] = mx;
+            }
+        );
+        return *std::max_element(partial.begin(), partial.end());
+    }
+
+    /// Add the bilinear interpolation of the coarse correction to the fine
+    /// grid.  The ghost points of the coarse grid are zero.
+    static void prolong(StaticGrid2d const & coarse, std::array<Transfer, 2> const & tr, StaticGrid2d & u)
+    {
+        const size_t nx = u.nx();
+        const size_t ny = u.ny();
+        const size_t cny = coarse.ny();
+        Transfer const & tx = tr[0];
+        Transfer const & ty = tr[1];
+        KernelPool & pool = KernelPool::me();
+        pool.run
+        (
+            nx, pool.nchunk(nx * ny)
+          , [&](size_t begin, size_t end, size_t)
+            {
+                // Coarse row at the fine row, including the ghost columns.
+                std::vector<real_type> line(cny+2);
+                for (size_t i=begin; i<end; ++i)
+                {
+                    real_type const * lo = coarse.data() + coarse.offset({tx.lower[i], -1});
+                    real_type const * hi = lo + coarse.stride()[0];
+                    const real_type w = tx.weight[i];
+                    for (size_t jc=0; jc<cny+2; ++jc) { line[jc] = (1 - w) * lo[jc] + w * hi[jc]; }
+                    real_type * dst = u.data() + u.offset({index_type(i), 0});
+                    for (size_t j=0; j<ny; ++j)
+                    {
+                        const size_t jc = size_t(ty.lower[j] + 1);
+                        dst[j] += (1 - ty.weight[j]) * line[jc] + ty.weight[j] * line[jc+1];
+                    }
+                }
+            }
+        );
+    }
+
+    real_type m_hx;
+    real_type m_hy;
+    std::vector<std::array<serial_type, 2>> m_shape;
+    std::vector<std::array<real_type, 2>> m_spacing;
+    // Interpolation from each coarse grid to the finer one.
+    std::vector<std::array<Transfer, 2>> m_transfer;
+    // Correction and right-hand side of the coarse grids.
+    std::vector<StaticGrid2d> m_u;
+    std::vector<StaticGrid2d> m_f;
+
+}; /* end class PoissonSolver2d */
+
+} /* end namespace modmesh */
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
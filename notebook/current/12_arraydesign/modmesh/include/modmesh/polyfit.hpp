@@ -0,0 +1,351 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD-style license; see COPYING
+ */
+
+/**
+ * Least-squares polynomial fitting of groups of points.
+ */
+
+#include "modmesh/base.hpp"
+#include "modmesh/buffer.hpp"
+#include "modmesh/kernel.hpp"
+#include "modmesh/profile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace modmesh
+{
+
+/**
+ * Fit a polynomial of the order to every group of the points (x, y) by
+ * least squares, where x is sorted ascending.  A group is a range of
+ * consecutive points, given by offsets, or by the edges of bins of x and
+ * then found by binary search.  The coefficients of a group make a row of
+ * the result, from the highest degree, as numpy.poly1d takes them.  A
+ * group of too few distinct x for the order gets NaN.
+ *
+ * A group is fitted with x mapped to [-1, 1] over it, which keeps the
+ * normal equations well conditioned, and the coefficients are mapped back
+ * to x; the coefficients of a high order far from x = 0 still cancel and
+ * lose digits.  The sums of the normal equations take four points at a
+ * time.  The threads take the groups of equal shares of the points.
+ *
+ * Every method also takes contiguous memory by pointer, so that the Python
+ * wrapper reads and writes numpy arrays in place.
+ */
+class PolynomialFitter
+{
+
+public:
+
+    using real_type = double;
+    using offset_type = int64_t;
+    using real_array = SimpleArray<real_type>;
+    using offset_array = SimpleArray<offset_type>;
+
+    static constexpr size_t MAX_ORDER = 10;
+
+    explicit PolynomialFitter(size_t order)
+      : m_order(order)
+    {
+        if (order > MAX_ORDER)
+        {
+            MODMESH_EXCEPT(PolynomialFitter, std::invalid_argument, "order exceeds MAX_ORDER");
+        }
+    }
+
+    PolynomialFitter(PolynomialFitter const & ) = default;
+    PolynomialFitter(PolynomialFitter       &&) = default;
+    PolynomialFitter & operator=(PolynomialFitter const & ) = default;
+    PolynomialFitter & operator=(PolynomialFitter       &&) = default;
+    ~PolynomialFitter() = default;
+
+    size_t order() const { return m_order; }
+    size_t ncoefficient() const { return m_order + 1; }
+
+    /// Offsets of the points in the bins [edges[k], edges[k+1]), and the end
+    /// of the last bin.
+    static offset_array bin_offsets(real_array const & x, real_array const & edges)
+    {
+        validate_points(x, x);
+        if (1 != edges.ndim() || !edges.is_contiguous())
+        {
+            MODMESH_EXCEPT(PolynomialFitter, std::invalid_argument, "edges must be a contiguous 1D array of at least one edge");
+        }
+        offset_array ret(edges.size());
+        bin_offsets(x.data(), x.size(), edges.data(), edges.size(), ret.data());
+        return ret;
+    }
+
+    /// Same as above over contiguous memory, into the nedge offsets of out.
+    static void bin_offsets(real_type const * x, size_t npoint, real_type const * edges, size_t nedge, offset_type * out)
+    {
+        MODMESH_TIME("PolynomialFitter::bin_offsets");
+        if (0 == nedge)
+        {
+            MODMESH_EXCEPT(PolynomialFitter, std::invalid_argument, "edges must be a contiguous 1D array of at least one edge");
+        }
+        if (!std::is_sorted(edges, edges + nedge))
+        {
+            MODMESH_EXCEPT(PolynomialFitter, std::invalid_argument, "edges must be sorted ascending");
+        }
+        KernelPool::me().run
+        (
+            nedge
+          , [&](size_t begin, size_t end, size_t)
+            {
+                for (size_t it=begin; it<end; ++it)
+                {
+                    out[it] = offset_type(std::lower_bound(x, x + npoint, edges[it]) - x);
+                }
+            }
+        );
+    }
+
+    /// Coefficients fitted to all the points.
+    real_array fit(real_array const & x, real_array const & y) const
+    {
+        validate_points(x, y);
+        real_array ret(ncoefficient());
+        fit(x.data(), y.data(), x.size(), ret.data());
+        return ret;
+    }
+
+    /// Same as above over contiguous memory, into the order+1 coefficients of
+    /// out.
+    void fit(real_type const * x, real_type const * y, size_t npoint, real_type * out) const
+    {
+        fit_range(x, y, npoint, out);
+    }
+
+    /// Coefficients of the bins, in the shape (nbin, order+1).
+    real_array fit_bins(real_array const & x, real_array const & y, real_array const & edges) const
+    {
+        return fit_groups(x, y, bin_offsets(x, edges));
+    }
+
+    void fit_bins(real_array const & x, real_array const & y, real_array const & edges, real_array & out) const
+    {
+        fit_groups(x, y, bin_offsets(x, edges), out);
+    }
+
+    /// Same as above over contiguous memory, into the (nedge-1)*(order+1)
+    /// coefficients of out.
+    void fit_bins(real_type const * x, real_type const * y, size_t npoint, real_type const * edges, size_t nedge, real_type * out) const
+    {
+        std::vector<offset_type> offsets(nedge);
+        bin_offsets(x, npoint, edges, nedge, offsets.data());
+        fit_groups(x, y, npoint, offsets.data(), nedge, out);
+    }
+
+    /**
+     * Coefficients of the groups [offsets[k], offsets[k+1]), in the shape
+     * (ngroup, order+1).
+     */
+    real_array fit_groups(real_array const & x, real_array const & y, offset_array const & offsets) const
+    {
+        real_array ret(std::vector<size_t>{offsets.size() ? offsets.size()-1 : 0, ncoefficient()});
+        fit_groups(x, y, offsets, ret);
+        return ret;
+    }
+
+    /// Same as above but into out of the shape (ngroup, order+1).
+    void fit_groups(real_array const & x, real_array const & y, offset_array const & offsets, real_array & out) const
+    {
+        validate_points(x, y);
+        if (1 != offsets.ndim() || !offsets.is_contiguous() || 0 == offsets.size())
+        {
+            MODMESH_EXCEPT(PolynomialFitter, std::invalid_argument, "offsets must be a contiguous 1D array of at least one offset");
+        }
+        if (2 != out.ndim() || !out.is_contiguous() || offsets.size() - 1 != out.shape(0) || ncoefficient() != out.shape(1))
+        {
+            MODMESH_EXCEPT(PolynomialFitter, std::invalid_argument, "out must be contiguous of the shape (ngroup, order+1)");
+        }
+        fit_groups(x.data(), y.data(), x.size(), offsets.data(), offsets.size(), out.data());
+    }
+
+    /// Same as above over contiguous memory, into the
+    /// (noffset-1)*(order+1) coefficients of out.
+    void fit_groups(real_type const * x, real_type const * y, size_t npoint, offset_type const * offsets, size_t noffset, real_type * out) const
+    {
+        MODMESH_TIME("PolynomialFitter::fit_groups");
+        if (0 == noffset)
+        {
+            MODMESH_EXCEPT(PolynomialFitter, std::invalid_argument, "offsets must be a contiguous 1D array of at least one offset");
+        }
+        offset_type const * obegin = offsets;
+        offset_type const * oend = obegin + noffset;
+        if (*obegin < 0 || offset_type(npoint) < *(oend-1) || !std::is_sorted(obegin, oend))
+        {
+            MODMESH_EXCEPT(PolynomialFitter, std::invalid_argument, "offsets must be ascending within the points");
+        }
+        const size_t ngroup = noffset - 1;
+        const size_t nfit = size_t(*(oend-1) - *obegin);
+        // A chunk of points takes the groups starting in it.
+        KernelPool::me().run
+        (
+            nfit
+          , [&](size_t begin, size_t end, size_t)
+            {
+                const size_t gbegin = 0 == begin ? 0 : std::lower_bound(obegin, oend-1, *obegin + offset_type(begin)) - obegin;
+                const size_t gend = nfit == end ? ngroup : std::lower_bound(obegin, oend-1, *obegin + offset_type(end)) - obegin;
+                for (size_t ig=gbegin; ig<gend; ++ig)
+                {
+                    const size_t first = size_t(obegin[ig]);
+                    fit_range(x + first, y + first, size_t(obegin[ig+1]) - first, out + ig * ncoefficient());
+                }
+            }
+        );
+    }
+
+private:
+
+    static void validate_points(real_array const & x, real_array const & y)
+    {
+        if (1 != x.ndim() || 1 != y.ndim() || !x.is_contiguous() || !y.is_contiguous() || x.size() != y.size())
+        {
+            MODMESH_EXCEPT(PolynomialFitter, std::invalid_argument, "x and y must be contiguous 1D arrays of the same size");
+        }
+    }
+
+    /// Fit the npoint points into the order+1 coefficients of out.
+    void fit_range(real_type const * x, real_type const * y, size_t npoint, real_type * out) const
+    {
+        const size_t ncoef = ncoefficient();
+        if (npoint < ncoef)
+        {
+            std::fill(out, out+ncoef, std::numeric_limits<real_type>::quiet_NaN());
+            return;
+        }
+        // Map [x[0], x[npoint-1]] to [-1, 1].
+        const real_type center = (x[0] + x[npoint-1]) / 2;
+        const real_type half = (x[npoint-1] - x[0]) / 2;
+        const real_type scale = half > 0 ? 1 / half : 1;
+        // Sums of t^k for k in [0, 2*order] and of y*t^k for k in [0, order].
+        real_type moment[2*MAX_ORDER+1];
+        real_type rhs[MAX_ORDER+1];
+        accumulate(x, y, npoint, center, scale, moment, rhs);
+        // Cholesky factor of the normal matrix, in the lower triangle.
+        real_type gram[MAX_ORDER+1][MAX_ORDER+1];
+        for (size_t it=0; it<ncoef; ++it)
+        {
+            for (size_t jt=0; jt<=it; ++jt)
+            {
+                real_type val = moment[it+jt];
+                for (size_t kt=0; kt<jt; ++kt) { val -= gram[it][kt] * gram[jt][kt]; }
+                if (it != jt) { gram[it][jt] = val / gram[jt][jt]; continue; }
+                // The pivot vanishes when the distinct x are too few.
+                if (!(val > moment[2*it] * std::numeric_limits<real_type>::epsilon() * 64))
+                {
+                    std::fill(out, out+ncoef, std::numeric_limits<real_type>::quiet_NaN());
+                    return;
+                }
+                gram[it][it] = std::sqrt(val);
+            }
+        }
+        real_type coef[MAX_ORDER+1];
+        for (size_t it=0; it<ncoef; ++it)
+        {
+            real_type val = rhs[it];
+            for (size_t kt=0; kt<it; ++kt) { val -= gram[it][kt] * coef[kt]; }
+            coef[it] = val / gram[it][it];
+        }
+        for (size_t it=ncoef; it-->0;)
+        {
+            real_type val = coef[it];
+            for (size_t kt=it+1; kt<ncoef; ++kt) { val -= gram[kt][it] * coef[kt]; }
+            coef[it] = val / gram[it][it];
+        }
+        // Back to x by Horner's rule over (x - center) * scale, from the
+        // highest degree.
+        real_type poly[MAX_ORDER+1] = {};
+        for (size_t it=ncoef; it-->0;)
+        {
+            // poly *= (x - center) * scale, with poly[k] for x^k.
+            for (size_t kt=ncoef-1; kt>0; --kt) { poly[kt] = (poly[kt-1] - center * poly[kt]) * scale; }
+            poly[0] = -center * poly[0] * scale + coef[it];
+        }
+        for (size_t it=0; it<ncoef; ++it) { out[it] = poly[ncoef-1-it]; }
+    }
+
+    void accumulate
+    (
+        real_type const * x, real_type const * y, size_t npoint, real_type center, real_type scale
+      , real_type * moment, real_type * rhs
+    ) const
+    {
+        const size_t nmoment = 2 * m_order + 1;
+        std::fill(moment, moment+nmoment, real_type(0));
+        std::fill(rhs, rhs+m_order+1, real_type(0));
+        size_t it = 0;
+#if defined(__AVX__)
+        {
+            __m256d vmoment[2*MAX_ORDER+1];
+            __m256d vrhs[MAX_ORDER+1];
+            for (size_t kt=0; kt<nmoment; ++kt) { vmoment[kt] = _mm256_setzero_pd(); }
+            for (size_t kt=0; kt<=m_order; ++kt) { vrhs[kt] = _mm256_setzero_pd(); }
+            const __m256d vcenter = _mm256_set1_pd(center);
+            const __m256d vscale = _mm256_set1_pd(scale);
+            const __m256d one = _mm256_set1_pd(1);
+            for (; it+4<=npoint; it+=4)
+            {
+                const __m256d t = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(x+it), vcenter), vscale);
+                const __m256d v = _mm256_loadu_pd(y+it);
+                __m256d power = one;
+                for (size_t kt=0; kt<=m_order; ++kt)
+                {
+                    vmoment[kt] = _mm256_add_pd(vmoment[kt], power);
+                    vrhs[kt] = _mm256_add_pd(vrhs[kt], _mm256_mul_pd(power, v));
+                    power = _mm256_mul_pd(power, t);
+                }
+                for (size_t kt=m_order+1; kt<nmoment; ++kt)
+                {
+                    vmoment[kt] = _mm256_add_pd(vmoment[kt], power);
+                    power = _mm256_mul_pd(power, t);
+                }
+            }
+            real_type lanes[4];
+            for (size_t kt=0; kt<nmoment; ++kt)
+            {
+                _mm256_storeu_pd(lanes, vmoment[kt]);
+                moment[kt] = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            }
+            for (size_t kt=0; kt<=m_order; ++kt)
+            {
+                _mm256_storeu_pd(lanes, vrhs[kt]);
+                rhs[kt] = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            }
+        }
+#endif
+        for (; it<npoint; ++it)
+        {
+            const real_type t = (x[it] - center) * scale;
+            real_type power = 1;
+            for (size_t kt=0; kt<nmoment; ++kt)
+            {
+                moment[kt] += power;
+                if (kt <= m_order) { rhs[kt] += power * y[it]; }
+                power *= t;
+            }
+        }
+    }
+
+    size_t m_order;
+
+}; /* end class PolynomialFitter */
+
+} /* end namespace modmesh */
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -7,51 +7,254 @@
 
 #include "modmesh/base.hpp"
 
+#include <time.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define MODMESH_CONCAT_IMPL(A, B) A ## B
+#define MODMESH_CONCAT(A, B) MODMESH_CONCAT_IMPL(A, B)
+
+#if defined(__GNUC__)
+#define MODMESH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define MODMESH_NOINLINE __declspec(noinline)
+#else
+#define MODMESH_NOINLINE
+#endif
+
 /*
- * MODMESH_PROFILE defined: Enable profiling API.
+ * Time the enclosing scope when profiling is enabled for the name at run
+ * time.  While no scope is enabled, this is one relaxed load of a global flag
+ * and a branch.  Otherwise the scope ID is looked up once per call site.
  */
-#ifdef MODMESH_PROFILE
-
 #define MODMESH_TIME(NAME) \
-    ScopedTimer local_scoped_timer_ ## __LINE__(NAME);
+    modmesh::ScopedTimer MODMESH_CONCAT(local_scoped_timer_, __LINE__) \
+    ( \
+        modmesh::TimeRegistry::active() \
+      ? []() { static const size_t local_scope_id = modmesh::TimeRegistry::me().id(NAME); return local_scope_id; }() \
+      : modmesh::ScopedTimer::INACTIVE \
+    );
 
 /*
- * No MODMESH_PROFILE defined: Disable profiling API.
+ * Same as MODMESH_TIME but also declare the bytes the scope moves.
  */
-#else // MODMESH_PROFILE
+#define MODMESH_TIME_BYTES(NAME, NBYTE) \
+    MODMESH_TIME(NAME) \
+    MODMESH_CONCAT(local_scoped_timer_, __LINE__).add_bytes(NBYTE);
 
-#define MODMESH_TIME(NAME)
-
-#endif // MODMESH_PROFILE
 /*
- * End MODMESH_PROFILE.
+ * MODMESH_PROFILE defined: Profiling is enabled at startup.
  */
+#ifdef MODMESH_PROFILE
+#define MODMESH_PROFILE_ENABLED true
+#else // MODMESH_PROFILE
+#define MODMESH_PROFILE_ENABLED false
+#endif // MODMESH_PROFILE
 
 namespace modmesh
 {
 
-#if __APPLE__
-
-#include <assert.h>
-#include <CoreServices/CoreServices.h>
-#include <mach/mach.h>
-#include <mach/mach_time.h>
+/**
+ * Source of the time stamps used by the profiler.
+ */
+enum class ClockSource
+{
+    /// Invariant time-stamp counter of x86 processors.
+    TSC,
+    /// Wall-clock time that does not jump.
+    MONOTONIC,
+    /// CPU time of the calling thread.
+    THREAD_CPU,
+    /// CPU time summed over all threads of the process.
+    PROCESS_CPU,
+}; /* end enum class ClockSource */
 
-struct StopWatch
+/**
+ * Process-wide clock reading ticks from the chosen source.  The source is
+ * taken from the environment variable MODMESH_CLOCK (tsc, monotonic,
+ * thread_cpu, or process_cpu) and defaults to the TSC when it is invariant.
+ * A value that is unknown or names an unavailable TSC falls back to
+ * monotonic with a warning, since the clock is first used by whatever timed
+ * scope runs first.  The TSC is calibrated against CLOCK_MONOTONIC once, when
+ * first selected.
+ *
+ * Ticks from different sources do not mix, so switch the source only when
+ * nothing is being timed.
+ */
+class Clock
 {
 
-    StopWatch()
+public:
+
+    static Clock & me()
+    {
+        static Clock inst;
+        return inst;
+    }
+
+    Clock(Clock const & ) = delete;
+    Clock(Clock       &&) = delete;
+    Clock & operator=(Clock const & ) = delete;
+    Clock & operator=(Clock       &&) = delete;
+    ~Clock() = default;
+
+    static bool has_invariant_tsc()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) { return false; }
+        __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+        return edx & (1u << 8);
+#else
+        return false;
+#endif
+    }
+
+    static char const * name(ClockSource source)
+    {
+        switch (source)
+        {
+        case ClockSource::TSC: return "tsc";
+        case ClockSource::MONOTONIC: return "monotonic";
+        case ClockSource::THREAD_CPU: return "thread_cpu";
+        default: return "process_cpu";
+        }
+    }
+
+    static ClockSource from_name(std::string const & name)
+    {
+        for (ClockSource source : {ClockSource::TSC, ClockSource::MONOTONIC, ClockSource::THREAD_CPU, ClockSource::PROCESS_CPU})
+        {
+            if (name == Clock::name(source)) { return source; }
+        }
+        MODMESH_EXCEPT(Clock, std::invalid_argument, "unknown clock source");
+    }
+
+    ClockSource source() const { return m_source.load(std::memory_order_acquire); }
+
+    void set_source(ClockSource source)
     {
-        mach_timebase_info(&m_tbinfo);
-        lap();
+        if (ClockSource::TSC == source)
+        {
+            if (!has_invariant_tsc())
+            {
+                MODMESH_EXCEPT(Clock, std::runtime_error, "invariant TSC not available");
+            }
+            calibrate();
+        }
+        m_source.store(source, std::memory_order_release);
     }
 
+    /// Number of ticks per second of the current source.
+    double frequency() const
+    {
+        return ClockSource::TSC == source() ? m_tsc_frequency.load(std::memory_order_relaxed) : 1.e9;
+    }
+
+    uint64_t now() const noexcept
+    {
+        switch (m_source.load(std::memory_order_relaxed))
+        {
+#if defined(__x86_64__) || defined(__i386__)
+        case ClockSource::TSC: { unsigned int aux; return __rdtscp(&aux); }
+#endif
+        case ClockSource::THREAD_CPU: return read(CLOCK_THREAD_CPUTIME_ID);
+        case ClockSource::PROCESS_CPU: return read(CLOCK_PROCESS_CPUTIME_ID);
+        default: return read(CLOCK_MONOTONIC);
+        }
+    }
+
+    double seconds(uint64_t ticks) const
+    {
+        return ClockSource::TSC == source() ? ticks * m_tsc_period.load(std::memory_order_relaxed) : ticks * 1.e-9;
+    }
+
+    /// Nanoseconds of CLOCK_MONOTONIC, whatever the source is.
+    static uint64_t monotonic() noexcept { return read(CLOCK_MONOTONIC); }
+
+private:
+
+    Clock()
+    {
+        char const * env = std::getenv("MODMESH_CLOCK");
+        if (env && '\0' != env[0])
+        {
+            try { set_source(from_name(env)); }
+            catch (std::exception const & e)
+            {
+                std::cerr << "modmesh: MODMESH_CLOCK=" << env << " ignored (" << e.what() << "); using monotonic" << std::endl;
+            }
+        }
+        else if (has_invariant_tsc())
+        {
+            set_source(ClockSource::TSC);
+        }
+    }
+
+    static uint64_t read(clockid_t id) noexcept
+    {
+        timespec ts;
+        clock_gettime(id, &ts);
+        return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    void calibrate()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_tsc_frequency.load(std::memory_order_relaxed) > 0) { return; }
+        // Spin for 10 milliseconds and compare the counts.
+        unsigned int aux;
+        const uint64_t ns0 = read(CLOCK_MONOTONIC);
+        const uint64_t tsc0 = __rdtscp(&aux);
+        uint64_t ns1;
+        do { ns1 = read(CLOCK_MONOTONIC); } while (ns1 - ns0 < 10000000);
+        const uint64_t tsc1 = __rdtscp(&aux);
+        const double frequency = double(tsc1 - tsc0) / (ns1 - ns0) * 1.e9;
+        m_tsc_period.store(1.0 / frequency, std::memory_order_relaxed);
+        m_tsc_frequency.store(frequency, std::memory_order_relaxed);
+#endif
+    }
+
+    std::atomic<ClockSource> m_source{ClockSource::MONOTONIC};
+    std::mutex m_mutex;
+    // Written by calibrate() before the source is published, and read on
+    // any thread.
+    std::atomic<double> m_tsc_frequency{0.0};
+    std::atomic<double> m_tsc_period{0.0};
+
+}; /* end class Clock */
+
+struct StopWatch
+{
+
+    StopWatch() { lap(); }
+
+    /// Seconds since the last lap.
     double lap()
     {
         m_start = m_end;
-        m_end = mach_absolute_time();
-        uint64_t elapsed = m_end - m_start;
-        return elapsed * m_tbinfo.numer / m_tbinfo.denom * 1.e-9;
+        m_end = Clock::me().now();
+        return Clock::me().seconds(m_end - m_start);
     }
 
     /// A global singleton.
@@ -61,69 +264,526 @@ struct StopWatch
         return instance;
     }
 
-    mach_timebase_info_data_t m_tbinfo;
     uint64_t m_start = 0;
     uint64_t m_end = 0;
 
 }; /* end struct StopWatch */
 
-#elif __linux__
+/**
+ * Hardware event counters of the calling thread, opened as one
+ * perf_event_open group so that a single read() gets all of them.  Events
+ * the kernel or the processor does not support are left out, and without
+ * permission nothing is opened; see /proc/sys/kernel/perf_event_paranoid.
+ */
+class PerfCounter
+{
 
-#include <time.h>
+public:
 
-struct StopWatch
-{
-    StopWatch()
+    enum Event
     {
-        clock_getres(CLOCK_PROCESS_CPUTIME_ID, &m_res);
-        lap();
+        CYCLES = 0,
+        INSTRUCTIONS,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        NEVENT,
+    }; /* end enum Event */
+
+    using value_array = std::array<uint64_t, NEVENT>;
+
+    static char const * name(size_t event)
+    {
+        constexpr char const * names[] = {"cycles", "instructions", "LLC misses", "branch misses"};
+        return names[event];
     }
 
-    double lap()
+    PerfCounter() { m_fd.fill(-1); }
+    PerfCounter(PerfCounter const & ) = delete;
+    PerfCounter(PerfCounter       &&) = delete;
+    PerfCounter & operator=(PerfCounter const & ) = delete;
+    PerfCounter & operator=(PerfCounter       &&) = delete;
+
+    ~PerfCounter()
     {
-        m_start = m_end;
-        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &m_end);
-        return diff(m_start, m_end) * 1.e-9;
+#ifdef __linux__
+        for (int fd : m_fd) { if (fd >= 0) { close(fd); } }
+#endif
     }
 
-    int64_t diff(timespec const & t1, timespec const & t2)
+    /// Bit mask of the opened events; open them on the first call.
+    unsigned open()
     {
-        timespec temp;
-        int64_t nsec;
-        if ((t2.tv_nsec - t1.tv_nsec)<0)
+        if (m_tried) { return m_mask; }
+        m_tried = true;
+#ifdef __linux__
+        constexpr uint64_t configs[] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+        };
+        int leader = -1;
+        for (size_t it=0; it<NEVENT; ++it)
         {
-            nsec = 1000000000 + t2.tv_nsec - t1.tv_nsec;
-            nsec += 1000000000 * (t2.tv_sec - t1.tv_sec - 1);
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[it];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            const int fd = int(syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fd < 0) { continue; }
+            if (leader < 0) { leader = fd; }
+            m_fd[it] = fd;
+            m_index[it] = m_nopen++;
+            m_mask |= 1u << it;
         }
-        else
+        m_leader = leader;
+#endif
+        return m_mask;
+    }
+
+    /// Read the opened events; the others are left untouched.
+    bool read(value_array & values) const
+    {
+#ifdef __linux__
+        if (m_leader < 0) { return false; }
+        std::array<uint64_t, NEVENT+1> buf;
+        if (::read(m_leader, buf.data(), sizeof(uint64_t)*(m_nopen+1)) <= 0) { return false; }
+        for (size_t it=0; it<NEVENT; ++it)
         {
-            nsec = t2.tv_nsec - t1.tv_nsec;
-            nsec += 1000000000 * (t2.tv_sec - t1.tv_sec);
+            if (m_fd[it] >= 0) { values[it] = buf[1+m_index[it]]; }
         }
-        return nsec;
+        return true;
+#else
+        (void)values;
+        return false;
+#endif
     }
 
-    /// A global singleton.
-    static StopWatch & me()
+private:
+
+    bool m_tried = false;
+    unsigned m_mask = 0;
+    int m_leader = -1;
+    size_t m_nopen = 0;
+    std::array<int, NEVENT> m_fd;
+    std::array<size_t, NEVENT> m_index{};
+
+}; /* end class PerfCounter */
+
+/**
+ * Histogram of durations in nanoseconds with logarithmic buckets, in the
+ * manner of HDR histograms.  Every power of 2 above SUB_BUCKET is split into
+ * SUB_BUCKET linear buckets, so that a bucket is never wider than 1/SUB_BUCKET
+ * of its lower bound, and the memory is fixed.  Durations longer than
+ * 2^MAX_BITS nanoseconds (about 3 days) go to the last bucket.
+ */
+class LatencyHistogram
+{
+
+public:
+
+    static constexpr size_t SUB_BITS = 3;
+    static constexpr size_t SUB_BUCKET = size_t(1) << SUB_BITS;
+    static constexpr size_t MAX_BITS = 48;
+    static constexpr size_t NBUCKET = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKET;
+
+    static size_t bucket(uint64_t ns)
     {
-        static StopWatch instance;
-        return instance;
+        if (ns < SUB_BUCKET) { return size_t(ns); }
+        ns = std::min(ns, (uint64_t(1) << MAX_BITS) - 1);
+        const size_t exp = 63 - size_t(__builtin_clzll(ns));
+        return (exp - SUB_BITS + 1) * SUB_BUCKET + size_t(ns >> (exp - SUB_BITS)) - SUB_BUCKET;
+    }
+
+    /// Smallest duration in the bucket.
+    static uint64_t lower(size_t ibucket)
+    {
+        if (ibucket < SUB_BUCKET) { return ibucket; }
+        const size_t exp = ibucket / SUB_BUCKET + SUB_BITS - 1;
+        return uint64_t(ibucket % SUB_BUCKET + SUB_BUCKET) << (exp - SUB_BITS);
     }
 
-    timespec m_res;
-    timespec m_start;
-    timespec m_end;
+    void add(size_t ibucket, uint64_t count) { m_bucket[ibucket] += count; }
 
-}; /* end struct StopWatch */
+    void add_range(uint64_t min, uint64_t max)
+    {
+        m_min = std::min(m_min, min);
+        m_max = std::max(m_max, max);
+    }
 
-#endif
+    void merge(LatencyHistogram const & other)
+    {
+        for (size_t it=0; it<NBUCKET; ++it) { m_bucket[it] += other.m_bucket[it]; }
+        add_range(other.m_min, other.m_max);
+    }
+
+    uint64_t operator[](size_t ibucket) const { return m_bucket[ibucket]; }
+
+    uint64_t count() const
+    {
+        uint64_t ret = 0;
+        for (uint64_t val : m_bucket) { ret += val; }
+        return ret;
+    }
+
+    /// Exact minimum and maximum; 0 when empty.
+    uint64_t min() const { return m_min > m_max ? 0 : m_min; }
+    uint64_t max() const { return m_max; }
+
+    /// Duration below which the fraction q of the records fall, estimated by
+    /// the middle of the bucket and bounded by the exact extrema.
+    uint64_t percentile(double q) const
+    {
+        const uint64_t total = count();
+        if (0 == total) { return 0; }
+        const uint64_t rank = std::max(uint64_t(std::ceil(q * double(total))), uint64_t(1));
+        uint64_t sum = 0;
+        size_t ibucket = 0;
+        for (; ibucket<NBUCKET-1; ++ibucket)
+        {
+            sum += m_bucket[ibucket];
+            if (sum >= rank) { break; }
+        }
+        const uint64_t mid = (lower(ibucket) + lower(ibucket+1) - 1) / 2;
+        return std::min(std::max(mid, min()), max());
+    }
+
+private:
+
+    std::array<uint64_t, NBUCKET> m_bucket{};
+    uint64_t m_min = UINT64_MAX;
+    uint64_t m_max = 0;
+
+}; /* end class LatencyHistogram */
 
 struct TimedEntry
 {
     size_t m_count = 0;
     double m_time = 0.0;
+    /// Bytes the scopes declare they move.
+    uint64_t m_bytes = 0;
+    /// Number of calls measured with the hardware counters.
+    size_t m_ncounted = 0;
+    PerfCounter::value_array m_event{};
+    LatencyHistogram m_latency;
 }; /* end struct TimedEntry */
 
+/**
+ * Tree of nested timed scopes.  A node is a scope reached through a chain of
+ * callers, and is created after its parent.
+ */
+class CallTree
+{
+
+public:
+
+    static constexpr size_t ROOT = SIZE_MAX;
+
+    struct Node
+    {
+        size_t m_id;
+        size_t m_parent;
+        size_t m_count = 0;
+        double m_inclusive = 0.0;
+        double m_child = 0.0;
+    }; /* end struct Node */
+
+    std::vector<Node> const & nodes() const { return m_node; }
+    Node       & operator[](size_t it)       { return m_node[it]; }
+    Node const & operator[](size_t it) const { return m_node[it]; }
+
+    /// Get the node of the scope called from the parent; create it if new.
+    size_t child(size_t parent, size_t id)
+    {
+        const std::pair<size_t, size_t> key(parent, id);
+        auto it = m_child.find(key);
+        if (it == m_child.end())
+        {
+            it = m_child.emplace(key, m_node.size()).first;
+            m_node.push_back({id, parent});
+        }
+        return it->second;
+    }
+
+    void merge(CallTree const & other)
+    {
+        std::vector<size_t> map(other.m_node.size());
+        for (size_t it=0; it<other.m_node.size(); ++it)
+        {
+            Node const & node = other.m_node[it];
+            map[it] = child(ROOT == node.m_parent ? ROOT : map[node.m_parent], node.m_id);
+            Node & mine = m_node[map[it]];
+            mine.m_count += node.m_count;
+            mine.m_inclusive += node.m_inclusive;
+            mine.m_child += node.m_child;
+        }
+    }
+
+    void report(std::ostream & ostm, std::vector<std::string> const & names) const
+    {
+        std::vector<std::vector<size_t>> children(m_node.size());
+        std::vector<size_t> roots;
+        for (size_t it=0; it<m_node.size(); ++it)
+        {
+            (ROOT == m_node[it].m_parent ? roots : children[m_node[it].m_parent]).push_back(it);
+        }
+        // Depth-first with an explicit stack of (node, depth).
+        std::vector<std::pair<size_t, size_t>> stack;
+        for (size_t it=roots.size(); it>0; --it) { stack.emplace_back(roots[it-1], 0); }
+        while (!stack.empty())
+        {
+            const size_t inode = stack.back().first;
+            const size_t depth = stack.back().second;
+            stack.pop_back();
+            Node const & node = m_node[inode];
+            ostm
+                << std::string(2*depth, ' ') << names[node.m_id] << " : "
+                << "count = " << node.m_count << " , "
+                << "inclusive = " << node.m_inclusive << " , "
+                << "exclusive = " << node.m_inclusive - node.m_child << " (second)"
+                << std::endl;
+            for (size_t it=children[inode].size(); it>0; --it) { stack.emplace_back(children[inode][it-1], depth+1); }
+        }
+    }
+
+private:
+
+    std::vector<Node> m_node;
+    std::map<std::pair<size_t, size_t>, size_t> m_child;
+
+}; /* end class CallTree */
+
+/**
+ * A complete timed scope for the timeline, in nanoseconds of
+ * CLOCK_MONOTONIC.  The source of Clock may change and may be per-thread
+ * CPU time, so the timeline does not use it.
+ */
+struct TraceEvent
+{
+    uint64_t m_start;
+    uint64_t m_stop;
+    size_t m_id;
+    size_t m_thread;
+}; /* end struct TraceEvent */
+
+/**
+ * Per-thread storage of timing entries, indexed by the scope ID.  Only the
+ * owning thread writes, so the slots are updated by relaxed atomic loads and
+ * stores without read-modify-write.  Other threads read them when reporting.
+ *
+ * The call tree and the trace events are kept only when enabled in the
+ * registry.  They are guarded by a mutex that only the reporter contends.
+ */
+class TimeShard
+{
+
+public:
+
+    static constexpr size_t BLOCK_SIZE = 64;
+    static constexpr size_t MAX_BLOCK = 1024;
+
+    TimeShard();
+    TimeShard(TimeShard const & ) = delete;
+    TimeShard(TimeShard       &&) = delete;
+    TimeShard & operator=(TimeShard const & ) = delete;
+    TimeShard & operator=(TimeShard       &&) = delete;
+    ~TimeShard();
+
+    size_t serial() const { return m_serial; }
+
+    /// Record a call.  The slot is cleared first if the registry was reset
+    /// since its last record, i.e., its generation is old.
+    void add(size_t id, double time, size_t generation)
+    {
+        Slot & slot = this->slot(id);
+        if (slot.m_generation.load(std::memory_order_relaxed) != generation) { slot.clear(generation); }
+        slot.m_count.store(slot.m_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        slot.m_time.store(slot.m_time.load(std::memory_order_relaxed) + time, std::memory_order_relaxed);
+
+        const uint64_t ns = uint64_t(time * 1.e9);
+        std::atomic<uint64_t> * bucket = slot.m_bucket.load(std::memory_order_relaxed);
+        if (!bucket)
+        {
+            bucket = new std::atomic<uint64_t>[LatencyHistogram::NBUCKET];
+            for (size_t it=0; it<LatencyHistogram::NBUCKET; ++it) { bucket[it].store(0, std::memory_order_relaxed); }
+            slot.m_bucket.store(bucket, std::memory_order_release);
+        }
+        std::atomic<uint64_t> & count = bucket[LatencyHistogram::bucket(ns)];
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (ns < slot.m_min.load(std::memory_order_relaxed)) { slot.m_min.store(ns, std::memory_order_relaxed); }
+        if (ns > slot.m_max.load(std::memory_order_relaxed)) { slot.m_max.store(ns, std::memory_order_relaxed); }
+    }
+
+    void add_bytes(size_t id, uint64_t bytes)
+    {
+        Slot & slot = this->slot(id);
+        slot.m_bytes.store(slot.m_bytes.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+    }
+
+    void add_events(size_t id, PerfCounter::value_array const & delta)
+    {
+        Slot & slot = this->slot(id);
+        slot.m_ncounted.store(slot.m_ncounted.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        for (size_t it=0; it<PerfCounter::NEVENT; ++it)
+        {
+            slot.m_event[it].store(slot.m_event[it].load(std::memory_order_relaxed) + delta[it], std::memory_order_relaxed);
+        }
+    }
+
+    PerfCounter & counter() { return m_counter; }
+
+    /// Add the entries of the generation to the vector, which is resized
+    /// when too short.
+    void collect(std::vector<TimedEntry> & entries, size_t generation) const
+    {
+        for (size_t ib=0; ib<MAX_BLOCK; ++ib)
+        {
+            Slot const * block = m_block[ib].load(std::memory_order_acquire);
+            if (!block) { continue; }
+            if (entries.size() < (ib+1)*BLOCK_SIZE) { entries.resize((ib+1)*BLOCK_SIZE); }
+            for (size_t it=0; it<BLOCK_SIZE; ++it)
+            {
+                TimedEntry & entry = entries[ib*BLOCK_SIZE+it];
+                Slot const & slot = block[it];
+                if (slot.m_generation.load(std::memory_order_acquire) != generation) { continue; }
+                entry.m_count += slot.m_count.load(std::memory_order_relaxed);
+                entry.m_time += slot.m_time.load(std::memory_order_relaxed);
+                entry.m_bytes += slot.m_bytes.load(std::memory_order_relaxed);
+                entry.m_ncounted += slot.m_ncounted.load(std::memory_order_relaxed);
+                for (size_t ie=0; ie<PerfCounter::NEVENT; ++ie)
+                {
+                    entry.m_event[ie] += slot.m_event[ie].load(std::memory_order_relaxed);
+                }
+                std::atomic<uint64_t> const * bucket = slot.m_bucket.load(std::memory_order_acquire);
+                if (bucket)
+                {
+                    for (size_t ih=0; ih<LatencyHistogram::NBUCKET; ++ih)
+                    {
+                        entry.m_latency.add(ih, bucket[ih].load(std::memory_order_relaxed));
+                    }
+                }
+                entry.m_latency.add_range(slot.m_min.load(std::memory_order_relaxed), slot.m_max.load(std::memory_order_relaxed));
+            }
+        }
+    }
+
+    /// Push the scope on the stack of the call tree.
+    void enter(size_t id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stack.push_back(m_tree.child(m_stack.empty() ? CallTree::ROOT : m_stack.back(), id));
+    }
+
+    /// Pop the scope entered last and record it.
+    void leave(size_t id, uint64_t start, uint64_t stop, double time, bool trace, size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_stack.empty())
+        {
+            CallTree::Node & node = m_tree[m_stack.back()];
+            ++node.m_count;
+            node.m_inclusive += time;
+            m_stack.pop_back();
+            if (!m_stack.empty()) { m_tree[m_stack.back()].m_child += time; }
+        }
+        if (trace && capacity)
+        {
+            if (m_event.size() != capacity)
+            {
+                m_event.assign(capacity, TraceEvent());
+                m_nevent = 0;
+            }
+            m_event[m_nevent % capacity] = {start, stop, id, m_serial};
+            ++m_nevent;
+        }
+    }
+
+    void collect_tree(CallTree & tree) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        tree.merge(m_tree);
+    }
+
+    /// Append the kept events, oldest first.
+    void collect_events(std::vector<TraceEvent> & events) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const size_t begin = m_nevent > m_event.size() ? m_nevent - m_event.size() : 0;
+        for (size_t it=begin; it<m_nevent; ++it) { events.push_back(m_event[it % m_event.size()]); }
+    }
+
+private:
+
+    struct Slot
+    {
+        std::atomic<size_t> m_count{0};
+        std::atomic<double> m_time{0.0};
+        std::atomic<uint64_t> m_bytes{0};
+        std::atomic<size_t> m_ncounted{0};
+        std::array<std::atomic<uint64_t>, PerfCounter::NEVENT> m_event{};
+        std::atomic<uint64_t> m_min{UINT64_MAX};
+        std::atomic<uint64_t> m_max{0};
+        // Buckets of LatencyHistogram, allocated on the first record.
+        std::atomic<std::atomic<uint64_t> *> m_bucket{nullptr};
+        std::atomic<size_t> m_generation{0};
+
+        ~Slot() { delete[] m_bucket.load(std::memory_order_relaxed); }
+
+        /// Zero the data and then publish the generation.
+        void clear(size_t generation)
+        {
+            m_count.store(0, std::memory_order_relaxed);
+            m_time.store(0.0, std::memory_order_relaxed);
+            m_bytes.store(0, std::memory_order_relaxed);
+            m_ncounted.store(0, std::memory_order_relaxed);
+            for (std::atomic<uint64_t> & val : m_event) { val.store(0, std::memory_order_relaxed); }
+            m_min.store(UINT64_MAX, std::memory_order_relaxed);
+            m_max.store(0, std::memory_order_relaxed);
+            std::atomic<uint64_t> * bucket = m_bucket.load(std::memory_order_relaxed);
+            if (bucket)
+            {
+                for (size_t it=0; it<LatencyHistogram::NBUCKET; ++it) { bucket[it].store(0, std::memory_order_relaxed); }
+            }
+            m_generation.store(generation, std::memory_order_release);
+        }
+    }; /* end struct Slot */
+
+    Slot & slot(size_t id)
+    {
+        std::atomic<Slot *> & entry = m_block[id / BLOCK_SIZE];
+        Slot * block = entry.load(std::memory_order_relaxed);
+        if (!block)
+        {
+            block = new Slot[BLOCK_SIZE];
+            entry.store(block, std::memory_order_release);
+        }
+        return block[id % BLOCK_SIZE];
+    }
+
+    std::array<std::atomic<Slot *>, MAX_BLOCK> m_block;
+    size_t m_serial = 0;
+    PerfCounter m_counter;
+
+    mutable std::mutex m_mutex;
+    CallTree m_tree;
+    std::vector<size_t> m_stack;
+    // Ring buffer of trace events.
+    std::vector<TraceEvent> m_event;
+    size_t m_nevent = 0;
+
+}; /* end class TimeShard */
+
+/**
+ * Registry of timed scopes.  A scope is registered by name once, usually per
+ * call site, for an ID used by the following calls.  The time is recorded in
+ * the shard of the calling thread, and the shards are merged by report().
+ *
+ * Optionally, the nesting of the scopes is recorded in per-thread call trees
+ * for report_tree(), and the scopes are recorded as events in per-thread ring
+ * buffers for chrome_trace().
+ */
 class TimeRegistry
 {
 
@@ -135,31 +795,181 @@ public:
         return inst;
     }
 
+    static constexpr size_t MAX_SCOPE = TimeShard::BLOCK_SIZE * TimeShard::MAX_BLOCK;
+
+    /// Get the ID of the named scope; register it if new.
+    size_t id(const char * name)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_id.find(name);
+        if (it == m_id.end())
+        {
+            if (m_name.size() >= MAX_SCOPE)
+            {
+                MODMESH_EXCEPT(TimeRegistry, std::length_error, "too many scopes");
+            }
+            it = m_id.emplace(name, m_name.size()).first;
+            m_name.push_back(name);
+            m_enabled[it->second].store(m_default_enabled, std::memory_order_relaxed);
+        }
+        return it->second;
+    }
+
+    /// Whether any scope may be timed.  A plain global, so that MODMESH_TIME
+    /// checks it without the initialization guard of me().
+    static bool active() { return s_active.load(std::memory_order_relaxed); }
+
+    /// Whether the scope is timed.
+    bool enabled(size_t id) const { return m_enabled[id].load(std::memory_order_relaxed); }
+    bool enabled(const char * name) { return enabled(id(name)); }
+
+    /// Enable or disable all scopes, including those registered later.
+    void set_enabled(bool value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_default_enabled = value;
+        for (size_t it=0; it<m_name.size(); ++it) { m_enabled[it].store(value, std::memory_order_relaxed); }
+        update_active();
+    }
+
+    /// Enable or disable the named scope.
+    void set_enabled(const char * name, bool value)
+    {
+        const size_t sid = id(name);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_enabled[sid].store(value, std::memory_order_relaxed);
+        update_active();
+    }
+
+    /// Merged entries of the scopes called since the last reset, by name.
+    std::map<std::string, TimedEntry> snapshot(bool reset=false)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::map<std::string, TimedEntry> ret = collect_locked();
+        if (reset) { reset_locked(); }
+        return ret;
+    }
+
+    /// Discard the entries recorded so far.  The call trees and the trace
+    /// events are kept.
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        reset_locked();
+    }
+
     std::string report() const
     {
+        const unsigned mask = counter_mask();
+        std::map<std::string, TimedEntry> entries;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            entries = collect_locked();
+        }
         std::ostringstream ostm;
-        for (auto it = m_entry.begin() ; it != m_entry.end() ; ++it)
+        for (auto const & item : entries)
         {
+            TimedEntry const & entry = item.second;
+            LatencyHistogram const & latency = entry.m_latency;
             ostm
-                << it->first << " : "
-                << "count = " << it->second.m_count << " , "
-                << "time = " << it->second.m_time << " (second)"
-                << std::endl;
+                << item.first << " : "
+                << "count = " << entry.m_count << " , "
+                << "time = " << entry.m_time << " (second)"
+                << " , min = " << latency.min() * 1.e-9
+                << " , p50 = " << latency.percentile(0.5) * 1.e-9
+                << " , p99 = " << latency.percentile(0.99) * 1.e-9
+                << " , max = " << latency.max() * 1.e-9;
+            if (entry.m_bytes && entry.m_time > 0)
+            {
+                ostm << " , " << entry.m_bytes / entry.m_time * 1.e-9 << " GB/s";
+            }
+            if (entry.m_ncounted)
+            {
+                for (size_t it=0; it<PerfCounter::NEVENT; ++it)
+                {
+                    if (mask & (1u << it)) { ostm << " , " << PerfCounter::name(it) << " = " << entry.m_event[it]; }
+                }
+                constexpr unsigned ipc_mask = (1u << PerfCounter::CYCLES) | (1u << PerfCounter::INSTRUCTIONS);
+                if (ipc_mask == (mask & ipc_mask) && entry.m_event[PerfCounter::CYCLES])
+                {
+                    ostm << " , IPC = " << double(entry.m_event[PerfCounter::INSTRUCTIONS]) / entry.m_event[PerfCounter::CYCLES];
+                }
+                if (mask & (1u << PerfCounter::LLC_MISSES))
+                {
+                    // Every miss fills a 64-byte line from memory.
+                    ostm << " , LLC fill = " << entry.m_event[PerfCounter::LLC_MISSES] * 64 / entry.m_time * 1.e-9 << " GB/s";
+                }
+            }
+            ostm << std::endl;
         }
         return ostm.str();
     }
 
-    void add(const char * name, double time)
+    /// Report the call tree merged over the threads, with inclusive and
+    /// exclusive time.
+    std::string report_tree() const
     {
-        auto it = m_entry.find(name);
-        if (it == m_entry.end())
+        CallTree tree;
+        std::vector<std::string> names;
         {
-            it = std::get<0>(m_entry.insert({name, {0, 0.0}}));
+            std::lock_guard<std::mutex> lock(m_mutex);
+            tree.merge(m_retired_tree);
+            for (TimeShard const * shard : m_shard) { shard->collect_tree(tree); }
+            names = m_name;
         }
-        ++(it->second.m_count);
-        it->second.m_time += time;
+        std::ostringstream ostm;
+        tree.report(ostm, names);
+        return ostm.str();
+    }
+
+    /// Export the kept events in the Chrome trace-event JSON format.
+    std::string chrome_trace() const
+    {
+        std::vector<TraceEvent> events;
+        std::vector<std::string> names;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            events = m_retired_event;
+            for (TimeShard const * shard : m_shard) { shard->collect_events(events); }
+            names = m_name;
+        }
+        std::ostringstream ostm;
+        ostm.precision(3);
+        ostm << std::fixed << "{\"traceEvents\":[";
+        for (size_t it=0; it<events.size(); ++it)
+        {
+            TraceEvent const & event = events[it];
+            ostm
+                << (it ? ",\n" : "\n")
+                << "{\"name\":\"" << escape(names[event.m_id]) << "\",\"ph\":\"X\""
+                << ",\"ts\":" << (event.m_start - m_epoch) * 1.e-3
+                << ",\"dur\":" << (event.m_stop - event.m_start) * 1.e-3
+                << ",\"pid\":0,\"tid\":" << event.m_thread << "}";
+        }
+        ostm << "\n],\"displayTimeUnit\":\"ns\"}\n";
+        return ostm.str();
     }
 
+    /// Whether the timed scopes also read the hardware counters.
+    bool counters() const { return m_counters.load(std::memory_order_relaxed); }
+    void set_counters(bool value) { m_counters.store(value, std::memory_order_relaxed); }
+
+    /// Bit mask of the PerfCounter events opened by any thread.
+    unsigned counter_mask() const { return m_counter_mask.load(std::memory_order_relaxed); }
+
+    bool call_tree() const { return m_call_tree.load(std::memory_order_relaxed); }
+    void set_call_tree(bool value) { m_call_tree.store(value, std::memory_order_relaxed); }
+
+    bool trace() const { return m_trace.load(std::memory_order_relaxed); }
+    void set_trace(bool value) { m_trace.store(value, std::memory_order_relaxed); }
+
+    /// Number of events kept per thread.
+    size_t trace_capacity() const { return m_trace_capacity.load(std::memory_order_relaxed); }
+    void set_trace_capacity(size_t value) { m_trace_capacity.store(value, std::memory_order_relaxed); }
+
+    void add(size_t id, double time) { shard().add(id, time, m_generation.load(std::memory_order_relaxed)); }
+    void add(const char * name, double time) { add(id(name), time); }
+
     ~TimeRegistry()
     {
         // Uncomment for debugging.
@@ -168,30 +978,211 @@ public:
 
 private:
 
-    TimeRegistry() = default;
+    friend TimeShard;
+    friend struct ScopedTimer;
+
+    static TimeShard & shard()
+    {
+        thread_local TimeShard inst;
+        return inst;
+    }
+
+    static std::string escape(std::string const & str)
+    {
+        std::string ret;
+        for (char chr : str)
+        {
+            if ('"' == chr || '\\' == chr) { ret += '\\'; }
+            ret += chr;
+        }
+        return ret;
+    }
+
+    std::map<std::string, TimedEntry> collect_locked() const
+    {
+        std::vector<TimedEntry> entries = m_retired;
+        const size_t generation = m_generation.load(std::memory_order_relaxed);
+        for (TimeShard const * shard : m_shard) { shard->collect(entries, generation); }
+        std::map<std::string, TimedEntry> ret;
+        for (auto const & item : m_id)
+        {
+            if (item.second < entries.size() && entries[item.second].m_count)
+            {
+                ret.emplace(item.first, entries[item.second]);
+            }
+        }
+        return ret;
+    }
+
+    void reset_locked()
+    {
+        m_retired.clear();
+        m_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t attach(TimeShard * shard)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shard.push_back(shard);
+        return m_nshard++;
+    }
+
+    /// Keep the entries of an exiting thread.
+    void detach(TimeShard * shard)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        shard->collect(m_retired, m_generation.load(std::memory_order_relaxed));
+        shard->collect_tree(m_retired_tree);
+        shard->collect_events(m_retired_event);
+        const size_t capacity = trace_capacity();
+        if (m_retired_event.size() > capacity)
+        {
+            m_retired_event.erase(m_retired_event.begin(), m_retired_event.end() - capacity);
+        }
+        m_shard.erase(std::find(m_shard.begin(), m_shard.end(), shard));
+    }
+
+    // Called with the mutex held.
+    void update_active()
+    {
+        bool value = m_default_enabled;
+        for (size_t it=0; it<m_name.size() && !value; ++it) { value = m_enabled[it].load(std::memory_order_relaxed); }
+        s_active.store(value, std::memory_order_relaxed);
+    }
+
+    TimeRegistry()
+      : m_enabled(new std::atomic<bool>[MAX_SCOPE])
+      , m_default_enabled(MODMESH_PROFILE_ENABLED)
+      , m_epoch(Clock::monotonic())
+    {
+        for (size_t it=0; it<MAX_SCOPE; ++it) { m_enabled[it].store(false, std::memory_order_relaxed); }
+    }
     TimeRegistry(TimeRegistry const & ) = delete;
     TimeRegistry(TimeRegistry       &&) = delete;
     TimeRegistry & operator=(TimeRegistry const & ) = delete;
     TimeRegistry & operator=(TimeRegistry       &&) = delete;
 
-    std::map<const char *, TimedEntry> m_entry;
+    mutable std::mutex m_mutex;
+    std::map<std::string, size_t> m_id;
+    std::vector<std::string> m_name;
+    std::vector<TimeShard *> m_shard;
+    size_t m_nshard = 0;
+    std::unique_ptr<std::atomic<bool>[]> m_enabled;
+    bool m_default_enabled;
+    static inline std::atomic<bool> s_active{MODMESH_PROFILE_ENABLED};
+    std::vector<TimedEntry> m_retired;
+    // Incremented by reset() to discard the entries in the shards.
+    std::atomic<size_t> m_generation{0};
+    CallTree m_retired_tree;
+    std::vector<TraceEvent> m_retired_event;
+
+    std::atomic<bool> m_counters{false};
+    std::atomic<unsigned> m_counter_mask{0};
+    std::atomic<bool> m_call_tree{false};
+    std::atomic<bool> m_trace{false};
+    std::atomic<size_t> m_trace_capacity{1 << 16};
+    // Origin of the timeline in nanoseconds of CLOCK_MONOTONIC.
+    uint64_t m_epoch;
 
 }; /* end struct TimeRegistry */
 
+inline TimeShard::TimeShard()
+{
+    for (std::atomic<Slot *> & block : m_block) { block.store(nullptr, std::memory_order_relaxed); }
+    m_serial = TimeRegistry::me().attach(this);
+}
+
+inline TimeShard::~TimeShard()
+{
+    TimeRegistry::me().detach(this);
+    for (std::atomic<Slot *> & block : m_block) { delete[] block.load(std::memory_order_relaxed); }
+}
+
 struct ScopedTimer
 {
 
     ScopedTimer() = delete;
+    ScopedTimer(ScopedTimer const & ) = delete;
+    ScopedTimer(ScopedTimer       &&) = delete;
+    ScopedTimer & operator=(ScopedTimer const & ) = delete;
+    ScopedTimer & operator=(ScopedTimer       &&) = delete;
+
+    /// ID of a scope that is not timed.
+    static constexpr size_t INACTIVE = size_t(-1);
 
-    ScopedTimer(const char * name) : m_name(name) {}
+    // Only the checks are inlined; start() and stop() are kept out of line,
+    // so that an untimed scope costs a branch and little code.
+    ScopedTimer(size_t id) : m_id(id)
+    {
+        if (INACTIVE != id) { start(); }
+    }
 
     ~ScopedTimer()
     {
-        TimeRegistry::me().add(m_name, m_sw.lap());
+        if (m_active) { stop(); }
+    }
+
+    /// Declare the bytes the scope moves, for the throughput in the report.
+    void add_bytes(uint64_t bytes) { m_bytes += bytes; }
+
+    MODMESH_NOINLINE void start()
+    {
+        TimeRegistry & registry = TimeRegistry::me();
+        m_active = registry.enabled(m_id);
+        if (!m_active) { return; }
+        m_trace = registry.trace();
+        if (m_trace || registry.call_tree())
+        {
+            m_shard = &TimeRegistry::shard();
+            m_shard->enter(m_id);
+        }
+        if (registry.counters())
+        {
+            PerfCounter & counter = TimeRegistry::shard().counter();
+            const unsigned mask = counter.open();
+            if (mask && (registry.m_counter_mask.load(std::memory_order_relaxed) & mask) != mask)
+            {
+                registry.m_counter_mask.fetch_or(mask, std::memory_order_relaxed);
+            }
+            m_counted = counter.read(m_event);
+        }
+        if (m_trace) { m_trace_start = Clock::monotonic(); }
+        m_start = Clock::me().now();
+    }
+
+    MODMESH_NOINLINE void stop()
+    {
+        Clock const & clock = Clock::me();
+        const uint64_t stop = clock.now();
+        const uint64_t trace_stop = m_trace ? Clock::monotonic() : 0;
+        const double time = clock.seconds(stop - m_start);
+        TimeRegistry & registry = TimeRegistry::me();
+        TimeShard & shard = TimeRegistry::shard();
+        PerfCounter::value_array event = m_event;
+        const bool counted = m_counted && shard.counter().read(event);
+        // Add the time first, which clears the slot after a reset.
+        registry.add(m_id, time);
+        if (counted)
+        {
+            for (size_t it=0; it<PerfCounter::NEVENT; ++it) { event[it] -= m_event[it]; }
+            shard.add_events(m_id, event);
+        }
+        if (m_bytes) { shard.add_bytes(m_id, m_bytes); }
+        if (m_shard)
+        {
+            m_shard->leave(m_id, m_trace_start, trace_stop, time, m_trace, registry.trace_capacity());
+        }
     }
 
-    StopWatch m_sw;
-    char const * m_name;
+    size_t m_id;
+    bool m_active = false;
+    bool m_trace = false;
+    bool m_counted = false;
+    TimeShard * m_shard = nullptr;
+    uint64_t m_start;
+    uint64_t m_trace_start = 0;
+    uint64_t m_bytes = 0;
+    PerfCounter::value_array m_event{};
 
 }; /* end struct ScopedTimer */
 
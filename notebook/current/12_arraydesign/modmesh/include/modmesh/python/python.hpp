@@ -10,8 +10,15 @@
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
 #include <numpy/arrayobject.h>
 
+#include <pybind11/stl.h>
+
 #include "modmesh/modmesh.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
 #ifdef __GNUG__
 #  define MODMESH_PYTHON_WRAPPER_VISIBILITY __attribute__((visibility("hidden")))
 #else
@@ -90,6 +97,7 @@ public:
     DECL_MM_PYBIND_CLASS_METHOD(def_property)
     DECL_MM_PYBIND_CLASS_METHOD(def_property_readonly)
     DECL_MM_PYBIND_CLASS_METHOD(def_property_readonly_static)
+    DECL_MM_PYBIND_CLASS_METHOD(def_static)
 
 #undef DECL_MM_PYBIND_CLASS_METHOD
 
@@ -97,8 +105,9 @@ public:
 
 protected:
 
-    WrapBase(pybind11::module & mod)
-      : m_cls(mod, wrapper_type::PYNAME, wrapper_type::PYDOC)
+    template< class... Extra >
+    WrapBase(pybind11::module & mod, Extra&&... extra)
+      : m_cls(mod, wrapper_type::PYNAME, wrapper_type::PYDOC, std::forward<Extra>(extra)...)
     {
         static_assert
         (
@@ -118,6 +127,326 @@ private:
 
 }; /* end class WrapBase */
 
+class
+MODMESH_PYTHON_WRAPPER_VISIBILITY
+WrapConcreteBuffer
+  : public WrapBase< WrapConcreteBuffer, ConcreteBuffer, std::shared_ptr<ConcreteBuffer> >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "ConcreteBuffer";
+    static constexpr char PYDOC[] = "ConcreteBuffer";
+
+    friend root_base_type;
+
+protected:
+
+    WrapConcreteBuffer(pybind11::module & mod) : root_base_type(mod, pybind11::buffer_protocol())
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def
+            (
+                py::init
+                (
+                    [](size_t nbytes, std::string const & allocator)
+                    {
+                        return wrapped_type::construct(nbytes, BufferAllocator::from_name(allocator));
+                    }
+                )
+              , py::arg("nbytes"), py::arg("allocator")="aligned"
+            )
+            .def("clone", &wrapped_type::clone)
+            .def_property_readonly("nbytes", &wrapped_type::nbytes)
+            .def_property_readonly
+            (
+                "allocator"
+              , [](wrapped_type const & self) { return self.allocator().name(); }
+            )
+            .def("__len__", &wrapped_type::size)
+            .def
+            (
+                "__getitem__"
+              , [](wrapped_type const & self, size_t it) { return int8_t(self.at(it)); }
+            )
+            .def
+            (
+                "__setitem__"
+              , [](wrapped_type & self, size_t it, int8_t val) { self.at(it) = char(val); }
+            )
+            .def_buffer
+            (
+                [](wrapped_type & self)
+                {
+                    return py::buffer_info
+                    (
+                        self.data()
+                      , 1
+                      , py::format_descriptor<int8_t>::format()
+                      , 1
+                      , { self.nbytes() }
+                      , { 1 }
+                    );
+                }
+            )
+        ;
+
+    }
+
+}; /* end class WrapConcreteBuffer */
+
+/**
+ * SimpleArray of a type.  It exports the buffer protocol, so that
+ * numpy.asarray() views the memory without copying.
+ */
+template< typename Wrapper, typename T >
+class
+MODMESH_PYTHON_WRAPPER_VISIBILITY
+WrapSimpleArray
+  : public WrapBase< Wrapper, SimpleArray<T> >
+{
+
+public:
+
+    using base_type = WrapBase< Wrapper, SimpleArray<T> >;
+    using wrapped_type = typename base_type::wrapped_type;
+    using value_type = typename wrapped_type::value_type;
+    using shape_type = typename wrapped_type::shape_type;
+
+    friend typename base_type::root_base_type;
+
+protected:
+
+    static size_t offset(wrapped_type const & self, pybind11::object const & key)
+    {
+        namespace py = pybind11;
+        std::vector<size_t> idx;
+        if (py::isinstance<py::tuple>(key)) { idx = key.cast<std::vector<size_t>>(); }
+        else { idx.push_back(key.cast<size_t>()); }
+        if (idx.size() != self.ndim())
+        {
+            throw py::index_error("wrong number of indices");
+        }
+        size_t ret = 0;
+        for (size_t it=0; it<idx.size(); ++it)
+        {
+            if (idx[it] >= self.shape(it))
+            {
+                throw py::index_error("index out of range");
+            }
+            ret += idx[it] * self.stride(it);
+        }
+        return ret;
+    }
+
+    static std::vector<size_t> byte_stride(wrapped_type const & self)
+    {
+        std::vector<size_t> ret(self.stride());
+        for (size_t & val : ret) { val *= wrapped_type::ITEMSIZE; }
+        return ret;
+    }
+
+    using ndarray_type = pybind11::array_t<value_type, pybind11::array::c_style | pybind11::array::forcecast>;
+
+    /// Copy of a NumPy array.
+    static wrapped_type * from_ndarray(ndarray_type const & arr)
+    {
+        shape_type shape(arr.shape(), arr.shape() + arr.ndim());
+        wrapped_type * ret = new wrapped_type(shape);
+        if (ret->size()) { std::memcpy(ret->data(), arr.data(), ret->nbytes()); }
+        return ret;
+    }
+
+    WrapSimpleArray(pybind11::module & mod) : base_type(mod, pybind11::buffer_protocol())
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def
+            (
+                py::init
+                (
+                    [](py::object const & shape, std::string const & allocator)
+                    {
+                        // This overload takes any object and is tried first, so
+                        // it hands NumPy arrays to the copying constructor.
+                        if (py::isinstance<py::array>(shape)) { return from_ndarray(shape.cast<ndarray_type>()); }
+                        shape_type sv;
+                        if (py::isinstance<py::int_>(shape)) { sv.push_back(shape.cast<size_t>()); }
+                        else { sv = shape.cast<shape_type>(); }
+                        return new wrapped_type(sv, BufferAllocator::from_name(allocator));
+                    }
+                )
+              , py::arg("shape"), py::arg("allocator")="aligned"
+            )
+            .def(py::init(&from_ndarray), py::arg("array"))
+            .def_property_readonly("ndim", &wrapped_type::ndim)
+            .def_property_readonly
+            (
+                "shape"
+              , [](wrapped_type const & self) { return py::tuple(py::cast(self.shape())); }
+            )
+            .def_property_readonly
+            (
+                "stride"
+              , [](wrapped_type const & self) { return py::tuple(py::cast(self.stride())); }
+            )
+            .def_property_readonly("size", &wrapped_type::size)
+            .def_property_readonly("nbytes", &wrapped_type::nbytes)
+            .def_property_readonly_static("itemsize", [](py::object const &) { return wrapped_type::ITEMSIZE; })
+            .def_property_readonly("is_contiguous", &wrapped_type::is_contiguous)
+            .def_property_readonly("buffer", &wrapped_type::buffer)
+            .def_property_readonly
+            (
+                "allocator"
+              , [](wrapped_type const & self) { return self.buffer()->allocator().name(); }
+            )
+            .def
+            (
+                "__getitem__"
+              , [](wrapped_type const & self, py::object const & key) { return self.data()[offset(self, key)]; }
+            )
+            .def
+            (
+                "__setitem__"
+              , [](wrapped_type & self, py::object const & key, value_type val) { self.data()[offset(self, key)] = val; }
+            )
+            .def
+            (
+                "reshape"
+              , [](wrapped_type const & self, shape_type const & shape) { return self.reshape(shape); }
+              , py::arg("shape")
+            )
+            .def("fill", &wrapped_type::fill, py::arg("value"))
+            .def_property_readonly
+            (
+                "ndarray"
+              , [](wrapped_type & self)
+                {
+                    return py::array
+                    (
+                        py::dtype::of<value_type>()
+                      , self.shape()
+                      , byte_stride(self)
+                      , self.data()
+                      , py::cast(self)
+                    );
+                }
+            )
+            .def_buffer
+            (
+                [](wrapped_type & self)
+                {
+                    return py::buffer_info
+                    (
+                        self.data()
+                      , wrapped_type::ITEMSIZE
+                      , py::format_descriptor<value_type>::format()
+                      , ssize_t(self.ndim())
+                      , self.shape()
+                      , byte_stride(self)
+                    );
+                }
+            )
+        ;
+
+    }
+
+}; /* end class WrapSimpleArray */
+
+class WrapSimpleArrayFloat64
+  : public WrapSimpleArray< WrapSimpleArrayFloat64, double >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "SimpleArrayFloat64";
+    static constexpr char PYDOC[] = "SimpleArrayFloat64";
+
+    friend root_base_type;
+
+    using base_type = WrapSimpleArray< WrapSimpleArrayFloat64, double >;
+
+protected:
+
+    WrapSimpleArrayFloat64(pybind11::module & mod) : base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        // Parallel kernels; the arrays must be contiguous.  They release the
+        // GIL, so that KernelPool.run() tasks on other threads can take it.
+        (*this)
+            .def("scale", [](wrapped_type & self, double a) { kernel::scale(self, a); }, py::arg("a"), py::call_guard<py::gil_scoped_release>())
+            .def
+            (
+                "axpy"
+              , [](wrapped_type & self, double a, wrapped_type const & x) { kernel::axpy(self, x, a); }
+              , py::arg("a"), py::arg("x"), py::call_guard<py::gil_scoped_release>()
+            )
+            .def
+            (
+                "copy_from"
+              , [](wrapped_type & self, wrapped_type const & src) { kernel::copy(self, src); }
+              , py::arg("src"), py::call_guard<py::gil_scoped_release>()
+            )
+            .def("sum", [](wrapped_type const & self) { return kernel::sum(self); }, py::call_guard<py::gil_scoped_release>())
+            .def
+            (
+                "dot"
+              , [](wrapped_type const & self, wrapped_type const & other) { return kernel::dot(self, other); }
+              , py::arg("other"), py::call_guard<py::gil_scoped_release>()
+            )
+            .def("min", [](wrapped_type const & self) { return kernel::min(self); }, py::call_guard<py::gil_scoped_release>())
+            .def("max", [](wrapped_type const & self) { return kernel::max(self); }, py::call_guard<py::gil_scoped_release>())
+        ;
+
+    }
+
+}; /* end class WrapSimpleArrayFloat64 */
+
+class WrapSimpleArrayInt32
+  : public WrapSimpleArray< WrapSimpleArrayInt32, int32_t >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "SimpleArrayInt32";
+    static constexpr char PYDOC[] = "SimpleArrayInt32";
+
+    friend root_base_type;
+
+    using base_type = WrapSimpleArray< WrapSimpleArrayInt32, int32_t >;
+
+protected:
+
+    WrapSimpleArrayInt32(pybind11::module & mod) : base_type(mod) {}
+
+}; /* end class WrapSimpleArrayInt32 */
+
+class WrapSimpleArrayInt64
+  : public WrapSimpleArray< WrapSimpleArrayInt64, int64_t >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "SimpleArrayInt64";
+    static constexpr char PYDOC[] = "SimpleArrayInt64";
+
+    friend root_base_type;
+
+    using base_type = WrapSimpleArray< WrapSimpleArrayInt64, int64_t >;
+
+protected:
+
+    WrapSimpleArrayInt64(pybind11::module & mod) : base_type(mod) {}
+
+}; /* end class WrapSimpleArrayInt64 */
+
 template< typename Wrapper, typename GT >
 class
 MODMESH_PYTHON_WRAPPER_VISIBILITY
@@ -137,7 +466,8 @@ public:
 
 protected:
 
-    WrapStaticGridBase(pybind11::module & mod) : base_type(mod)
+    template< class... Extra >
+    WrapStaticGridBase(pybind11::module & mod, Extra&&... extra) : base_type(mod, std::forward<Extra>(extra)...)
     {
 
         namespace py = pybind11;
@@ -169,7 +499,28 @@ public:
 
 protected:
 
-    WrapStaticGrid1d(pybind11::module & mod) : base_type(mod)
+    static size_t wrap_index(wrapped_type const & self, ssize_t it)
+    {
+        // Count a negative index from the end, as Python does.
+        if (it < 0) { it += ssize_t(self.nx()); }
+        if (it < 0) { throw pybind11::index_error("index out of range"); }
+        return size_t(it);
+    }
+
+    /// View of the coordinates sharing the memory of the grid.
+    static pybind11::array coord_array(wrapped_type & self)
+    {
+        return pybind11::array
+        (
+            pybind11::detail::npy_format_descriptor<real_type>::dtype()
+          , { self.nx() }
+          , { sizeof(real_type) }
+          , self.coord()
+          , pybind11::cast(self)
+        );
+    }
+
+    WrapStaticGrid1d(pybind11::module & mod) : base_type(mod, pybind11::buffer_protocol())
     {
 
         namespace py = pybind11;
@@ -194,96 +545,1860 @@ protected:
             .def
             (
                 "__getitem__"
-              , [](wrapped_type const & self, size_t it) { return self.at(it); }
+              , [](wrapped_type const & self, ssize_t it) { return self.at(wrap_index(self, it)); }
+            )
+            .def
+            (
+                "__getitem__"
+              , [](wrapped_type & self, py::object const & key) -> py::object
+                {
+                    // A slice gives a view and an index array gives a copy.
+                    return coord_array(self)[key];
+                }
             )
             .def
             (
                 "__setitem__"
-              , [](wrapped_type & self, size_t it, wrapped_type::real_type val)
+              , [](wrapped_type & self, ssize_t it, wrapped_type::real_type val)
                 {
-                    self.at(it) = val;
+                    self.at(wrap_index(self, it)) = val;
                 }
             )
-            .def_property_readonly
+            .def
             (
-                "nx"
-              , [](wrapped_type const & self) { return self.nx(); }
+                "__setitem__"
+              , [](wrapped_type & self, py::object const & key, py::object const & val)
+                {
+                    coord_array(self).attr("__setitem__")(key, val);
+                }
             )
-            .def_property
+            .def_buffer
             (
-                "coord"
-              , [](wrapped_type & self)
+                [](wrapped_type & self)
                 {
-                    return py::array
+                    return py::buffer_info
                     (
-                        py::detail::npy_format_descriptor<real_type>::dtype()
+                        self.coord()
+                      , sizeof(real_type)
+                      , py::format_descriptor<real_type>::format()
+                      , 1
                       , { self.nx() }
                       , { sizeof(real_type) }
-                      , self.coord()
-                      , py::cast(self)
                     );
                 }
-              , [](wrapped_type & self, py::array_t<real_type> arr)
+            )
+            .def_property_readonly
+            (
+                "nx"
+              , [](wrapped_type const & self) { return self.nx(); }
+            )
+            .def_property
+            (
+                "coord"
+              , &coord_array
+              , [](wrapped_type & self, py::array_t<real_type, py::array::c_style | py::array::forcecast> const & arr)
                 {
-                    for (size_t it=0 ; it < self.nx() ; ++it)
+                    if (1 != arr.ndim() || size_t(arr.size()) != self.nx())
                     {
-                        self.at(it) = arr.at(it);
+                        throw py::value_error("coord must be a 1D array of nx elements");
+                    }
+                    if (self.nx())
+                    {
+                        std::memcpy(self.coord(), arr.data(), self.nx() * sizeof(real_type));
                     }
                 }
             )
+            // The kernels release the GIL.
             .def
             (
                 "fill"
               , &wrapped_type::fill
-              , py::arg("value")
+              , py::arg("value"), py::call_guard<py::gil_scoped_release>()
             )
+            .def("scale", &wrapped_type::scale, py::arg("a"), py::call_guard<py::gil_scoped_release>())
+            .def("axpy", &wrapped_type::axpy, py::arg("a"), py::arg("x"), py::call_guard<py::gil_scoped_release>())
+            .def("sum", &wrapped_type::sum, py::call_guard<py::gil_scoped_release>())
+            .def("dot", &wrapped_type::dot, py::arg("other"), py::call_guard<py::gil_scoped_release>())
+            .def("min", &wrapped_type::min, py::call_guard<py::gil_scoped_release>())
+            .def("max", &wrapped_type::max, py::call_guard<py::gil_scoped_release>())
         ;
 
     }
 
 }; /* end class WrapStaticGrid1d */
 
-class WrapStaticGrid2d
-  : public WrapStaticGridBase< WrapStaticGrid2d, modmesh::StaticGrid2d >
+template< typename Wrapper, typename GT >
+class
+MODMESH_PYTHON_WRAPPER_VISIBILITY
+WrapStaticGridArray
+  : public WrapStaticGridBase< Wrapper, GT >
 {
 
 public:
 
-    static constexpr char PYNAME[] = "StaticGrid2d";
-    static constexpr char PYDOC[] = "StaticGrid2d";
+    using base_type = WrapStaticGridBase< Wrapper, GT >;
+    using wrapped_type = typename base_type::wrapped_type;
 
-    friend root_base_type;
+    using serial_type = typename wrapped_type::serial_type;
+    using real_type = typename wrapped_type::real_type;
+    using index_type = typename wrapped_type::index_type;
+    using index_array = typename wrapped_type::index_array;
 
-    using base_type = WrapStaticGridBase< WrapStaticGrid2d, StaticGrid2d >;
+    friend typename base_type::root_base_type;
 
 protected:
 
-    WrapStaticGrid2d(pybind11::module & mod) : base_type(mod)
-    {}
-
-}; /* end class WrapStaticGrid2d */
-
-class WrapStaticGrid3d
-  : public WrapStaticGridBase< WrapStaticGrid3d, modmesh::StaticGrid3d >
-{
-
-public:
+    static constexpr size_t ND = wrapped_type::NDIM;
 
-    static constexpr char PYNAME[] = "StaticGrid3d";
-    static constexpr char PYDOC[] = "StaticGrid3d";
+    static GridLayout to_layout(std::string const & name)
+    {
+        if ("row_major" == name) { return GridLayout::ROW_MAJOR; }
+        else if ("tiled" == name) { return GridLayout::TILED; }
+        throw pybind11::value_error("layout must be \"row_major\" or \"tiled\"");
+    }
 
-    friend root_base_type;
+    static index_array to_index(wrapped_type const & self, pybind11::tuple const & key)
+    {
+        if (ND != key.size())
+        {
+            throw pybind11::index_error("wrong number of indices");
+        }
+        index_array idx;
+        for (size_t it=0; it<ND; ++it) { idx[it] = key[it].cast<index_type>(); }
+        if (!self.in_range(idx))
+        {
+            throw pybind11::index_error("index out of range");
+        }
+        return idx;
+    }
 
-    using base_type = WrapStaticGridBase< WrapStaticGrid3d, StaticGrid3d >;
+    /// Call func(idx, ipt) for every point, including ghost, in C order.
+    template< typename F >
+    static void for_each_point(wrapped_type const & self, F && func)
+    {
+        const index_type ng = self.nghost();
+        index_array idx;
+        size_t npt = 1;
+        for (size_t it=0; it<ND; ++it) { npt *= self.shape()[it] + 2*ng; }
+        for (size_t ipt=0; ipt<npt; ++ipt)
+        {
+            size_t rem = ipt;
+            for (size_t it=ND; it>0; --it)
+            {
+                const size_t len = self.shape()[it-1] + 2*ng;
+                idx[it-1] = index_type(rem % len) - ng;
+                rem /= len;
+            }
+            func(idx, ipt);
+        }
+    }
 
-protected:
+    static pybind11::array make_view
+    (
+        wrapped_type & self
+      , std::vector<size_t> const & shape
+      , std::vector<size_t> const & stride
+      , size_t offset
+    )
+    {
+        std::vector<size_t> bstride(stride);
+        for (size_t & val : bstride) { val *= sizeof(real_type); }
+        return pybind11::array
+        (
+            pybind11::detail::npy_format_descriptor<real_type>::dtype()
+          , shape
+          , bstride
+          , self.data() + offset
+          , pybind11::cast(self)
+        );
+    }
 
-    WrapStaticGrid3d(pybind11::module & mod) : base_type(mod)
-    {}
+    WrapStaticGridArray(pybind11::module & mod) : base_type(mod)
+    {
 
-}; /* end class WrapStaticGrid3d */
+        namespace py = pybind11;
 
-class WrapTimeRegistry
+        (*this)
+            .def_property_readonly
+            (
+                "shape"
+              , [](wrapped_type const & self) { return py::tuple(py::cast(self.shape())); }
+            )
+            .def_property_readonly("nghost", &wrapped_type::nghost)
+            .def_property_readonly
+            (
+                "layout"
+              , [](wrapped_type const & self)
+                {
+                    return GridLayout::TILED == self.layout() ? "tiled" : "row_major";
+                }
+            )
+            .def_property_readonly("tile", &wrapped_type::tile)
+            .def_property_readonly
+            (
+                "extent"
+              , [](wrapped_type const & self) { return py::tuple(py::cast(self.extent())); }
+            )
+            .def
+            (
+                "__getitem__"
+              , [](wrapped_type const & self, py::tuple const & key)
+                {
+                    return self.data()[self.offset(to_index(self, key))];
+                }
+            )
+            .def
+            (
+                "__setitem__"
+              , [](wrapped_type & self, py::tuple const & key, real_type val)
+                {
+                    self.data()[self.offset(to_index(self, key))] = val;
+                }
+            )
+            .def_property_readonly
+            (
+                "data"
+              , [](wrapped_type & self)
+                {
+                    std::vector<size_t> shape;
+                    std::vector<size_t> stride;
+                    if (GridLayout::ROW_MAJOR == self.layout())
+                    {
+                        for (size_t it=0; it<ND; ++it)
+                        {
+                            shape.push_back(self.shape()[it] + 2*self.nghost());
+                            stride.push_back(self.stride()[it]);
+                        }
+                    }
+                    else
+                    {
+                        // One axis per tile index followed by one per point in a tile.
+                        const size_t tsize = self.tile();
+                        for (size_t it=0; it<ND; ++it) { shape.push_back(self.extent()[it] / tsize); }
+                        for (size_t it=0; it<ND; ++it) { shape.push_back(tsize); }
+                        stride.resize(2*ND);
+                        size_t step = 1;
+                        for (size_t it=2*ND; it>0; --it)
+                        {
+                            stride[it-1] = step;
+                            step *= shape[it-1];
+                        }
+                    }
+                    return make_view(self, shape, stride, 0);
+                }
+            )
+            .def_property_readonly
+            (
+                "interior"
+              , [](wrapped_type & self)
+                {
+                    if (GridLayout::ROW_MAJOR != self.layout())
+                    {
+                        throw py::value_error("interior view needs row_major layout");
+                    }
+                    std::vector<size_t> shape(self.shape().begin(), self.shape().end());
+                    std::vector<size_t> stride(self.stride().begin(), self.stride().end());
+                    index_array idx;
+                    idx.fill(0);
+                    return make_view(self, shape, stride, self.offset(idx));
+                }
+            )
+            .def
+            (
+                "to_array"
+              , [](wrapped_type const & self)
+                {
+                    std::vector<size_t> shape;
+                    for (size_t it=0; it<ND; ++it) { shape.push_back(self.shape()[it] + 2*self.nghost()); }
+                    py::array_t<real_type> arr(shape);
+                    real_type * ptr = arr.mutable_data();
+                    for_each_point
+                    (
+                        self
+                      , [&](index_array const & idx, size_t ipt) { ptr[ipt] = self.data()[self.offset(idx)]; }
+                    );
+                    return arr;
+                }
+            )
+            .def
+            (
+                "from_array"
+              , [](wrapped_type & self, py::array_t<real_type, py::array::c_style | py::array::forcecast> const & arr)
+                {
+                    if (ND != size_t(arr.ndim()))
+                    {
+                        throw py::value_error("wrong number of dimensions");
+                    }
+                    for (size_t it=0; it<ND; ++it)
+                    {
+                        if (size_t(arr.shape(it)) != self.shape()[it] + 2*self.nghost())
+                        {
+                            throw py::value_error("shape mismatch; ghost points included");
+                        }
+                    }
+                    real_type const * ptr = arr.data();
+                    for_each_point
+                    (
+                        self
+                      , [&](index_array const & idx, size_t ipt) { self.data()[self.offset(idx)] = ptr[ipt]; }
+                    );
+                }
+              , py::arg("array")
+            )
+            .def
+            (
+                "fill"
+              , &wrapped_type::fill
+              , py::arg("value"), py::call_guard<py::gil_scoped_release>()
+            )
+        ;
+
+        constexpr char const * coord_names[] = {"xcoord", "ycoord", "zcoord"};
+        for (size_t axis=0; axis<ND; ++axis)
+        {
+            (*this)
+                .def_property_readonly
+                (
+                    coord_names[axis]
+                  , [axis](wrapped_type & self)
+                    {
+                        return py::array
+                        (
+                            py::detail::npy_format_descriptor<real_type>::dtype()
+                          , { size_t(self.shape()[axis]) }
+                          , { sizeof(real_type) }
+                          , self.coord(axis)
+                          , py::cast(self)
+                        );
+                    }
+                )
+            ;
+        }
+
+    }
+
+}; /* end class WrapStaticGridArray */
+
+class WrapStaticGrid2d
+  : public WrapStaticGridArray< WrapStaticGrid2d, modmesh::StaticGrid2d >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "StaticGrid2d";
+    static constexpr char PYDOC[] = "StaticGrid2d";
+
+    friend root_base_type;
+
+    using base_type = WrapStaticGridArray< WrapStaticGrid2d, StaticGrid2d >;
+
+protected:
+
+    WrapStaticGrid2d(pybind11::module & mod) : base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def
+            (
+                py::init
+                (
+                    [](serial_type nx, serial_type ny, serial_type nghost, std::string const & layout, serial_type tile)
+                    {
+                        return new StaticGrid2d(nx, ny, nghost, to_layout(layout), tile);
+                    }
+                )
+              , py::arg("nx"), py::arg("ny"), py::arg("nghost")=0
+              , py::arg("layout")="row_major", py::arg("tile")=StaticGrid2d::DEFAULT_TILE
+            )
+            .def_property_readonly("nx", &wrapped_type::nx)
+            .def_property_readonly("ny", &wrapped_type::ny)
+        ;
+
+    }
+
+}; /* end class WrapStaticGrid2d */
+
+class WrapStaticGrid3d
+  : public WrapStaticGridArray< WrapStaticGrid3d, modmesh::StaticGrid3d >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "StaticGrid3d";
+    static constexpr char PYDOC[] = "StaticGrid3d";
+
+    friend root_base_type;
+
+    using base_type = WrapStaticGridArray< WrapStaticGrid3d, StaticGrid3d >;
+
+protected:
+
+    WrapStaticGrid3d(pybind11::module & mod) : base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def
+            (
+                py::init
+                (
+                    [](serial_type nx, serial_type ny, serial_type nz, serial_type nghost,
+                       std::string const & layout, serial_type tile)
+                    {
+                        return new StaticGrid3d(nx, ny, nz, nghost, to_layout(layout), tile);
+                    }
+                )
+              , py::arg("nx"), py::arg("ny"), py::arg("nz"), py::arg("nghost")=0
+              , py::arg("layout")="row_major", py::arg("tile")=StaticGrid3d::DEFAULT_TILE
+            )
+            .def_property_readonly("nx", &wrapped_type::nx)
+            .def_property_readonly("ny", &wrapped_type::ny)
+            .def_property_readonly("nz", &wrapped_type::nz)
+        ;
+
+    }
+
+}; /* end class WrapStaticGrid3d */
+
+template< typename Wrapper, typename MT >
+class
+MODMESH_PYTHON_WRAPPER_VISIBILITY
+WrapStaticMesh
+  : public WrapBase< Wrapper, MT >
+{
+
+public:
+
+    using base_type = WrapBase< Wrapper, MT >;
+    using wrapped_type = typename base_type::wrapped_type;
+
+    using serial_type = typename wrapped_type::serial_type;
+    using real_type = typename wrapped_type::real_type;
+    using serial_array = typename wrapped_type::serial_array;
+    using real_array = typename wrapped_type::real_array;
+
+    friend typename base_type::root_base_type;
+
+protected:
+
+    /// Read-only view of an array owned by the mesh.
+    template< typename T >
+    static pybind11::array make_view(wrapped_type const & self, SimpleArray<T> const & arr)
+    {
+        std::vector<size_t> bstride(arr.stride());
+        for (size_t & val : bstride) { val *= sizeof(T); }
+        pybind11::array ret
+        (
+            pybind11::detail::npy_format_descriptor<T>::dtype()
+          , arr.shape()
+          , bstride
+          , arr.data()
+          , pybind11::cast(self)
+        );
+        ret.attr("flags").attr("writeable") = false;
+        return ret;
+    }
+
+    template< typename T >
+    static SimpleArray<T> to_simple(pybind11::array_t<T, pybind11::array::c_style | pybind11::array::forcecast> const & arr)
+    {
+        SimpleArray<T> ret(std::vector<size_t>(arr.shape(), arr.shape() + arr.ndim()));
+        if (ret.size()) { std::memcpy(ret.data(), arr.data(), ret.nbytes()); }
+        return ret;
+    }
+
+    static ReorderMethod to_method(std::string const & name)
+    {
+        if ("rcm" == name) { return ReorderMethod::RCM; }
+        else if ("hilbert" == name) { return ReorderMethod::HILBERT; }
+        else if ("morton" == name) { return ReorderMethod::MORTON; }
+        throw pybind11::value_error("method must be \"rcm\", \"hilbert\", or \"morton\"");
+    }
+
+    WrapStaticMesh(pybind11::module & mod) : base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def
+            (
+                py::init
+                (
+                    [](py::array_t<real_type, py::array::c_style | py::array::forcecast> const & ndcrd
+                     , py::array_t<serial_type, py::array::c_style | py::array::forcecast> const & clnds_offset
+                     , py::array_t<serial_type, py::array::c_style | py::array::forcecast> const & clnds)
+                    {
+                        return new wrapped_type(to_simple(ndcrd), to_simple(clnds_offset), to_simple(clnds));
+                    }
+                )
+              , py::arg("ndcrd"), py::arg("clnds_offset"), py::arg("clnds")
+            )
+            .def_property_readonly_static
+            (
+                "NDIM"
+              , [](py::object const &) { return wrapped_type::NDIM; }
+            )
+            .def_property_readonly_static
+            (
+                "INVALID"
+              , [](py::object const &) { return wrapped_type::INVALID; }
+            )
+            .def_property_readonly("nnode", &wrapped_type::nnode)
+            .def_property_readonly("ncell", &wrapped_type::ncell)
+            .def_property_readonly("nface", &wrapped_type::nface)
+            .def_property_readonly("nbface", &wrapped_type::nbface)
+            .def_property_readonly
+            (
+                "ndcrd"
+              , [](wrapped_type & self)
+                {
+                    real_array & arr = self.ndcrd();
+                    std::vector<size_t> bstride(arr.stride());
+                    for (size_t & val : bstride) { val *= sizeof(real_type); }
+                    return py::array
+                    (
+                        py::detail::npy_format_descriptor<real_type>::dtype()
+                      , arr.shape()
+                      , bstride
+                      , arr.data()
+                      , py::cast(self)
+                    );
+                }
+            )
+            .def("cell_centroid", &wrapped_type::cell_centroid)
+            .def_property_readonly("cell_bandwidth", &wrapped_type::cell_bandwidth)
+            .def_property_readonly("node_bandwidth", &wrapped_type::node_bandwidth)
+            .def
+            (
+                "cell_order"
+              , [](wrapped_type const & self, std::string const & method)
+                {
+                    serial_array order = self.cell_order(to_method(method));
+                    return py::array_t<serial_type>(order.size(), order.data());
+                }
+              , py::arg("method")="rcm"
+            )
+            .def
+            (
+                "node_order"
+              , [](wrapped_type const & self, std::string const & method)
+                {
+                    serial_array order = self.node_order(to_method(method));
+                    return py::array_t<serial_type>(order.size(), order.data());
+                }
+              , py::arg("method")="rcm"
+            )
+            .def
+            (
+                "renumber"
+              , [](wrapped_type const & self
+                 , py::array_t<serial_type, py::array::c_style | py::array::forcecast> const & cell_order
+                 , py::array_t<serial_type, py::array::c_style | py::array::forcecast> const & node_order)
+                {
+                    return wrapped_type(self.renumber(to_simple(cell_order), to_simple(node_order)));
+                }
+              , py::arg("cell_order"), py::arg("node_order")
+            )
+        ;
+
+        // Derived connectivity is read-only.
+#define MM_DECL_MESH_ARRAY(NAME) \
+        (*this).def_property_readonly(#NAME, [](wrapped_type const & self) { return make_view(self, self.NAME()); });
+
+        MM_DECL_MESH_ARRAY(clnds_offset)
+        MM_DECL_MESH_ARRAY(clnds)
+        MM_DECL_MESH_ARRAY(clfcs_offset)
+        MM_DECL_MESH_ARRAY(clfcs)
+        MM_DECL_MESH_ARRAY(clnbs_full)
+        MM_DECL_MESH_ARRAY(clnbs_offset)
+        MM_DECL_MESH_ARRAY(clnbs)
+        MM_DECL_MESH_ARRAY(fcnds_offset)
+        MM_DECL_MESH_ARRAY(fcnds)
+        MM_DECL_MESH_ARRAY(fccls)
+
+#undef MM_DECL_MESH_ARRAY
+
+    }
+
+}; /* end class WrapStaticMesh */
+
+class WrapStaticMesh2d
+  : public WrapStaticMesh< WrapStaticMesh2d, modmesh::StaticMesh2d >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "StaticMesh2d";
+    static constexpr char PYDOC[] = "StaticMesh2d";
+
+    friend root_base_type;
+
+    using base_type = WrapStaticMesh< WrapStaticMesh2d, StaticMesh2d >;
+
+protected:
+
+    WrapStaticMesh2d(pybind11::module & mod) : base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def_static
+            (
+                "rectangle"
+              , &wrapped_type::rectangle
+              , py::arg("nx"), py::arg("ny"), py::arg("lx")=1, py::arg("ly")=1, py::arg("triangle")=false
+            )
+        ;
+
+    }
+
+}; /* end class WrapStaticMesh2d */
+
+class WrapStaticMesh3d
+  : public WrapStaticMesh< WrapStaticMesh3d, modmesh::StaticMesh3d >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "StaticMesh3d";
+    static constexpr char PYDOC[] = "StaticMesh3d";
+
+    friend root_base_type;
+
+    using base_type = WrapStaticMesh< WrapStaticMesh3d, StaticMesh3d >;
+
+protected:
+
+    WrapStaticMesh3d(pybind11::module & mod) : base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def_static
+            (
+                "box"
+              , &wrapped_type::box
+              , py::arg("nx"), py::arg("ny"), py::arg("nz"), py::arg("lx")=1, py::arg("ly")=1, py::arg("lz")=1
+            )
+        ;
+
+    }
+
+}; /* end class WrapStaticMesh3d */
+
+class WrapStaticGraph
+  : public WrapBase< WrapStaticGraph, StaticGraph >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "StaticGraph";
+    static constexpr char PYDOC[] = "StaticGraph";
+
+    friend root_base_type;
+
+    using serial_type = wrapped_type::serial_type;
+    using serial_array = wrapped_type::serial_array;
+    using array_type = pybind11::array_t<serial_type, pybind11::array::c_style | pybind11::array::forcecast>;
+
+    static serial_array to_simple(array_type const & arr)
+    {
+        serial_array ret(static_cast<size_t>(arr.size()));
+        if (ret.size()) { std::memcpy(ret.data(), arr.data(), ret.nbytes()); }
+        return ret;
+    }
+
+protected:
+
+    WrapStaticGraph(pybind11::module & mod) : root_base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def
+            (
+                py::init
+                (
+                    [](array_type const & xadj, array_type const & adjncy, py::object const & vwgt, py::object const & adjwgt)
+                    {
+                        if (vwgt.is_none() && adjwgt.is_none())
+                        {
+                            return new StaticGraph(to_simple(xadj), to_simple(adjncy));
+                        }
+                        if (vwgt.is_none() || adjwgt.is_none())
+                        {
+                            throw py::value_error("vwgt and adjwgt must be given together");
+                        }
+                        return new StaticGraph
+                        (
+                            to_simple(xadj), to_simple(adjncy)
+                          , to_simple(vwgt.cast<array_type>()), to_simple(adjwgt.cast<array_type>())
+                        );
+                    }
+                )
+              , py::arg("xadj"), py::arg("adjncy"), py::arg("vwgt")=py::none(), py::arg("adjwgt")=py::none()
+            )
+            .def_static("dual", [](StaticMesh2d const & mesh) { return StaticGraph::dual(mesh); }, py::arg("mesh"))
+            .def_static("dual", [](StaticMesh3d const & mesh) { return StaticGraph::dual(mesh); }, py::arg("mesh"))
+            .def_property_readonly("nvertex", &wrapped_type::nvertex)
+            .def_property_readonly("nedge", &wrapped_type::nedge)
+            .def
+            (
+                "edge_cut"
+              , [](wrapped_type const & self, array_type const & part) { return self.edge_cut(to_simple(part)); }
+              , py::arg("part")
+            )
+            .def
+            (
+                "imbalance"
+              , [](wrapped_type const & self, array_type const & part, size_t nparts)
+                {
+                    return self.imbalance(to_simple(part), nparts);
+                }
+              , py::arg("part"), py::arg("nparts")
+            )
+        ;
+
+#define MM_DECL_GRAPH_ARRAY(NAME) \
+        (*this).def_property_readonly \
+        ( \
+            #NAME \
+          , [](wrapped_type const & self) \
+            { \
+                serial_array const & arr = self.NAME(); \
+                return py::array_t<serial_type>(arr.size(), arr.data()); \
+            } \
+        );
+
+        MM_DECL_GRAPH_ARRAY(xadj)
+        MM_DECL_GRAPH_ARRAY(adjncy)
+        MM_DECL_GRAPH_ARRAY(vwgt)
+        MM_DECL_GRAPH_ARRAY(adjwgt)
+
+#undef MM_DECL_GRAPH_ARRAY
+
+    }
+
+}; /* end class WrapStaticGraph */
+
+class WrapGraphPartitioner
+  : public WrapBase< WrapGraphPartitioner, GraphPartitioner >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "GraphPartitioner";
+    static constexpr char PYDOC[] = "GraphPartitioner";
+
+    friend root_base_type;
+
+protected:
+
+    WrapGraphPartitioner(pybind11::module & mod) : root_base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def
+            (
+                py::init
+                (
+                    [](uint64_t seed, double ubfactor)
+                    {
+                        GraphPartitioner * ret = new GraphPartitioner;
+                        ret->set_seed(seed);
+                        ret->set_ubfactor(ubfactor);
+                        return ret;
+                    }
+                )
+              , py::arg("seed")=0, py::arg("ubfactor")=1.03
+            )
+            .def_property("seed", &wrapped_type::seed, &wrapped_type::set_seed)
+            .def_property("ubfactor", &wrapped_type::ubfactor, &wrapped_type::set_ubfactor)
+            .def_property("coarsen_to", &wrapped_type::coarsen_to, &wrapped_type::set_coarsen_to)
+            .def_property("niter", &wrapped_type::niter, &wrapped_type::set_niter)
+            .def_property("ntrial", &wrapped_type::ntrial, &wrapped_type::set_ntrial)
+            .def
+            (
+                "partition"
+              , [](wrapped_type const & self, StaticGraph const & graph, size_t nparts)
+                {
+                    StaticGraph::serial_array part;
+                    {
+                        py::gil_scoped_release release;
+                        part = self.partition(graph, nparts);
+                    }
+                    return py::array_t<StaticGraph::serial_type>(part.size(), part.data());
+                }
+              , py::arg("graph"), py::arg("nparts")
+            )
+        ;
+
+    }
+
+}; /* end class WrapGraphPartitioner */
+
+template< typename Wrapper, size_t ND >
+class
+MODMESH_PYTHON_WRAPPER_VISIBILITY
+WrapSubMesh
+  : public WrapBase< Wrapper, SubMesh<ND> >
+{
+
+public:
+
+    using base_type = WrapBase< Wrapper, SubMesh<ND> >;
+    using wrapped_type = typename base_type::wrapped_type;
+    using serial_type = typename wrapped_type::serial_type;
+
+    friend typename base_type::root_base_type;
+
+protected:
+
+    static pybind11::array_t<serial_type> to_array(std::vector<serial_type> const & vec)
+    {
+        return pybind11::array_t<serial_type>(vec.size(), vec.data());
+    }
+
+    WrapSubMesh(pybind11::module & mod) : base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def_property_readonly("part", &wrapped_type::part)
+            .def_property_readonly("nown", &wrapped_type::nown)
+            .def_property_readonly("nghost", &wrapped_type::nghost)
+            .def_property_readonly
+            (
+                "mesh"
+              , &wrapped_type::mesh
+              , py::return_value_policy::reference_internal
+            )
+            .def_property_readonly("clgid", [](wrapped_type const & self) { return to_array(self.clgid()); })
+            .def_property_readonly("ndgid", [](wrapped_type const & self) { return to_array(self.ndgid()); })
+            .def_property_readonly("cllayer", [](wrapped_type const & self) { return to_array(self.cllayer()); })
+        ;
+
+#define MM_DECL_PLAN_ARRAY(NAME) \
+        (*this).def_property_readonly(#NAME, [](wrapped_type const & self) { return to_array(self.plan().NAME); });
+
+        MM_DECL_PLAN_ARRAY(send_part)
+        MM_DECL_PLAN_ARRAY(send_offset)
+        MM_DECL_PLAN_ARRAY(send_cell)
+        MM_DECL_PLAN_ARRAY(recv_part)
+        MM_DECL_PLAN_ARRAY(recv_offset)
+        MM_DECL_PLAN_ARRAY(recv_cell)
+
+#undef MM_DECL_PLAN_ARRAY
+
+    }
+
+}; /* end class WrapSubMesh */
+
+class WrapSubMesh2d
+  : public WrapSubMesh< WrapSubMesh2d, 2 >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "SubMesh2d";
+    static constexpr char PYDOC[] = "SubMesh2d";
+
+    friend root_base_type;
+
+    using base_type = WrapSubMesh< WrapSubMesh2d, 2 >;
+
+protected:
+
+    WrapSubMesh2d(pybind11::module & mod) : base_type(mod) {}
+
+}; /* end class WrapSubMesh2d */
+
+class WrapSubMesh3d
+  : public WrapSubMesh< WrapSubMesh3d, 3 >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "SubMesh3d";
+    static constexpr char PYDOC[] = "SubMesh3d";
+
+    friend root_base_type;
+
+    using base_type = WrapSubMesh< WrapSubMesh3d, 3 >;
+
+protected:
+
+    WrapSubMesh3d(pybind11::module & mod) : base_type(mod) {}
+
+}; /* end class WrapSubMesh3d */
+
+template< typename Wrapper, size_t ND >
+class
+MODMESH_PYTHON_WRAPPER_VISIBILITY
+WrapMeshDecomposition
+  : public WrapBase< Wrapper, MeshDecomposition<ND> >
+{
+
+public:
+
+    using base_type = WrapBase< Wrapper, MeshDecomposition<ND> >;
+    using wrapped_type = typename base_type::wrapped_type;
+    using serial_type = typename wrapped_type::serial_type;
+    using real_type = typename wrapped_type::real_type;
+    using mesh_type = typename wrapped_type::submesh_type::mesh_type;
+
+    friend typename base_type::root_base_type;
+
+protected:
+
+    WrapMeshDecomposition(pybind11::module & mod) : base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        using field_type = py::array_t<real_type, py::array::c_style>;
+
+        (*this)
+            .def
+            (
+                py::init
+                (
+                    [](mesh_type const & mesh
+                     , py::array_t<serial_type, py::array::c_style | py::array::forcecast> const & part
+                     , size_t nparts, size_t nlayer)
+                    {
+                        SimpleArray<serial_type> sarr(static_cast<size_t>(part.size()));
+                        if (sarr.size()) { std::memcpy(sarr.data(), part.data(), sarr.nbytes()); }
+                        py::gil_scoped_release release;
+                        return new wrapped_type(mesh, sarr, nparts, nlayer);
+                    }
+                )
+              , py::arg("mesh"), py::arg("part"), py::arg("nparts"), py::arg("nlayer")=1
+            )
+            .def_property_readonly("nparts", &wrapped_type::nparts)
+            .def("__len__", &wrapped_type::nparts)
+            .def
+            (
+                "__getitem__"
+              , [](wrapped_type const & self, size_t it) -> typename wrapped_type::submesh_type const &
+                {
+                    if (it >= self.nparts()) { throw py::index_error("part out of range"); }
+                    return self[it];
+                }
+              , py::return_value_policy::reference_internal
+            )
+            .def
+            (
+                "exchange"
+              , [](wrapped_type const & self, py::list const & fields)
+                {
+                    if (fields.size() != self.nparts())
+                    {
+                        throw py::value_error("need one array per part");
+                    }
+                    std::vector<real_type *> data(fields.size());
+                    size_t ncomp = 0;
+                    for (size_t ipart=0; ipart<fields.size(); ++ipart)
+                    {
+                        // Check the exact type; a converted copy would not be updated.
+                        if (!py::isinstance<field_type>(fields[ipart]))
+                        {
+                            throw py::type_error("arrays must be C-contiguous float64");
+                        }
+                        field_type arr = fields[ipart].template cast<field_type>();
+                        const size_t ncell = self[ipart].mesh().ncell();
+                        if (0 == arr.ndim() || size_t(arr.shape(0)) != ncell)
+                        {
+                            throw py::value_error("arrays must have one row per local cell");
+                        }
+                        const size_t row = ncell ? size_t(arr.size()) / ncell : 0;
+                        if (ipart && row != ncomp)
+                        {
+                            throw py::value_error("arrays differ in values per cell");
+                        }
+                        ncomp = row;
+                        data[ipart] = arr.mutable_data();
+                    }
+                    py::gil_scoped_release release;
+                    self.exchanger().exchange(data.data(), ncomp);
+                }
+              , py::arg("fields")
+            )
+        ;
+
+    }
+
+}; /* end class WrapMeshDecomposition */
+
+class WrapMeshDecomposition2d
+  : public WrapMeshDecomposition< WrapMeshDecomposition2d, 2 >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "MeshDecomposition2d";
+    static constexpr char PYDOC[] = "MeshDecomposition2d";
+
+    friend root_base_type;
+
+    using base_type = WrapMeshDecomposition< WrapMeshDecomposition2d, 2 >;
+
+protected:
+
+    WrapMeshDecomposition2d(pybind11::module & mod) : base_type(mod) {}
+
+}; /* end class WrapMeshDecomposition2d */
+
+class WrapMeshDecomposition3d
+  : public WrapMeshDecomposition< WrapMeshDecomposition3d, 3 >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "MeshDecomposition3d";
+    static constexpr char PYDOC[] = "MeshDecomposition3d";
+
+    friend root_base_type;
+
+    using base_type = WrapMeshDecomposition< WrapMeshDecomposition3d, 3 >;
+
+protected:
+
+    WrapMeshDecomposition3d(pybind11::module & mod) : base_type(mod) {}
+
+}; /* end class WrapMeshDecomposition3d */
+
+template< typename Wrapper, size_t ND >
+class
+MODMESH_PYTHON_WRAPPER_VISIBILITY
+WrapSpatialIndex
+  : public WrapBase< Wrapper, SpatialIndex<ND> >
+{
+
+public:
+
+    using base_type = WrapBase< Wrapper, SpatialIndex<ND> >;
+    using wrapped_type = typename base_type::wrapped_type;
+    using serial_type = typename wrapped_type::serial_type;
+    using real_type = typename wrapped_type::real_type;
+    using real_array = typename wrapped_type::real_array;
+
+    friend typename base_type::root_base_type;
+
+protected:
+
+    using array_type = pybind11::array_t<real_type, pybind11::array::c_style | pybind11::array::forcecast>;
+    using item_type = pybind11::array_t<serial_type, pybind11::array::c_style | pybind11::array::forcecast>;
+
+    static real_array to_simple(array_type const & arr)
+    {
+        real_array ret(std::vector<size_t>(arr.shape(), arr.shape() + arr.ndim()));
+        if (ret.size()) { std::memcpy(ret.data(), arr.data(), ret.nbytes()); }
+        return ret;
+    }
+
+    static SimpleArray<serial_type> to_items(item_type const & arr)
+    {
+        SimpleArray<serial_type> ret(static_cast<size_t>(arr.size()));
+        if (ret.size()) { std::memcpy(ret.data(), arr.data(), ret.nbytes()); }
+        return ret;
+    }
+
+    template <typename T>
+    static pybind11::array_t<T> to_array(SimpleArray<T> const & arr)
+    {
+        return pybind11::array_t<T>(arr.shape(), arr.data());
+    }
+
+    WrapSpatialIndex(pybind11::module & mod) : base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def_static
+            (
+                "points"
+              , [](array_type const & crd)
+                {
+                    real_array sarr = to_simple(crd);
+                    py::gil_scoped_release release;
+                    return wrapped_type::points(sarr);
+                }
+              , py::arg("crd")
+            )
+            .def_static
+            (
+                "segments"
+              , [](array_type const & crd)
+                {
+                    real_array sarr = to_simple(crd);
+                    py::gil_scoped_release release;
+                    return wrapped_type::segments(sarr);
+                }
+              , py::arg("crd")
+            )
+            .def_static
+            (
+                "boxes"
+              , [](array_type const & crd)
+                {
+                    real_array sarr = to_simple(crd);
+                    py::gil_scoped_release release;
+                    return wrapped_type::boxes(sarr);
+                }
+              , py::arg("crd")
+            )
+            .def_property_readonly_static
+            (
+                "INVALID"
+              , [](py::object const &) { return wrapped_type::INVALID; }
+            )
+            .def("__len__", &wrapped_type::size)
+            .def_property_readonly("size", &wrapped_type::size)
+            .def_property_readonly("nid", &wrapped_type::nid)
+            .def_property_readonly("nnode", &wrapped_type::nnode)
+            .def_property_readonly("depth", &wrapped_type::depth)
+            .def_property_readonly("quality", &wrapped_type::quality)
+            .def("alive", &wrapped_type::alive, py::arg("item"))
+            .def
+            (
+                "insert"
+              , [](wrapped_type & self, array_type const & crd)
+                {
+                    real_array sarr = to_simple(crd);
+                    SimpleArray<serial_type> ids;
+                    {
+                        py::gil_scoped_release release;
+                        ids = self.insert(sarr);
+                    }
+                    return to_array(ids);
+                }
+              , py::arg("crd")
+            )
+            .def
+            (
+                "remove"
+              , [](wrapped_type & self, item_type const & items)
+                {
+                    SimpleArray<serial_type> sitems = to_items(items);
+                    py::gil_scoped_release release;
+                    self.remove(sitems);
+                }
+              , py::arg("items")
+            )
+            .def
+            (
+                "refit"
+              , [](wrapped_type & self, item_type const & items, array_type const & crd)
+                {
+                    SimpleArray<serial_type> sitems = to_items(items);
+                    real_array sarr = to_simple(crd);
+                    py::gil_scoped_release release;
+                    self.refit(sitems, sarr);
+                }
+              , py::arg("items"), py::arg("crd")
+            )
+            .def
+            (
+                "rebuild"
+              , [](wrapped_type & self)
+                {
+                    py::gil_scoped_release release;
+                    self.rebuild();
+                }
+            )
+            .def
+            (
+                "range"
+              , [](wrapped_type const & self, array_type const & query)
+                {
+                    real_array sarr = to_simple(query);
+                    std::pair<SimpleArray<serial_type>, SimpleArray<serial_type>> ret;
+                    {
+                        py::gil_scoped_release release;
+                        ret = self.range(sarr);
+                    }
+                    return py::make_tuple(to_array(ret.first), to_array(ret.second));
+                }
+              , py::arg("query")
+            )
+            .def
+            (
+                "nearest"
+              , [](wrapped_type const & self, array_type const & query, size_t k)
+                {
+                    real_array sarr = to_simple(query);
+                    std::pair<SimpleArray<serial_type>, real_array> ret;
+                    {
+                        py::gil_scoped_release release;
+                        ret = self.nearest(sarr, k);
+                    }
+                    return py::make_tuple(to_array(ret.first), to_array(ret.second));
+                }
+              , py::arg("query"), py::arg("k")=1
+            )
+        ;
+
+    }
+
+}; /* end class WrapSpatialIndex */
+
+class WrapSpatialIndex2d
+  : public WrapSpatialIndex< WrapSpatialIndex2d, 2 >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "SpatialIndex2d";
+    static constexpr char PYDOC[] = "SpatialIndex2d";
+
+    friend root_base_type;
+
+    using base_type = WrapSpatialIndex< WrapSpatialIndex2d, 2 >;
+
+protected:
+
+    WrapSpatialIndex2d(pybind11::module & mod) : base_type(mod) {}
+
+}; /* end class WrapSpatialIndex2d */
+
+class WrapSpatialIndex3d
+  : public WrapSpatialIndex< WrapSpatialIndex3d, 3 >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "SpatialIndex3d";
+    static constexpr char PYDOC[] = "SpatialIndex3d";
+
+    friend root_base_type;
+
+    using base_type = WrapSpatialIndex< WrapSpatialIndex3d, 3 >;
+
+protected:
+
+    WrapSpatialIndex3d(pybind11::module & mod) : base_type(mod) {}
+
+}; /* end class WrapSpatialIndex3d */
+
+template< typename Wrapper, size_t ND >
+class
+MODMESH_PYTHON_WRAPPER_VISIBILITY
+WrapKdTree
+  : public WrapBase< Wrapper, KdTree<ND> >
+{
+
+public:
+
+    using base_type = WrapBase< Wrapper, KdTree<ND> >;
+    using wrapped_type = typename base_type::wrapped_type;
+    using serial_type = typename wrapped_type::serial_type;
+    using real_type = typename wrapped_type::real_type;
+    using real_array = typename wrapped_type::real_array;
+
+    friend typename base_type::root_base_type;
+
+protected:
+
+    using array_type = pybind11::array_t<real_type, pybind11::array::c_style | pybind11::array::forcecast>;
+
+    static real_array to_simple(array_type const & arr)
+    {
+        real_array ret(std::vector<size_t>(arr.shape(), arr.shape() + arr.ndim()));
+        if (ret.size()) { std::memcpy(ret.data(), arr.data(), ret.nbytes()); }
+        return ret;
+    }
+
+    template <typename T>
+    static pybind11::array_t<T> to_array(SimpleArray<T> const & arr)
+    {
+        return pybind11::array_t<T>(arr.shape(), arr.data());
+    }
+
+    WrapKdTree(pybind11::module & mod) : base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def
+            (
+                py::init
+                (
+                    [](array_type const & crd)
+                    {
+                        real_array sarr = to_simple(crd);
+                        py::gil_scoped_release release;
+                        return new wrapped_type(sarr);
+                    }
+                )
+              , py::arg("crd")
+            )
+            .def_property_readonly_static
+            (
+                "INVALID"
+              , [](py::object const &) { return wrapped_type::INVALID; }
+            )
+            .def("__len__", &wrapped_type::size)
+            .def_property_readonly("size", &wrapped_type::size)
+            .def_property_readonly("nnode", &wrapped_type::nnode)
+            .def_property_readonly("nbucket", &wrapped_type::nbucket)
+            .def_property_readonly("depth", &wrapped_type::depth)
+            .def
+            (
+                "range"
+              , [](wrapped_type const & self, array_type const & query)
+                {
+                    real_array sarr = to_simple(query);
+                    std::pair<SimpleArray<serial_type>, SimpleArray<serial_type>> ret;
+                    {
+                        py::gil_scoped_release release;
+                        ret = self.range(sarr);
+                    }
+                    return py::make_tuple(to_array(ret.first), to_array(ret.second));
+                }
+              , py::arg("query")
+            )
+            .def
+            (
+                "nearest"
+              , [](wrapped_type const & self, array_type const & query, size_t k)
+                {
+                    real_array sarr = to_simple(query);
+                    std::pair<SimpleArray<serial_type>, real_array> ret;
+                    {
+                        py::gil_scoped_release release;
+                        ret = self.nearest(sarr, k);
+                    }
+                    return py::make_tuple(to_array(ret.first), to_array(ret.second));
+                }
+              , py::arg("query"), py::arg("k")=1
+            )
+        ;
+
+    }
+
+}; /* end class WrapKdTree */
+
+class WrapKdTree2d
+  : public WrapKdTree< WrapKdTree2d, 2 >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "KdTree2d";
+    static constexpr char PYDOC[] = "KdTree2d";
+
+    friend root_base_type;
+
+    using base_type = WrapKdTree< WrapKdTree2d, 2 >;
+
+protected:
+
+    WrapKdTree2d(pybind11::module & mod) : base_type(mod) {}
+
+}; /* end class WrapKdTree2d */
+
+class WrapKdTree3d
+  : public WrapKdTree< WrapKdTree3d, 3 >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "KdTree3d";
+    static constexpr char PYDOC[] = "KdTree3d";
+
+    friend root_base_type;
+
+    using base_type = WrapKdTree< WrapKdTree3d, 3 >;
+
+protected:
+
+    WrapKdTree3d(pybind11::module & mod) : base_type(mod) {}
+
+}; /* end class WrapKdTree3d */
+
+template< typename Wrapper, size_t ND >
+class
+MODMESH_PYTHON_WRAPPER_VISIBILITY
+WrapPointLocator
+  : public WrapBase< Wrapper, PointLocator<ND> >
+{
+
+public:
+
+    using base_type = WrapBase< Wrapper, PointLocator<ND> >;
+    using wrapped_type = typename base_type::wrapped_type;
+    using serial_type = typename wrapped_type::serial_type;
+    using real_type = typename wrapped_type::real_type;
+    using real_array = typename wrapped_type::real_array;
+    using serial_array = typename wrapped_type::serial_array;
+    using mesh_type = typename wrapped_type::mesh_type;
+
+    friend typename base_type::root_base_type;
+
+protected:
+
+    using array_type = pybind11::array_t<real_type, pybind11::array::c_style | pybind11::array::forcecast>;
+
+    static real_array to_simple(array_type const & arr)
+    {
+        real_array ret(std::vector<size_t>(arr.shape(), arr.shape() + arr.ndim()));
+        if (ret.size()) { std::memcpy(ret.data(), arr.data(), ret.nbytes()); }
+        return ret;
+    }
+
+    template <typename T>
+    static pybind11::array_t<T> to_array(SimpleArray<T> const & arr)
+    {
+        return pybind11::array_t<T>(arr.shape(), arr.data());
+    }
+
+    WrapPointLocator(pybind11::module & mod) : base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def
+            (
+                py::init
+                (
+                    [](mesh_type const & mesh)
+                    {
+                        py::gil_scoped_release release;
+                        return new wrapped_type(mesh);
+                    }
+                )
+              , py::arg("mesh")
+            )
+            .def_property_readonly_static
+            (
+                "INVALID"
+              , [](py::object const &) { return wrapped_type::INVALID; }
+            )
+            .def_property_readonly("ncell", &wrapped_type::ncell)
+            .def
+            (
+                "locate"
+              , [](wrapped_type const & self, array_type const & pts)
+                {
+                    real_array sarr = to_simple(pts);
+                    std::pair<serial_array, real_array> ret;
+                    {
+                        py::gil_scoped_release release;
+                        ret = self.locate(sarr);
+                    }
+                    return py::make_tuple(to_array(ret.first), to_array(ret.second));
+                }
+              , py::arg("pts")
+            )
+        ;
+
+    }
+
+}; /* end class WrapPointLocator */
+
+class WrapPointLocator2d
+  : public WrapPointLocator< WrapPointLocator2d, 2 >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "PointLocator2d";
+    static constexpr char PYDOC[] = "PointLocator2d";
+
+    friend root_base_type;
+
+    using base_type = WrapPointLocator< WrapPointLocator2d, 2 >;
+
+protected:
+
+    WrapPointLocator2d(pybind11::module & mod) : base_type(mod) {}
+
+}; /* end class WrapPointLocator2d */
+
+class WrapPointLocator3d
+  : public WrapPointLocator< WrapPointLocator3d, 3 >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "PointLocator3d";
+    static constexpr char PYDOC[] = "PointLocator3d";
+
+    friend root_base_type;
+
+    using base_type = WrapPointLocator< WrapPointLocator3d, 3 >;
+
+protected:
+
+    WrapPointLocator3d(pybind11::module & mod) : base_type(mod) {}
+
+}; /* end class WrapPointLocator3d */
+
+class WrapPoissonSolver2d
+  : public WrapBase< WrapPoissonSolver2d, PoissonSolver2d >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "PoissonSolver2d";
+    static constexpr char PYDOC[] = "PoissonSolver2d";
+
+    friend root_base_type;
+
+protected:
+
+    WrapPoissonSolver2d(pybind11::module & mod) : root_base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        using real_type = wrapped_type::real_type;
+
+        (*this)
+            .def
+            (
+                py::init<StaticGrid2d::serial_type, StaticGrid2d::serial_type, real_type, real_type>()
+              , py::arg("nx"), py::arg("ny"), py::arg("hx")=1, py::arg("hy")=1
+            )
+            .def_property_readonly("nx", &wrapped_type::nx)
+            .def_property_readonly("ny", &wrapped_type::ny)
+            .def_property_readonly("hx", &wrapped_type::hx)
+            .def_property_readonly("hy", &wrapped_type::hy)
+            .def_property_readonly("nlevel", &wrapped_type::nlevel)
+            .def
+            (
+                "residual"
+              , [](wrapped_type const & self, StaticGrid2d const & u, StaticGrid2d const & f)
+                {
+                    py::gil_scoped_release release;
+                    return self.residual(u, f);
+                }
+              , py::arg("u"), py::arg("f")
+            )
+            .def
+            (
+                "sor"
+              , [](wrapped_type const & self, StaticGrid2d & u, StaticGrid2d const & f, real_type omega, size_t nsweep)
+                {
+                    py::gil_scoped_release release;
+                    return self.sor(u, f, omega, nsweep);
+                }
+              , py::arg("u"), py::arg("f"), py::arg("omega")=1, py::arg("nsweep")=1
+            )
+            .def
+            (
+                "vcycle"
+              , [](wrapped_type & self, StaticGrid2d & u, StaticGrid2d const & f, real_type tolerance)
+                {
+                    py::gil_scoped_release release;
+                    return self.vcycle(u, f, tolerance);
+                }
+              , py::arg("u"), py::arg("f"), py::arg("tolerance")=0
+            )
+            .def
+            (
+                "solve"
+              , [](wrapped_type & self, StaticGrid2d & u, StaticGrid2d const & f, real_type tolerance, size_t max_cycle)
+                {
+                    std::pair<size_t, real_type> ret;
+                    {
+                        py::gil_scoped_release release;
+                        ret = self.solve(u, f, tolerance, max_cycle);
+                    }
+                    return py::make_tuple(ret.first, ret.second);
+                }
+              , py::arg("u"), py::arg("f"), py::arg("tolerance"), py::arg("max_cycle")=100
+            )
+        ;
+
+    }
+
+}; /* end class WrapPoissonSolver2d */
+
+class WrapPolynomialFitter
+  : public WrapBase< WrapPolynomialFitter, PolynomialFitter >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "PolynomialFitter";
+    static constexpr char PYDOC[] = "PolynomialFitter";
+
+    friend root_base_type;
+
+protected:
+
+    using real_type = wrapped_type::real_type;
+    using offset_type = wrapped_type::offset_type;
+
+    // Arrays already C-contiguous of the type are read in place.
+    template <typename T>
+    using array_type = pybind11::array_t<T, pybind11::array::c_style | pybind11::array::forcecast>;
+
+    static size_t points(array_type<real_type> const & x, array_type<real_type> const & y)
+    {
+        if (1 != x.ndim() || 1 != y.ndim() || x.size() != y.size())
+        {
+            throw pybind11::value_error("x and y must be 1D arrays of the same size");
+        }
+        return size_t(x.size());
+    }
+
+    template <typename T>
+    static size_t length(array_type<T> const & arr, char const * msg)
+    {
+        if (1 != arr.ndim()) { throw pybind11::value_error(msg); }
+        return size_t(arr.size());
+    }
+
+    /// Request the writable buffer of out, which is written in place.
+    static pybind11::buffer_info request_out(pybind11::buffer const & out, size_t ngroup, size_t ncoef)
+    {
+        pybind11::buffer_info info = out.request(/* writable */ true);
+        bool valid = pybind11::format_descriptor<real_type>::format() == info.format && 2 == info.ndim;
+        valid = valid && ngroup == size_t(info.shape[0]) && ncoef == size_t(info.shape[1]);
+        // The stride of an axis of one element does not matter.
+        valid = valid && (ngroup <= 1 || ssize_t(ncoef * sizeof(real_type)) == info.strides[0]);
+        valid = valid && (ncoef <= 1 || ssize_t(sizeof(real_type)) == info.strides[1]);
+        if (!valid)
+        {
+            throw pybind11::value_error("out must be a C-contiguous float64 array of the shape (ngroup, order+1)");
+        }
+        return info;
+    }
+
+    WrapPolynomialFitter(pybind11::module & mod) : root_base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def(py::init<size_t>(), py::arg("order"))
+            .def_property_readonly_static
+            (
+                "MAX_ORDER"
+              , [](py::object const &) { return wrapped_type::MAX_ORDER; }
+            )
+            .def_property_readonly("order", &wrapped_type::order)
+            .def_property_readonly("ncoefficient", &wrapped_type::ncoefficient)
+            .def_static
+            (
+                "bin_offsets"
+              , [](array_type<real_type> const & x, array_type<real_type> const & edges)
+                {
+                    const size_t npoint = length(x, "x must be a 1D array");
+                    const size_t nedge = length(edges, "edges must be a contiguous 1D array of at least one edge");
+                    py::array_t<offset_type> ret(std::vector<size_t>{nedge});
+                    offset_type * data = ret.mutable_data();
+                    {
+                        py::gil_scoped_release release;
+                        wrapped_type::bin_offsets(x.data(), npoint, edges.data(), nedge, data);
+                    }
+                    return ret;
+                }
+              , py::arg("x"), py::arg("edges")
+            )
+            .def
+            (
+                "fit"
+              , [](wrapped_type const & self, array_type<real_type> const & x, array_type<real_type> const & y)
+                {
+                    const size_t npoint = points(x, y);
+                    py::array_t<real_type> ret(std::vector<size_t>{self.ncoefficient()});
+                    real_type * data = ret.mutable_data();
+                    {
+                        py::gil_scoped_release release;
+                        self.fit(x.data(), y.data(), npoint, data);
+                    }
+                    return ret;
+                }
+              , py::arg("x"), py::arg("y")
+            )
+            .def
+            (
+                "fit_bins"
+              , [](wrapped_type const & self, array_type<real_type> const & x, array_type<real_type> const & y, array_type<real_type> const & edges)
+                {
+                    const size_t npoint = points(x, y);
+                    const size_t nedge = length(edges, "edges must be a contiguous 1D array of at least one edge");
+                    py::array_t<real_type> ret(std::vector<size_t>{nedge ? nedge-1 : 0, self.ncoefficient()});
+                    real_type * data = ret.mutable_data();
+                    {
+                        py::gil_scoped_release release;
+                        self.fit_bins(x.data(), y.data(), npoint, edges.data(), nedge, data);
+                    }
+                    return ret;
+                }
+              , py::arg("x"), py::arg("y"), py::arg("edges")
+            )
+            .def
+            (
+                "fit_bins"
+              , [](wrapped_type const & self, array_type<real_type> const & x, array_type<real_type> const & y, array_type<real_type> const & edges, py::buffer const & out)
+                {
+                    const size_t npoint = points(x, y);
+                    const size_t nedge = length(edges, "edges must be a contiguous 1D array of at least one edge");
+                    py::buffer_info info = request_out(out, nedge ? nedge-1 : 0, self.ncoefficient());
+                    py::gil_scoped_release release;
+                    self.fit_bins(x.data(), y.data(), npoint, edges.data(), nedge, static_cast<real_type *>(info.ptr));
+                }
+              , py::arg("x"), py::arg("y"), py::arg("edges"), py::arg("out")
+            )
+            .def
+            (
+                "fit_groups"
+              , [](wrapped_type const & self, array_type<real_type> const & x, array_type<real_type> const & y, array_type<offset_type> const & offsets)
+                {
+                    const size_t npoint = points(x, y);
+                    const size_t noffset = length(offsets, "offsets must be a contiguous 1D array of at least one offset");
+                    py::array_t<real_type> ret(std::vector<size_t>{noffset ? noffset-1 : 0, self.ncoefficient()});
+                    real_type * data = ret.mutable_data();
+                    {
+                        py::gil_scoped_release release;
+                        self.fit_groups(x.data(), y.data(), npoint, offsets.data(), noffset, data);
+                    }
+                    return ret;
+                }
+              , py::arg("x"), py::arg("y"), py::arg("offsets")
+            )
+            .def
+            (
+                "fit_groups"
+              , [](wrapped_type const & self, array_type<real_type> const & x, array_type<real_type> const & y, array_type<offset_type> const & offsets, py::buffer const & out)
+                {
+                    const size_t npoint = points(x, y);
+                    const size_t noffset = length(offsets, "offsets must be a contiguous 1D array of at least one offset");
+                    py::buffer_info info = request_out(out, noffset ? noffset-1 : 0, self.ncoefficient());
+                    py::gil_scoped_release release;
+                    self.fit_groups(x.data(), y.data(), npoint, offsets.data(), noffset, static_cast<real_type *>(info.ptr));
+                }
+              , py::arg("x"), py::arg("y"), py::arg("offsets"), py::arg("out")
+            )
+        ;
+
+    }
+
+}; /* end class WrapPolynomialFitter */
+
+class WrapClock
+  : public WrapBase< WrapClock, Clock >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "Clock";
+    static constexpr char PYDOC[] = "Clock";
+
+    friend root_base_type;
+
+protected:
+
+    WrapClock(pybind11::module & mod) : root_base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def_property_readonly_static("me", [](py::object const &) -> wrapped_type& { return wrapped_type::me(); })
+            .def_property_readonly_static
+            (
+                "has_invariant_tsc"
+              , [](py::object const &) { return wrapped_type::has_invariant_tsc(); }
+            )
+            .def_property
+            (
+                "source"
+              , [](wrapped_type const & self) { return wrapped_type::name(self.source()); }
+              , [](wrapped_type & self, std::string const & name) { self.set_source(wrapped_type::from_name(name)); }
+            )
+            .def_property_readonly("frequency", &wrapped_type::frequency)
+        ;
+
+    }
+
+}; /* end class WrapClock */
+
+class WrapKernelPool
+  : public WrapBase< WrapKernelPool, KernelPool >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "KernelPool";
+    static constexpr char PYDOC[] = "KernelPool";
+
+    friend root_base_type;
+
+protected:
+
+    WrapKernelPool(pybind11::module & mod) : root_base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def_property_readonly_static("me", [](py::object const &) -> wrapped_type& { return wrapped_type::me(); })
+            .def_property("nthread", &wrapped_type::nthread, &wrapped_type::set_nthread)
+            .def_property("threshold", &wrapped_type::threshold, &wrapped_type::set_threshold)
+            .def_property("stream_threshold", &wrapped_type::stream_threshold, &wrapped_type::set_stream_threshold)
+            .def
+            (
+                "run"
+              , [](wrapped_type & self, size_t size, py::function const & func)
+                {
+                    // The threads take the GIL in turn to call func(begin, end, ichunk).
+                    py::gil_scoped_release release;
+                    self.run
+                    (
+                        size
+                      , [&func](size_t begin, size_t end, size_t ick)
+                        {
+                            py::gil_scoped_acquire acquire;
+                            func(begin, end, ick);
+                        }
+                    );
+                }
+              , py::arg("size"), py::arg("func")
+            )
+            .def
+            (
+                "run_tasks"
+              , [](wrapped_type & self, size_t ntask, py::function const & func)
+                {
+                    py::gil_scoped_release release;
+                    self.run_tasks
+                    (
+                        ntask
+                      , [&func](size_t itask)
+                        {
+                            py::gil_scoped_acquire acquire;
+                            func(itask);
+                        }
+                    );
+                }
+              , py::arg("ntask"), py::arg("func")
+            )
+        ;
+
+    }
+
+}; /* end class WrapKernelPool */
+
+class WrapTimeRegistry
   : public WrapBase< WrapTimeRegistry, TimeRegistry >
 {
 
@@ -304,12 +2419,203 @@ protected:
         (*this)
             .def_property_readonly_static("me", [](py::object const &) -> wrapped_type& { return wrapped_type::me(); })
             .def("report", &wrapped_type::report)
+            .def
+            (
+                "snapshot"
+              , [](wrapped_type & self, bool reset)
+                {
+                    py::dict ret;
+                    for (auto const & item : self.snapshot(reset))
+                    {
+                        TimedEntry const & entry = item.second;
+                        LatencyHistogram const & latency = entry.m_latency;
+                        // Lower bounds in second and counts of the non-empty buckets.
+                        std::vector<double> lower;
+                        std::vector<uint64_t> count;
+                        for (size_t it=0; it<LatencyHistogram::NBUCKET; ++it)
+                        {
+                            if (!latency[it]) { continue; }
+                            lower.push_back(LatencyHistogram::lower(it) * 1.e-9);
+                            count.push_back(latency[it]);
+                        }
+                        py::dict stat;
+                        stat["count"] = entry.m_count;
+                        stat["time"] = entry.m_time;
+                        stat["bytes"] = entry.m_bytes;
+                        stat["min"] = latency.min() * 1.e-9;
+                        stat["p50"] = latency.percentile(0.5) * 1.e-9;
+                        stat["p90"] = latency.percentile(0.9) * 1.e-9;
+                        stat["p99"] = latency.percentile(0.99) * 1.e-9;
+                        stat["max"] = latency.max() * 1.e-9;
+                        // Zero for the events not counted.
+                        py::dict event;
+                        for (size_t it=0; it<PerfCounter::NEVENT; ++it) { event[PerfCounter::name(it)] = entry.m_event[it]; }
+                        stat["ncounted"] = entry.m_ncounted;
+                        stat["events"] = event;
+                        stat["histogram"] = py::make_tuple(py::array(py::cast(lower)), py::array(py::cast(count)));
+                        ret[py::str(item.first)] = stat;
+                    }
+                    return ret;
+                }
+              , py::arg("reset")=false
+            )
+            .def("reset", &wrapped_type::reset)
+            .def
+            (
+                "add"
+              , [](wrapped_type & self, std::string const & name, double time) { self.add(name.c_str(), time); }
+              , py::arg("name"), py::arg("time")
+            )
+            .def
+            (
+                "enable"
+              , [](wrapped_type & self, py::object const & name)
+                {
+                    if (name.is_none()) { self.set_enabled(true); }
+                    else { self.set_enabled(name.cast<std::string>().c_str(), true); }
+                }
+              , py::arg("name")=py::none()
+            )
+            .def
+            (
+                "disable"
+              , [](wrapped_type & self, py::object const & name)
+                {
+                    if (name.is_none()) { self.set_enabled(false); }
+                    else { self.set_enabled(name.cast<std::string>().c_str(), false); }
+                }
+              , py::arg("name")=py::none()
+            )
+            .def
+            (
+                "is_enabled"
+              , [](wrapped_type & self, std::string const & name) { return self.enabled(name.c_str()); }
+              , py::arg("name")
+            )
+            .def("report_tree", &wrapped_type::report_tree)
+            .def("chrome_trace", &wrapped_type::chrome_trace)
+            .def_property("call_tree", &wrapped_type::call_tree, &wrapped_type::set_call_tree)
+            .def_property("trace", &wrapped_type::trace, &wrapped_type::set_trace)
+            .def_property("trace_capacity", &wrapped_type::trace_capacity, &wrapped_type::set_trace_capacity)
+            .def_property("counters", &wrapped_type::counters, &wrapped_type::set_counters)
+            .def_property_readonly
+            (
+                "counters_available"
+              , [](wrapped_type const & self)
+                {
+                    std::vector<std::string> ret;
+                    for (size_t it=0; it<PerfCounter::NEVENT; ++it)
+                    {
+                        if (self.counter_mask() & (1u << it)) { ret.emplace_back(PerfCounter::name(it)); }
+                    }
+                    return ret;
+                }
+            )
         ;
 
     }
 
 }; /* end class WrapTimeRegistry */
 
+/**
+ * Timed scope used as a Python context manager, so that Python code shows
+ * in the same call tree and timeline as the C++ scopes it calls.
+ *
+ * The call tree of a thread is a stack, so the scopes a thread enters are
+ * kept in a thread-local stack too.  Exiting any but the innermost scope of
+ * the calling thread raises instead of corrupting the call tree.
+ */
+class TimedScope
+{
+
+public:
+
+    TimedScope(std::string const & name) : m_id(TimeRegistry::me().id(name.c_str())) {}
+
+    TimedScope(TimedScope const & ) = delete;
+    TimedScope(TimedScope       &&) = delete;
+    TimedScope & operator=(TimedScope const & ) = delete;
+    TimedScope & operator=(TimedScope       &&) = delete;
+
+    ~TimedScope()
+    {
+        // A scope collected while entered must not stay on the stack.
+        std::vector<TimedScope *> & entered = stack();
+        auto it = std::find(entered.begin(), entered.end(), this);
+        if (it != entered.end()) { entered.erase(it); }
+    }
+
+    void enter()
+    {
+        if (m_timer)
+        {
+            MODMESH_EXCEPT(TimedScope, std::runtime_error, "already entered");
+        }
+        m_timer = std::make_unique<ScopedTimer>(m_id);
+        stack().push_back(this);
+    }
+
+    void exit()
+    {
+        std::vector<TimedScope *> & entered = stack();
+        if (!m_timer || entered.empty() || entered.back() != this)
+        {
+            MODMESH_EXCEPT(TimedScope, std::runtime_error, "not the innermost scope entered in this thread");
+        }
+        m_timer.reset();
+        entered.pop_back();
+    }
+
+private:
+
+    static std::vector<TimedScope *> & stack()
+    {
+        thread_local std::vector<TimedScope *> inst;
+        return inst;
+    }
+
+    size_t m_id;
+    std::unique_ptr<ScopedTimer> m_timer;
+
+}; /* end class TimedScope */
+
+class WrapTimedScope
+  : public WrapBase< WrapTimedScope, TimedScope >
+{
+
+public:
+
+    static constexpr char PYNAME[] = "TimedScope";
+    static constexpr char PYDOC[] = "TimedScope";
+
+    friend root_base_type;
+
+protected:
+
+    WrapTimedScope(pybind11::module & mod) : root_base_type(mod)
+    {
+
+        namespace py = pybind11;
+
+        (*this)
+            .def(py::init<std::string const &>(), py::arg("name"))
+            .def
+            (
+                "__enter__"
+              , [](wrapped_type & self) -> wrapped_type & { self.enter(); return self; }
+              , py::return_value_policy::reference_internal
+            )
+            .def
+            (
+                "__exit__"
+              , [](wrapped_type & self, py::object const &, py::object const &, py::object const &) { self.exit(); }
+            )
+        ;
+
+    }
+
+}; /* end class WrapTimedScope */
+
 } /* end namespace python */
 
 } /* end namespace modmesh */
@@ -0,0 +1,322 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD-style license; see COPYING
+ */
+
+/**
+ * Orderings of graphs and points for locality of memory access.
+ */
+
+#include "modmesh/base.hpp"
+#include "modmesh/buffer.hpp"
+#include "modmesh/kernel.hpp"
+#include "modmesh/profile.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * How to order the cells or the nodes of a mesh.
+ */
+enum class ReorderMethod
+{
+    /// Reverse Cuthill-McKee; breadth-first over the adjacency.
+    RCM,
+    /// Along the Hilbert curve through the coordinates.
+    HILBERT,
+    /// Along the Morton (Z-order) curve through the coordinates.
+    MORTON,
+}; /* end enum class ReorderMethod */
+
+/**
+ * An order is a permutation listing the old index of every new index.
+ */
+namespace reorder
+{
+
+using serial_type = uint32_t;
+using serial_array = SimpleArray<serial_type>;
+
+/// Throw if the order is not a permutation of size items.
+inline void validate(serial_array const & order, size_t size)
+{
+    if (order.size() != size)
+    {
+        MODMESH_EXCEPT(reorder, std::invalid_argument, "order must be of the same size as the items");
+    }
+    std::vector<uint8_t> seen(size, 0);
+    for (size_t it=0; it<size; ++it)
+    {
+        if (order[it] >= size || seen[order[it]])
+        {
+            MODMESH_EXCEPT(reorder, std::invalid_argument, "order must be a permutation");
+        }
+        seen[order[it]] = 1;
+    }
+}
+
+/// New index of every old index.  Throw if the order is not a permutation.
+inline serial_array inverse(serial_array const & order, size_t size)
+{
+    validate(order, size);
+    serial_array ret(size);
+    for (size_t it=0; it<size; ++it) { ret[order[it]] = serial_type(it); }
+    return ret;
+}
+
+/// Rows of the array in the order.
+template <typename T>
+SimpleArray<T> permute(SimpleArray<T> const & arr, serial_array const & order)
+{
+    if (0 == arr.ndim() || !arr.is_contiguous() || arr.shape(0) != order.size())
+    {
+        MODMESH_EXCEPT(reorder, std::invalid_argument, "array must be contiguous with one row per item");
+    }
+    SimpleArray<T> ret(arr.shape());
+    const size_t row = arr.shape(0) ? arr.size() / arr.shape(0) : 0;
+    KernelPool::me().run
+    (
+        order.size()
+      , [&](size_t begin, size_t end, size_t)
+        {
+            for (size_t it=begin; it<end; ++it)
+            {
+                std::copy_n(arr.data() + order[it] * row, row, ret.data() + it * row);
+            }
+        }
+    );
+    return ret;
+}
+
+/**
+ * Reverse Cuthill-McKee order of the graph in CSR.  Every connected
+ * component starts from a pseudo-peripheral vertex found by repeated
+ * breadth-first search (George and Liu), and the neighbors are visited by
+ * increasing degree.
+ */
+inline serial_array rcm(serial_array const & xadj, serial_array const & adjncy)
+{
+    MODMESH_TIME("reorder::rcm");
+    if (0 == xadj.size() || 0 != xadj[0] || xadj[xadj.size()-1] != adjncy.size() || !std::is_sorted(xadj.data(), xadj.data() + xadj.size()))
+    {
+        MODMESH_EXCEPT(reorder, std::invalid_argument, "xadj must ascend from 0 to the size of adjncy");
+    }
+    const size_t nv = xadj.size() - 1;
+    for (size_t ie=0; ie<adjncy.size(); ++ie)
+    {
+        if (adjncy[ie] >= nv)
+        {
+            MODMESH_EXCEPT(reorder, std::invalid_argument, "adjncy must be vertices of the graph");
+        }
+    }
+    auto degree = [&](serial_type iv) { return xadj[iv+1] - xadj[iv]; };
+
+    std::vector<serial_type> order;
+    order.reserve(nv);
+    std::vector<uint8_t> visited(nv, 0);
+    // Level structure of the peripheral search, by stamp.
+    std::vector<serial_type> stamp(nv, 0);
+    serial_type current = 0;
+    std::vector<serial_type> queue;
+    queue.reserve(nv);
+    std::vector<serial_type> next;
+
+    // Breadth-first search in the component; return the last level.
+    auto levels = [&](serial_type root, size_t & depth)
+    {
+        ++current;
+        queue.clear();
+        queue.push_back(root);
+        stamp[root] = current;
+        size_t head = 0;
+        size_t level_begin = 0;
+        depth = 0;
+        while (head < queue.size())
+        {
+            const size_t level_end = queue.size();
+            level_begin = head;
+            for (; head<level_end; ++head)
+            {
+                const serial_type iv = queue[head];
+                for (size_t ie=xadj[iv]; ie<xadj[iv+1]; ++ie)
+                {
+                    const serial_type jv = adjncy[ie];
+                    if (stamp[jv] != current) { stamp[jv] = current; queue.push_back(jv); }
+                }
+            }
+            ++depth;
+        }
+        return level_begin;
+    };
+
+    for (size_t seed=0; seed<nv; ++seed)
+    {
+        if (visited[seed]) { continue; }
+
+        // Pseudo-peripheral vertex: the least-degree vertex of the last level
+        // while the depth grows.
+        serial_type root = serial_type(seed);
+        size_t depth = 0;
+        size_t last = levels(root, depth);
+        for (size_t iter=0; iter<8; ++iter)
+        {
+            serial_type best = queue[last];
+            for (size_t it=last; it<queue.size(); ++it)
+            {
+                if (degree(queue[it]) < degree(best)) { best = queue[it]; }
+            }
+            size_t new_depth = 0;
+            const size_t new_last = levels(best, new_depth);
+            if (new_depth <= depth) { break; }
+            root = best;
+            depth = new_depth;
+            last = new_last;
+        }
+
+        // Cuthill-McKee from the root.
+        size_t head = order.size();
+        order.push_back(root);
+        visited[root] = 1;
+        while (head < order.size())
+        {
+            const serial_type iv = order[head++];
+            next.clear();
+            for (size_t ie=xadj[iv]; ie<xadj[iv+1]; ++ie)
+            {
+                const serial_type jv = adjncy[ie];
+                if (!visited[jv]) { visited[jv] = 1; next.push_back(jv); }
+            }
+            std::sort
+            (
+                next.begin(), next.end()
+              , [&](serial_type a, serial_type b) { return degree(a) != degree(b) ? degree(a) < degree(b) : a < b; }
+            );
+            order.insert(order.end(), next.begin(), next.end());
+        }
+    }
+
+    serial_array ret(nv);
+    std::copy(order.rbegin(), order.rend(), ret.data());
+    return ret;
+}
+
+namespace detail
+{
+
+/// Hilbert transform of the coordinates in place, from "Programming the
+/// Hilbert curve" by John Skilling (2004).
+inline void hilbert_transpose(uint32_t * x, size_t nd, size_t nbit)
+{
+    const uint32_t high = uint32_t(1) << (nbit-1);
+    for (uint32_t q=high; q>1; q>>=1)
+    {
+        const uint32_t p = q - 1;
+        for (size_t it=0; it<nd; ++it)
+        {
+            if (x[it] & q) { x[0] ^= p; }
+            else
+            {
+                const uint32_t t = (x[0] ^ x[it]) & p;
+                x[0] ^= t;
+                x[it] ^= t;
+            }
+        }
+    }
+    for (size_t it=1; it<nd; ++it) { x[it] ^= x[it-1]; }
+    uint32_t t = 0;
+    for (uint32_t q=high; q>1; q>>=1)
+    {
+        if (x[nd-1] & q) { t ^= q - 1; }
+    }
+    for (size_t it=0; it<nd; ++it) { x[it] ^= t; }
+}
+
+/// Interleave the bits from the highest, the first axis first.
+inline uint64_t interleave(uint32_t const * x, size_t nd, size_t nbit)
+{
+    uint64_t ret = 0;
+    for (size_t ibit=nbit; ibit>0; --ibit)
+    {
+        for (size_t it=0; it<nd; ++it) { ret = (ret << 1) | ((x[it] >> (ibit-1)) & 1); }
+    }
+    return ret;
+}
+
+} /* end namespace detail */
+
+/**
+ * Order of the (npoint, nd) points along the Hilbert or Morton curve
+ * through their bounding box.
+ */
+inline serial_array curve(SimpleArray<double> const & crd, ReorderMethod method)
+{
+    MODMESH_TIME("reorder::curve");
+    if (2 != crd.ndim() || 0 == crd.shape(1) || crd.shape(1) > 3 || !crd.is_contiguous())
+    {
+        MODMESH_EXCEPT(reorder, std::invalid_argument, "coordinates must be (npoint, nd) with nd up to 3");
+    }
+    if (ReorderMethod::HILBERT != method && ReorderMethod::MORTON != method)
+    {
+        MODMESH_EXCEPT(reorder, std::invalid_argument, "method must be a curve");
+    }
+    const size_t npt = crd.shape(0);
+    const size_t nd = crd.shape(1);
+    // Keep the key in 64 bits.
+    const size_t nbit = std::min(size_t(64 / nd), size_t(31));
+
+    double lower[3];
+    double upper[3];
+    for (size_t idm=0; idm<nd; ++idm)
+    {
+        lower[idm] = std::numeric_limits<double>::max();
+        upper[idm] = std::numeric_limits<double>::lowest();
+    }
+    for (size_t ipt=0; ipt<npt; ++ipt)
+    {
+        for (size_t idm=0; idm<nd; ++idm)
+        {
+            lower[idm] = std::min(lower[idm], crd(ipt, idm));
+            upper[idm] = std::max(upper[idm], crd(ipt, idm));
+        }
+    }
+
+    std::vector<std::pair<uint64_t, serial_type>> key(npt);
+    const double scale = double((uint64_t(1) << nbit) - 1);
+    KernelPool::me().run
+    (
+        npt
+      , [&](size_t begin, size_t end, size_t)
+        {
+            uint32_t x[3];
+            for (size_t ipt=begin; ipt<end; ++ipt)
+            {
+                for (size_t idm=0; idm<nd; ++idm)
+                {
+                    const double span = upper[idm] - lower[idm];
+                    x[idm] = span > 0 ? uint32_t((crd(ipt, idm) - lower[idm]) / span * scale) : 0;
+                }
+                if (ReorderMethod::HILBERT == method) { detail::hilbert_transpose(x, nd, nbit); }
+                key[ipt] = {detail::interleave(x, nd, nbit), serial_type(ipt)};
+            }
+        }
+    );
+    std::sort(key.begin(), key.end());
+
+    serial_array ret(npt);
+    for (size_t ipt=0; ipt<npt; ++ipt) { ret[ipt] = key[ipt].second; }
+    return ret;
+}
+
+} /* end namespace reorder */
+
+} /* end namespace modmesh */
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
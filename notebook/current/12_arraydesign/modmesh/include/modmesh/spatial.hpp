@@ -0,0 +1,1343 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD-style license; see COPYING
+ */
+
+/**
+ * Spatial index over points, segments, and boxes.
+ */
+
+#include "modmesh/base.hpp"
+#include "modmesh/buffer.hpp"
+#include "modmesh/kernel.hpp"
+#include "modmesh/profile.hpp"
+#include "modmesh/reorder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * Axis-aligned bounding box.  The empty box has lower bounds above the upper
+ * bounds, so that expanding it by anything gives that thing.
+ */
+template <size_t ND>
+struct BoundBox
+{
+
+    using real_type = double;
+
+    std::array<real_type, ND> lo;
+    std::array<real_type, ND> hi;
+
+    static BoundBox empty()
+    {
+        BoundBox ret;
+        ret.lo.fill(std::numeric_limits<real_type>::max());
+        ret.hi.fill(std::numeric_limits<real_type>::lowest());
+        return ret;
+    }
+
+    void expand(BoundBox const & other)
+    {
+        for (size_t it=0; it<ND; ++it)
+        {
+            lo[it] = std::min(lo[it], other.lo[it]);
+            hi[it] = std::max(hi[it], other.hi[it]);
+        }
+    }
+
+    void expand(real_type const * pt)
+    {
+        for (size_t it=0; it<ND; ++it)
+        {
+            lo[it] = std::min(lo[it], pt[it]);
+            hi[it] = std::max(hi[it], pt[it]);
+        }
+    }
+
+    bool overlaps(BoundBox const & other) const
+    {
+        for (size_t it=0; it<ND; ++it)
+        {
+            if (lo[it] > other.hi[it] || hi[it] < other.lo[it]) { return false; }
+        }
+        return true;
+    }
+
+    bool contains(real_type const * pt) const
+    {
+        for (size_t it=0; it<ND; ++it)
+        {
+            if (pt[it] < lo[it] || pt[it] > hi[it]) { return false; }
+        }
+        return true;
+    }
+
+    /// Squared distance from the point; 0 inside.
+    real_type distance2(real_type const * pt) const
+    {
+        real_type ret = 0;
+        for (size_t it=0; it<ND; ++it)
+        {
+            const real_type out = std::max(std::max(lo[it] - pt[it], pt[it] - hi[it]), real_type(0));
+            ret += out * out;
+        }
+        return ret;
+    }
+
+    /// Half of the surface area in 3D and of the perimeter in 2D, in
+    /// proportion to the chance a random ray hits the box.
+    real_type half_area() const
+    {
+        if (lo[0] > hi[0]) { return 0; }
+        if (2 == ND) { return (hi[0] - lo[0]) + (hi[1] - lo[1]); }
+        real_type ret = 0;
+        for (size_t it=0; it<ND; ++it)
+        {
+            ret += (hi[it] - lo[it]) * (hi[(it+1)%ND] - lo[(it+1)%ND]);
+        }
+        return ret;
+    }
+
+}; /* end struct BoundBox */
+
+/**
+ * Kind of the items in a SpatialIndex.
+ */
+enum class SpatialKind
+{
+    /// One point per item.
+    POINT,
+    /// Two end points per item.
+    SEGMENT,
+    /// Lower and upper corners per item.
+    BOX,
+}; /* end enum class SpatialKind */
+
+/**
+ * Batched queries over a spatial index, run in parallel over the queries.
+ * Batches of at least SORT_BATCH queries are answered in the order of the
+ * Morton curve through them, so that consecutive queries visit the same
+ * nodes; the results stay in the order of the queries.
+ */
+namespace spatial
+{
+
+using serial_type = uint32_t;
+using real_type = double;
+using serial_array = SimpleArray<serial_type>;
+using real_array = SimpleArray<real_type>;
+
+constexpr size_t SORT_BATCH = 4096;
+
+/// Order to answer the (nquery, ND) points or (nquery, 2, ND) boxes in.
+template <size_t ND>
+serial_array query_order(real_array const & query)
+{
+    const size_t nquery = query.shape(0);
+    if (nquery < SORT_BATCH)
+    {
+        serial_array ret(nquery);
+        for (size_t iq=0; iq<nquery; ++iq) { ret[iq] = serial_type(iq); }
+        return ret;
+    }
+    if (2 == query.ndim()) { return reorder::curve(query, ReorderMethod::MORTON); }
+    real_array center(std::vector<size_t>{nquery, ND});
+    for (size_t iq=0; iq<nquery; ++iq)
+    {
+        for (size_t idm=0; idm<ND; ++idm) { center(iq, idm) = (query(iq, 0, idm) + query(iq, 1, idm)) / 2; }
+    }
+    return reorder::curve(center, ReorderMethod::MORTON);
+}
+
+/**
+ * Items found for every one of the (nquery, 2, ND) boxes by
+ * each(box, emit), which calls emit(item) per item, in the CSR format: the
+ * items of query i are ids[offset[i]:offset[i+1]].
+ */
+template <size_t ND, typename F>
+std::pair<serial_array, serial_array> range(real_array const & query, F && each)
+{
+    const size_t nquery = query.shape(0);
+    const serial_array order = query_order<ND>(query);
+    serial_array offset(nquery+1);
+    offset[0] = 0;
+    KernelPool & pool = KernelPool::me();
+    const size_t nck = pool.nchunk(nquery);
+    // Items found by every chunk, and where the items of every query start
+    // in them.
+    std::vector<std::vector<serial_type>> found(nck);
+    std::vector<size_t> start(nquery);
+    std::vector<serial_type> owner(nquery);
+    pool.run
+    (
+        nquery, nck
+      , [&](size_t begin, size_t end, size_t ick)
+        {
+            std::vector<serial_type> & out = found[ick];
+            auto emit = [&out](serial_type item) { out.push_back(item); };
+            for (size_t it=begin; it<end; ++it)
+            {
+                const size_t iq = order[it];
+                start[iq] = out.size();
+                owner[iq] = serial_type(ick);
+                BoundBox<ND> box;
+                std::copy_n(query.data() + iq*2*ND, ND, box.lo.data());
+                std::copy_n(query.data() + iq*2*ND + ND, ND, box.hi.data());
+                each(box, emit);
+                offset[iq+1] = serial_type(out.size() - start[iq]);
+            }
+        }
+    );
+    for (size_t iq=0; iq<nquery; ++iq) { offset[iq+1] += offset[iq]; }
+    serial_array ids(offset[nquery]);
+    pool.run
+    (
+        nquery
+      , [&](size_t begin, size_t end, size_t)
+        {
+            for (size_t iq=begin; iq<end; ++iq)
+            {
+                serial_type const * src = found[owner[iq]].data() + start[iq];
+                std::copy(src, src + (offset[iq+1] - offset[iq]), ids.data() + offset[iq]);
+            }
+        }
+    );
+    return {offset, ids};
+}
+
+/**
+ * The k nearest items of every one of the (nquery, ND) points by
+ * each(pt, k, ids, dist), as (nquery, k) arrays of the items and the
+ * distances.
+ */
+template <size_t ND, typename F>
+std::pair<serial_array, real_array> nearest(real_array const & query, size_t k, F && each)
+{
+    const size_t nquery = query.shape(0);
+    const serial_array order = query_order<ND>(query);
+    serial_array ids(std::vector<size_t>{nquery, k});
+    real_array dist(std::vector<size_t>{nquery, k});
+    KernelPool::me().run
+    (
+        nquery
+      , [&](size_t begin, size_t end, size_t)
+        {
+            for (size_t it=begin; it<end; ++it)
+            {
+                const size_t iq = order[it];
+                each(query.data() + iq*ND, k, ids.data() + iq*k, dist.data() + iq*k);
+            }
+        }
+    );
+    return {ids, dist};
+}
+
+} /* end namespace spatial */
+
+/**
+ * Bounding volume hierarchy (BVH) over points, segments, or boxes, bulk
+ * loaded top down by binned surface area heuristic (SAH) splits.  The nodes
+ * are stored in a flat array of cache-line-sized records.  The two children
+ * of an inner node are adjacent.  A leaf lists its items in a slice of the
+ * item array.
+ *
+ * The upper levels are split on the calling thread, and the subtrees below
+ * them are built as tasks on KernelPool.  The batched queries run in
+ * parallel over the queries.
+ *
+ * Items may be inserted, removed, and moved (refit) in batches.  An inserted
+ * item goes down to the leaf whose box grows the least; a full leaf moves
+ * its slice to the end of the item array with room to grow, and splits
+ * beyond LEAF_SIZE.  The boxes of the touched nodes are then refitted bottom
+ * up.  The tree is cut into units, the subtrees of at most UNIT_SIZE items
+ * when built, and a unit is rebuilt once its SAH cost per unit area exceeds
+ * REBUILD_RATIO times the cost when built.  The whole tree is rebuilt when
+ * the root degrades or the item array is mostly holes.
+ */
+template <size_t ND>
+class SpatialIndex
+  : public SpaceBase<ND>
+{
+
+public:
+
+    using serial_type = typename SpaceBase<ND>::serial_type;
+    using real_type = typename SpaceBase<ND>::real_type;
+    using box_type = BoundBox<ND>;
+    using serial_array = SimpleArray<serial_type>;
+    using real_array = SimpleArray<real_type>;
+
+    static constexpr serial_type INVALID = std::numeric_limits<serial_type>::max();
+    /// Most items in a leaf.
+    static constexpr size_t LEAF_SIZE = 8;
+    /// Items in a leaf below which SAH is not consulted.
+    static constexpr size_t LEAF_MIN = 4;
+    /// Cost of visiting a node relative to testing an item, for SAH.
+    static constexpr real_type TRAVERSAL_COST = 2;
+    /// Depth beyond which the items are halved instead of split by SAH, to
+    /// bound the traversal stacks.
+    static constexpr size_t SAH_DEPTH = 48;
+    static constexpr size_t STACK_SIZE = SAH_DEPTH + 40;
+    /// Most items in a unit of rebuild.
+    static constexpr size_t UNIT_SIZE = 4096;
+    /// Degradation of the SAH cost that triggers a rebuild.
+    static constexpr real_type REBUILD_RATIO = 1.5;
+
+    struct alignas(64) Node
+    {
+        box_type box;
+        /// First child for an inner node, or the first slot in the item
+        /// array for a leaf.
+        serial_type first;
+        /// Number of items of a leaf.
+        serial_type count;
+        serial_type parent;
+        /// Slots reserved by a leaf; 0 for an inner node.
+        serial_type capacity;
+
+        bool is_leaf() const { return capacity > 0; }
+    };
+
+    SpatialIndex() = default;
+
+    /// Index over the (n, ND) points.
+    static SpatialIndex points(real_array const & crd) { return SpatialIndex(SpatialKind::POINT, crd); }
+    /// Index over the (n, 2, ND) segments.
+    static SpatialIndex segments(real_array const & crd) { return SpatialIndex(SpatialKind::SEGMENT, crd); }
+    /// Index over the (n, 2, ND) boxes of the lower and upper corners.
+    static SpatialIndex boxes(real_array const & crd) { return SpatialIndex(SpatialKind::BOX, crd); }
+
+    SpatialIndex(SpatialKind kind, real_array const & crd)
+      : m_kind(kind)
+    {
+        validate(crd);
+        const size_t nitem = crd.shape(0);
+        resize_items(nitem);
+        set_items(nitem, [](size_t it) { return serial_type(it); }, crd.data());
+        // Mark every item alive for build().
+        std::fill(m_slot.begin(), m_slot.end(), serial_type(0));
+        build();
+    }
+
+    SpatialIndex(SpatialIndex const & ) = default;
+    SpatialIndex(SpatialIndex       &&) = default;
+    SpatialIndex & operator=(SpatialIndex const & ) = default;
+    SpatialIndex & operator=(SpatialIndex       &&) = default;
+    ~SpatialIndex() = default;
+
+    SpatialKind kind() const { return m_kind; }
+    /// Number of items.
+    size_t size() const { return m_box.size() - m_free.size(); }
+    /// One past the largest item id; removed ids are reused by insert().
+    size_t nid() const { return m_box.size(); }
+    bool alive(serial_type item) const { return item < m_slot.size() && INVALID != m_slot[item]; }
+    size_t nnode() const { return m_node.size(); }
+    std::vector<Node> const & nodes() const { return m_node; }
+    box_type const & item_box(size_t it) const { return m_box[it]; }
+    box_type bound() const { return m_node.empty() ? box_type::empty() : m_node[0].box; }
+
+    /// SAH cost of the tree per unit area relative to that when it was
+    /// built.
+    real_type quality() const { return m_node.empty() ? 1 : ratio(0); }
+
+    /// Number of levels of the tree.
+    size_t depth() const
+    {
+        size_t ret = 0;
+        std::vector<std::pair<serial_type, size_t>> stack;
+        if (!m_node.empty()) { stack.emplace_back(0, 1); }
+        while (!stack.empty())
+        {
+            const auto top = stack.back();
+            stack.pop_back();
+            ret = std::max(ret, top.second);
+            Node const & node = m_node[top.first];
+            if (!node.is_leaf())
+            {
+                stack.emplace_back(node.first, top.second+1);
+                stack.emplace_back(node.first+1, top.second+1);
+            }
+        }
+        return ret;
+    }
+
+    /// Call func(item) for every item overlapping the box.
+    template <typename F>
+    void range(box_type const & query, F && func) const
+    {
+        if (m_node.empty()) { return; }
+        serial_type stack[STACK_SIZE];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top)
+        {
+            Node const & node = m_node[stack[--top]];
+            if (!node.box.overlaps(query)) { continue; }
+            if (node.is_leaf())
+            {
+                for (size_t it=node.first; it<node.first+node.count; ++it)
+                {
+                    if (overlaps(slot_coord(it), query)) { func(m_item[it]); }
+                }
+            }
+            else
+            {
+                stack[top++] = node.first + 1;
+                stack[top++] = node.first;
+            }
+        }
+    }
+
+    /**
+     * The k nearest items of the point by increasing distance.  The slots
+     * beyond the number of items get INVALID and infinity.
+     */
+    void nearest(real_type const * pt, size_t k, serial_type * ids, real_type * dist) const
+    {
+        using entry_type = std::pair<real_type, serial_type>;
+        // Max-heap of the best candidates by squared distance, on the stack
+        // for small k.
+        constexpr size_t nsmall = 16;
+        entry_type small[nsmall];
+        std::vector<entry_type> large;
+        entry_type * heap = small;
+        if (k > nsmall)
+        {
+            large.resize(k);
+            heap = large.data();
+        }
+        std::fill(heap, heap+k, entry_type(std::numeric_limits<real_type>::infinity(), INVALID));
+        if (k && !m_node.empty())
+        {
+            std::pair<serial_type, real_type> stack[STACK_SIZE];
+            size_t top = 0;
+            stack[top++] = {0, m_node[0].box.distance2(pt)};
+            while (top)
+            {
+                const auto entry = stack[--top];
+                if (entry.second >= heap[0].first) { continue; }
+                Node const & node = m_node[entry.first];
+                if (node.is_leaf())
+                {
+                    for (size_t it=node.first; it<node.first+node.count; ++it)
+                    {
+                        const real_type d2 = distance2(slot_coord(it), pt);
+                        if (d2 < heap[0].first)
+                        {
+                            std::pop_heap(heap, heap+k);
+                            heap[k-1] = {d2, m_item[it]};
+                            std::push_heap(heap, heap+k);
+                        }
+                    }
+                }
+                else
+                {
+                    const real_type d0 = m_node[node.first].box.distance2(pt);
+                    const real_type d1 = m_node[node.first+1].box.distance2(pt);
+                    // Visit the nearer child first.
+                    const bool swap = d1 < d0;
+                    const std::pair<serial_type, real_type> near{node.first + swap, swap ? d1 : d0};
+                    const std::pair<serial_type, real_type> far{node.first + !swap, swap ? d0 : d1};
+                    if (far.second < heap[0].first) { stack[top++] = far; }
+                    if (near.second < heap[0].first) { stack[top++] = near; }
+                }
+            }
+        }
+        std::sort_heap(heap, heap+k);
+        for (size_t it=0; it<k; ++it)
+        {
+            ids[it] = heap[it].second;
+            dist[it] = std::sqrt(heap[it].first);
+        }
+    }
+
+    /**
+     * Items overlapping every one of the (nquery, 2, ND) boxes, in the CSR
+     * format: the items of query i are ids[offset[i]:offset[i+1]].
+     */
+    std::pair<serial_array, serial_array> range(real_array const & query) const
+    {
+        MODMESH_TIME("SpatialIndex::range");
+        if (3 != query.ndim() || 2 != query.shape(1) || ND != query.shape(2) || !query.is_contiguous())
+        {
+            MODMESH_EXCEPT(SpatialIndex, std::invalid_argument, "query boxes must be contiguous (nquery, 2, ND)");
+        }
+        return spatial::range<ND>(query, [this](box_type const & box, auto && emit) { range(box, emit); });
+    }
+
+    /// The k nearest items of every one of the (nquery, ND) points, as
+    /// (nquery, k) arrays of the items and the distances.
+    std::pair<serial_array, real_array> nearest(real_array const & query, size_t k) const
+    {
+        MODMESH_TIME("SpatialIndex::nearest");
+        if (2 != query.ndim() || ND != query.shape(1) || !query.is_contiguous())
+        {
+            MODMESH_EXCEPT(SpatialIndex, std::invalid_argument, "query points must be contiguous (nquery, ND)");
+        }
+        return spatial::nearest<ND>
+        (
+            query, k
+          , [this](real_type const * pt, size_t kk, serial_type * ids, real_type * dist) { nearest(pt, kk, ids, dist); }
+        );
+    }
+
+    /// Squared distance from the point to the item.
+    real_type item_distance2(serial_type item, real_type const * pt) const
+    {
+        return distance2(m_crd.data() + item * ncrd() * ND, pt);
+    }
+
+    /// Whether the item overlaps the box.
+    bool item_overlaps(serial_type item, box_type const & box) const
+    {
+        return overlaps(m_crd.data() + item * ncrd() * ND, box);
+    }
+
+    /// Add the items of the coordinates shaped as at construction, and
+    /// return their ids.
+    serial_array insert(real_array const & crd)
+    {
+        MODMESH_TIME("SpatialIndex::insert");
+        validate(crd);
+        const size_t nnew = crd.shape(0);
+        if (size() + nnew >= INVALID)
+        {
+            MODMESH_EXCEPT(SpatialIndex, std::invalid_argument, "too many items");
+        }
+        serial_array ids(nnew);
+        for (size_t it=0; it<nnew; ++it)
+        {
+            if (m_free.empty())
+            {
+                ids[it] = serial_type(m_box.size());
+                resize_items(m_box.size() + 1);
+            }
+            else
+            {
+                ids[it] = m_free.back();
+                m_free.pop_back();
+            }
+        }
+        set_items(nnew, [&](size_t it) { return ids[it]; }, crd.data());
+
+        // Many new items are cheaper to bulk load.
+        if (m_node.empty() || 4 * nnew >= size())
+        {
+            for (size_t it=0; it<nnew; ++it) { m_slot[ids[it]] = 0; }
+            build();
+            return ids;
+        }
+        std::vector<serial_type> touched;
+        std::vector<serial_type> forced;
+        for (size_t it=0; it<nnew; ++it)
+        {
+            const serial_type item = ids[it];
+            box_type const & box = m_box[item];
+            // Go down to the child growing the least.
+            serial_type inode = 0;
+            while (!m_node[inode].is_leaf())
+            {
+                m_node[inode].box.expand(box);
+                const serial_type child = m_node[inode].first;
+                real_type growth[2];
+                real_type area[2];
+                for (size_t ic=0; ic<2; ++ic)
+                {
+                    box_type grown = m_node[child+ic].box;
+                    area[ic] = grown.half_area();
+                    grown.expand(box);
+                    growth[ic] = grown.half_area() - area[ic];
+                }
+                const bool right = growth[1] < growth[0] || (growth[1] == growth[0] && area[1] < area[0]);
+                inode = child + right;
+            }
+            add_item(inode, item, touched, forced);
+        }
+        maintain(touched, forced);
+        return ids;
+    }
+
+    /// Remove the items.
+    void remove(serial_array const & items)
+    {
+        MODMESH_TIME("SpatialIndex::remove");
+        check_items(items);
+        std::vector<serial_type> touched;
+        const size_t npt = ncrd();
+        for (size_t it=0; it<items.size(); ++it)
+        {
+            const serial_type item = items[it];
+            const serial_type slot = m_slot[item];
+            const serial_type leaf = m_leaf[item];
+            Node & node = m_node[leaf];
+            // Fill the slot by the last item of the leaf.
+            const serial_type last = node.first + node.count - 1;
+            if (slot != last)
+            {
+                const serial_type moved = m_item[last];
+                m_item[slot] = moved;
+                std::copy_n(m_slot_crd.data() + last*npt*ND, npt*ND, m_slot_crd.data() + slot*npt*ND);
+                m_slot[moved] = slot;
+            }
+            m_item[last] = INVALID;
+            --node.count;
+            m_slot[item] = INVALID;
+            m_free.push_back(item);
+            touched.push_back(leaf);
+        }
+        if (0 == size())
+        {
+            build();
+            return;
+        }
+        maintain(touched, {});
+    }
+
+    /// Move the distinct items to the coordinates shaped as at construction.
+    void refit(serial_array const & items, real_array const & crd)
+    {
+        MODMESH_TIME("SpatialIndex::refit");
+        validate(crd);
+        if (crd.shape(0) != items.size())
+        {
+            MODMESH_EXCEPT(SpatialIndex, std::invalid_argument, "need one set of coordinates per item");
+        }
+        check_items(items);
+        set_items(items.size(), [&](size_t it) { return items[it]; }, crd.data());
+        const size_t npt = ncrd();
+        std::vector<serial_type> touched(items.size());
+        KernelPool::me().run
+        (
+            items.size()
+          , [&](size_t begin, size_t end, size_t)
+            {
+                for (size_t it=begin; it<end; ++it)
+                {
+                    const serial_type item = items[it];
+                    std::copy_n(m_crd.data() + item*npt*ND, npt*ND, m_slot_crd.data() + m_slot[item]*npt*ND);
+                    touched[it] = m_leaf[item];
+                }
+            }
+        );
+        maintain(touched, {});
+    }
+
+    /// Build the whole tree anew.
+    void rebuild() { build(); }
+
+private:
+
+    /// Number of points describing an item.
+    size_t ncrd() const { return SpatialKind::POINT == m_kind ? 1 : 2; }
+
+    /// Coordinates of the item in the slot of the item array.  They are
+    /// copied in the slot order so that a leaf reads them contiguously.
+    real_type const * slot_coord(size_t slot) const { return m_slot_crd.data() + slot * ncrd() * ND; }
+
+    /// Squared distance from the point to the item of the coordinates.
+    real_type distance2(real_type const * crd, real_type const * pt) const
+    {
+        real_type ret = 0;
+        switch (m_kind)
+        {
+        case SpatialKind::POINT:
+            for (size_t it=0; it<ND; ++it) { ret += (crd[it] - pt[it]) * (crd[it] - pt[it]); }
+            break;
+        case SpatialKind::SEGMENT:
+        {
+            // Project onto the segment and clamp to the end points.
+            real_type dir[ND];
+            real_type len2 = 0;
+            real_type proj = 0;
+            for (size_t it=0; it<ND; ++it)
+            {
+                dir[it] = crd[ND+it] - crd[it];
+                len2 += dir[it] * dir[it];
+                proj += (pt[it] - crd[it]) * dir[it];
+            }
+            const real_type t = len2 > 0 ? std::min(std::max(proj / len2, real_type(0)), real_type(1)) : 0;
+            for (size_t it=0; it<ND; ++it)
+            {
+                const real_type diff = crd[it] + t * dir[it] - pt[it];
+                ret += diff * diff;
+            }
+            break;
+        }
+        default:
+            for (size_t it=0; it<ND; ++it)
+            {
+                const real_type out = std::max(std::max(crd[it] - pt[it], pt[it] - crd[ND+it]), real_type(0));
+                ret += out * out;
+            }
+            break;
+        }
+        return ret;
+    }
+
+    /// Whether the item of the coordinates overlaps the box.
+    bool overlaps(real_type const * crd, box_type const & box) const
+    {
+        switch (m_kind)
+        {
+        case SpatialKind::POINT:
+            return box.contains(crd);
+        case SpatialKind::SEGMENT:
+        {
+            // Clip the parameter range by the slabs (Liang-Barsky).
+            real_type tlo = 0;
+            real_type thi = 1;
+            for (size_t it=0; it<ND; ++it)
+            {
+                const real_type dir = crd[ND+it] - crd[it];
+                if (0 == dir)
+                {
+                    if (crd[it] < box.lo[it] || crd[it] > box.hi[it]) { return false; }
+                    continue;
+                }
+                real_type t0 = (box.lo[it] - crd[it]) / dir;
+                real_type t1 = (box.hi[it] - crd[it]) / dir;
+                if (t0 > t1) { std::swap(t0, t1); }
+                tlo = std::max(tlo, t0);
+                thi = std::min(thi, t1);
+                if (tlo > thi) { return false; }
+            }
+            return true;
+        }
+        default:
+            for (size_t it=0; it<ND; ++it)
+            {
+                if (crd[it] > box.hi[it] || crd[ND+it] < box.lo[it]) { return false; }
+            }
+            return true;
+        }
+    }
+
+    void validate(real_array const & crd) const
+    {
+        const size_t npt = ncrd();
+        const bool good = 1 == npt
+            ? (2 == crd.ndim() && ND == crd.shape(1))
+            : (3 == crd.ndim() && 2 == crd.shape(1) && ND == crd.shape(2));
+        if (!good || !crd.is_contiguous())
+        {
+            MODMESH_EXCEPT(SpatialIndex, std::invalid_argument, "coordinates must be contiguous (n, ND) or (n, 2, ND)");
+        }
+        if (crd.shape(0) >= INVALID)
+        {
+            MODMESH_EXCEPT(SpatialIndex, std::invalid_argument, "too many items");
+        }
+    }
+
+    void check_items(serial_array const & items) const
+    {
+        for (size_t it=0; it<items.size(); ++it)
+        {
+            if (!alive(items[it]))
+            {
+                MODMESH_EXCEPT(SpatialIndex, std::out_of_range, "item not in the index");
+            }
+        }
+        std::vector<serial_type> sorted(items.data(), items.data() + items.size());
+        std::sort(sorted.begin(), sorted.end());
+        if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+        {
+            MODMESH_EXCEPT(SpatialIndex, std::invalid_argument, "items must be distinct");
+        }
+    }
+
+    void resize_items(size_t nid)
+    {
+        m_crd.resize(nid * ncrd() * ND);
+        m_box.resize(nid);
+        m_center.resize(nid);
+        m_slot.resize(nid, INVALID);
+        m_leaf.resize(nid, INVALID);
+    }
+
+    /// Set the coordinates, box, and center of the item id(it) from crd.
+    template <typename G>
+    void set_items(size_t nitem, G && id, real_type const * crd)
+    {
+        const size_t npt = ncrd();
+        KernelPool::me().run
+        (
+            nitem
+          , [&](size_t begin, size_t end, size_t)
+            {
+                for (size_t it=begin; it<end; ++it)
+                {
+                    const serial_type item = id(it);
+                    real_type * dst = m_crd.data() + item*npt*ND;
+                    std::copy_n(crd + it*npt*ND, npt*ND, dst);
+                    box_type box = box_type::empty();
+                    for (size_t ipt=0; ipt<npt; ++ipt) { box.expand(dst + ipt*ND); }
+                    m_box[item] = box;
+                    for (size_t idm=0; idm<ND; ++idm) { m_center[item][idm] = (box.lo[idm] + box.hi[idm]) / 2; }
+                }
+            }
+        );
+    }
+
+    /// Per-node bookkeeping for the incremental updates.
+    struct Stat
+    {
+        /// SAH cost of the subtree: the area of every node times the cost of
+        /// visiting it, plus that of every leaf times its items.
+        real_type cost = 0;
+        /// Cost per area when the subtree was built; 0 if unknown.
+        real_type base = 0;
+        uint8_t dirty = 0;
+        /// Whether the node is the root of a unit.
+        uint8_t unit = 0;
+    };
+
+    /// Cost per area over that when built.
+    real_type ratio(serial_type inode) const
+    {
+        Stat const & stat = m_stat[inode];
+        const real_type area = m_node[inode].box.half_area();
+        if (!(stat.base > 0) || !(area > 0)) { return 1; }
+        return stat.cost / area / stat.base;
+    }
+
+    size_t node_depth(serial_type inode) const
+    {
+        size_t ret = 0;
+        for (; 0 != inode; inode = m_node[inode].parent) { ++ret; }
+        return ret;
+    }
+
+    /// Put the item in the leaf, moving the slice of the leaf to the end of
+    /// the item array when it is full, and splitting the leaf beyond
+    /// LEAF_SIZE.
+    void add_item(serial_type leaf, serial_type item, std::vector<serial_type> & touched, std::vector<serial_type> & forced)
+    {
+        const size_t npt = ncrd();
+        if (m_node[leaf].count == m_node[leaf].capacity)
+        {
+            Node & node = m_node[leaf];
+            const serial_type first = serial_type(m_item.size());
+            const serial_type capacity = std::max(2 * node.count, serial_type(LEAF_SIZE));
+            m_item.resize(first + capacity, INVALID);
+            m_slot_crd.resize(m_item.size() * npt * ND);
+            for (serial_type it=0; it<node.count; ++it)
+            {
+                const serial_type moved = m_item[node.first + it];
+                m_item[first + it] = moved;
+                m_item[node.first + it] = INVALID;
+                m_slot[moved] = first + it;
+                std::copy_n(m_crd.data() + moved*npt*ND, npt*ND, m_slot_crd.data() + (first+it)*npt*ND);
+            }
+            node.first = first;
+            node.capacity = capacity;
+        }
+        Node & node = m_node[leaf];
+        const serial_type slot = node.first + node.count;
+        m_item[slot] = item;
+        std::copy_n(m_crd.data() + item*npt*ND, npt*ND, m_slot_crd.data() + slot*npt*ND);
+        m_slot[item] = slot;
+        m_leaf[item] = leaf;
+        ++node.count;
+        node.box.expand(m_box[item]);
+        touched.push_back(leaf);
+        if (node.count <= LEAF_SIZE) { return; }
+
+        const size_t depth = node_depth(leaf);
+        const serial_type begin = node.first;
+        const serial_type end = node.first + node.count;
+        const serial_type spare = node.capacity - node.count;
+        split(m_node, leaf, begin, end, depth);
+        m_stat.resize(m_node.size());
+        const serial_type child = m_node[leaf].first;
+        // The right child takes the spare slots.
+        m_node[child+1].capacity += spare;
+        for (serial_type ic=child; ic<child+2; ++ic)
+        {
+            Node const & sub = m_node[ic];
+            for (serial_type it=sub.first; it<sub.first+sub.count; ++it)
+            {
+                const serial_type moved = m_item[it];
+                m_slot[moved] = it;
+                m_leaf[moved] = ic;
+                std::copy_n(m_crd.data() + moved*npt*ND, npt*ND, m_slot_crd.data() + it*npt*ND);
+            }
+            touched.push_back(ic);
+        }
+        // Bound the depth by rebuilding the unit.
+        if (depth + 1 >= SAH_DEPTH)
+        {
+            serial_type unit = leaf;
+            while (0 != unit && !m_stat[unit].unit) { unit = m_node[unit].parent; }
+            forced.push_back(unit);
+        }
+    }
+
+    /**
+     * Refit the boxes of the touched nodes and their ancestors bottom up,
+     * rebuild the degraded units and the forced ones, and rebuild the whole
+     * tree if it stays degraded or is mostly holes.
+     */
+    void maintain(std::vector<serial_type> const & touched, std::vector<serial_type> forced)
+    {
+        const size_t npt = ncrd();
+        // A child is always after its parent, so that the nodes are refitted
+        // backward.  Touching many leaves refits every node.
+        std::vector<serial_type> dirty;
+        if (4 * touched.size() >= m_node.size())
+        {
+            dirty.resize(m_node.size());
+            for (size_t it=0; it<dirty.size(); ++it) { dirty[it] = serial_type(dirty.size() - 1 - it); }
+        }
+        else
+        {
+            for (serial_type inode : touched)
+            {
+                for (; INVALID != inode && !m_stat[inode].dirty; inode = m_node[inode].parent)
+                {
+                    m_stat[inode].dirty = 1;
+                    dirty.push_back(inode);
+                }
+            }
+            std::sort(dirty.begin(), dirty.end(), std::greater<serial_type>());
+        }
+        KernelPool::me().run
+        (
+            dirty.size()
+          , [&](size_t begin, size_t end, size_t)
+            {
+                for (size_t it=begin; it<end; ++it)
+                {
+                    Node & node = m_node[dirty[it]];
+                    if (!node.is_leaf()) { continue; }
+                    node.box = box_type::empty();
+                    real_type const * crd = slot_coord(node.first);
+                    for (size_t ipt=0; ipt<node.count*npt; ++ipt) { node.box.expand(crd + ipt*ND); }
+                    m_stat[dirty[it]].cost = node.box.half_area() * node.count;
+                }
+            }
+        );
+        for (serial_type inode : dirty)
+        {
+            m_stat[inode].dirty = 0;
+            Node & node = m_node[inode];
+            if (node.is_leaf()) { continue; }
+            node.box = m_node[node.first].box;
+            node.box.expand(m_node[node.first+1].box);
+            m_stat[inode].cost = TRAVERSAL_COST * node.box.half_area() + m_stat[node.first].cost + m_stat[node.first+1].cost;
+        }
+        for (serial_type inode : dirty)
+        {
+            if (m_stat[inode].unit && ratio(inode) > REBUILD_RATIO) { forced.push_back(inode); }
+        }
+
+        if (!forced.empty())
+        {
+            std::sort(forced.begin(), forced.end());
+            forced.erase(std::unique(forced.begin(), forced.end()), forced.end());
+            if (0 == forced.front()) { build(); return; }
+            rebuild_units(forced);
+        }
+        const size_t nhole = m_item.size() - size();
+        if (ratio(0) > REBUILD_RATIO || nhole > std::max(size(), UNIT_SIZE) || 2 * m_ngarbage > m_node.size())
+        {
+            build();
+        }
+    }
+
+    /// Rebuild the subtrees of the disjoint roots from their items.
+    void rebuild_units(std::vector<serial_type> const & roots)
+    {
+        MODMESH_TIME("SpatialIndex::rebuild_units");
+        // Gather the items of every subtree to a new slice at the end of the
+        // item array.
+        std::vector<Pending> pending(roots.size());
+        for (size_t itask=0; itask<roots.size(); ++itask)
+        {
+            const serial_type root = roots[itask];
+            const serial_type begin = serial_type(m_item.size());
+            std::vector<serial_type> stack{root};
+            while (!stack.empty())
+            {
+                const serial_type inode = stack.back();
+                stack.pop_back();
+                Node const & node = m_node[inode];
+                if (node.is_leaf())
+                {
+                    for (serial_type it=node.first; it<node.first+node.count; ++it)
+                    {
+                        const serial_type item = m_item[it];
+                        m_item[it] = INVALID;
+                        m_item.push_back(item);
+                    }
+                }
+                else
+                {
+                    stack.push_back(node.first);
+                    stack.push_back(node.first + 1);
+                }
+                // Leave nothing to refit in the dropped nodes.
+                m_node[inode].count = 0;
+                if (inode != root)
+                {
+                    m_stat[inode].unit = 0;
+                    ++m_ngarbage;
+                }
+            }
+            pending[itask] = {root, begin, serial_type(m_item.size()), serial_type(node_depth(root))};
+        }
+        m_slot_crd.resize(m_item.size() * ncrd() * ND);
+
+        std::vector<std::vector<Node>> local(pending.size());
+        KernelPool::me().run_tasks(pending.size(), [&](size_t itask) { local[itask] = build_subtree(pending[itask]); });
+        for (size_t itask=0; itask<pending.size(); ++itask)
+        {
+            const serial_type root = pending[itask].node;
+            splice(root, local[itask]);
+            settle(root);
+            // Bring the costs of the ancestors up to date.
+            for (serial_type inode=m_node[root].parent; INVALID != inode; inode=m_node[inode].parent)
+            {
+                Node const & node = m_node[inode];
+                m_stat[inode].cost = TRAVERSAL_COST * node.box.half_area() + m_stat[node.first].cost + m_stat[node.first+1].cost;
+            }
+        }
+    }
+
+    /// Range of items waiting to be split under a node.
+    struct Pending
+    {
+        serial_type node;
+        serial_type begin;
+        serial_type end;
+        serial_type depth;
+    };
+
+    /// Build the tree over the items alive.
+    void build()
+    {
+        MODMESH_TIME("SpatialIndex::build");
+        m_item.clear();
+        m_item.reserve(size());
+        for (size_t it=0; it<m_slot.size(); ++it)
+        {
+            if (INVALID != m_slot[it]) { m_item.push_back(serial_type(it)); }
+        }
+        const size_t nitem = m_item.size();
+        m_slot_crd.resize(nitem * ncrd() * ND);
+        m_node.clear();
+        m_stat.clear();
+        m_ngarbage = 0;
+        if (0 == nitem) { return; }
+
+        // Split the upper levels breadth first until there are enough
+        // subtrees to go around the threads.
+        KernelPool & pool = KernelPool::me();
+        m_node.reserve(2 * nitem / (LEAF_SIZE/2) + 1);
+        m_node.push_back(make_node(INVALID, 0, serial_type(nitem)));
+        std::vector<Pending> pending{{0, 0, serial_type(nitem), 0}};
+        const size_t ntask = 4 * pool.nthread();
+        const size_t min_task = 4096;
+        while (pending.size() < ntask)
+        {
+            // Split the largest range.
+            auto largest = std::max_element
+            (
+                pending.begin(), pending.end()
+              , [](Pending const & a, Pending const & b) { return a.end - a.begin < b.end - b.begin; }
+            );
+            if (largest->end - largest->begin < min_task) { break; }
+            const Pending job = *largest;
+            pending.erase(largest);
+            const serial_type mid = split(m_node, job.node, job.begin, job.end, job.depth);
+            if (mid == job.end) { continue; }
+            pending.push_back({m_node[job.node].first, job.begin, mid, job.depth + 1});
+            pending.push_back({m_node[job.node].first + 1, mid, job.end, job.depth + 1});
+        }
+
+        // Build the subtrees as tasks and append their nodes.
+        std::vector<std::vector<Node>> local(pending.size());
+        pool.run_tasks(pending.size(), [&](size_t itask) { local[itask] = build_subtree(pending[itask]); });
+        for (size_t itask=0; itask<pending.size(); ++itask) { splice(pending[itask].node, local[itask]); }
+        settle(0);
+    }
+
+    /// Nodes of the subtree over the items of the job, the root first.
+    std::vector<Node> build_subtree(Pending const & job)
+    {
+        std::vector<Node> nodes;
+        nodes.push_back(make_node(INVALID, job.begin, job.end - job.begin));
+        std::vector<Pending> stack{{0, job.begin, job.end, job.depth}};
+        while (!stack.empty())
+        {
+            const Pending top = stack.back();
+            stack.pop_back();
+            const serial_type mid = split(nodes, top.node, top.begin, top.end, top.depth);
+            if (mid == top.end) { continue; }
+            stack.push_back({nodes[top.node].first, top.begin, mid, top.depth + 1});
+            stack.push_back({nodes[top.node].first + 1, mid, top.end, top.depth + 1});
+        }
+        return nodes;
+    }
+
+    /// Replace the node by the root of the subtree and append the rest.
+    void splice(serial_type root, std::vector<Node> const & nodes)
+    {
+        // Local node i > 0 goes to offset + i - 1; local node 0 replaces
+        // the root.
+        const serial_type offset = serial_type(m_node.size());
+        auto place = [&](serial_type inode) { return 0 == inode ? root : offset + inode - 1; };
+        for (size_t inode=0; inode<nodes.size(); ++inode)
+        {
+            Node node = nodes[inode];
+            if (!node.is_leaf()) { node.first = place(node.first); }
+            if (0 == inode) { node.parent = m_node[root].parent; }
+            else { node.parent = place(node.parent); }
+            if (0 == inode) { m_node[root] = node; }
+            else { m_node.push_back(node); }
+        }
+        m_stat.resize(m_node.size());
+    }
+
+    /**
+     * Point the items of the fresh subtree to their slots and leaves, copy
+     * their coordinates to the slots, and reset the costs and units of the
+     * nodes.  Return the number of items.
+     */
+    size_t settle(serial_type root)
+    {
+        const size_t npt = ncrd();
+        // Post order by an explicit stack; the second visit of an inner node
+        // adds up its children.
+        std::vector<std::pair<serial_type, bool>> stack{{root, false}};
+        std::vector<size_t> counts;
+        while (!stack.empty())
+        {
+            const auto top = stack.back();
+            stack.pop_back();
+            Node const & node = m_node[top.first];
+            Stat & stat = m_stat[top.first];
+            size_t count = 0;
+            if (node.is_leaf())
+            {
+                for (serial_type it=node.first; it<node.first+node.count; ++it)
+                {
+                    const serial_type item = m_item[it];
+                    m_slot[item] = it;
+                    m_leaf[item] = top.first;
+                    std::copy_n(m_crd.data() + item*npt*ND, npt*ND, m_slot_crd.data() + it*npt*ND);
+                }
+                count = node.count;
+                stat.cost = node.box.half_area() * count;
+            }
+            else if (!top.second)
+            {
+                stack.push_back({top.first, true});
+                stack.push_back({node.first + 1, false});
+                stack.push_back({node.first, false});
+                continue;
+            }
+            else
+            {
+                // The counts of the right and then the left child are on
+                // top.
+                const size_t right = counts.back();
+                counts.pop_back();
+                const size_t left = counts.back();
+                counts.pop_back();
+                count = left + right;
+                m_stat[node.first].unit = left <= UNIT_SIZE && count > UNIT_SIZE;
+                m_stat[node.first+1].unit = right <= UNIT_SIZE && count > UNIT_SIZE;
+                stat.cost = TRAVERSAL_COST * node.box.half_area() + m_stat[node.first].cost + m_stat[node.first+1].cost;
+            }
+            const real_type area = node.box.half_area();
+            stat.base = area > 0 ? stat.cost / area : 0;
+            stat.dirty = 0;
+            stat.unit = 0;
+            counts.push_back(count);
+        }
+        m_stat[root].unit = counts.back() <= UNIT_SIZE;
+        return counts.back();
+    }
+
+    Node make_node(serial_type parent, serial_type begin, serial_type count) const
+    {
+        Node ret;
+        ret.box = box_type::empty();
+        for (size_t it=begin; it<begin+count; ++it) { ret.box.expand(m_box[m_item[it]]); }
+        ret.first = begin;
+        ret.count = count;
+        ret.parent = parent;
+        ret.capacity = count;
+        return ret;
+    }
+
+    /**
+     * Split the leaf node over the items [begin, end) into two children
+     * appended to the nodes.  Return the first item of the second child, or
+     * end if the node stays a leaf.
+     */
+    serial_type split(std::vector<Node> & nodes, serial_type inode, serial_type begin, serial_type end, size_t depth)
+    {
+        constexpr size_t nbin = 16;
+        const size_t count = end - begin;
+        if (count <= LEAF_MIN) { return end; }
+        if (depth >= SAH_DEPTH)
+        {
+            return count <= LEAF_SIZE ? end : halve(nodes, inode, begin, end);
+        }
+
+        box_type cbox = box_type::empty();
+        for (size_t it=begin; it<end; ++it) { cbox.expand(m_center[m_item[it]].data()); }
+
+        // Binned SAH cost over every axis.
+        real_type best_cost = std::numeric_limits<real_type>::max();
+        size_t best_axis = 0;
+        size_t best_bin = 0;
+        box_type best_left;
+        box_type best_right;
+        for (size_t axis=0; axis<ND; ++axis)
+        {
+            const real_type extent = cbox.hi[axis] - cbox.lo[axis];
+            if (!(extent > 0)) { continue; }
+            const real_type scale = nbin / extent;
+            box_type bin_box[nbin];
+            size_t bin_count[nbin] = {};
+            for (size_t ib=0; ib<nbin; ++ib) { bin_box[ib] = box_type::empty(); }
+            for (size_t it=begin; it<end; ++it)
+            {
+                const serial_type item = m_item[it];
+                const size_t ib = std::min(size_t((m_center[item][axis] - cbox.lo[axis]) * scale), nbin-1);
+                bin_box[ib].expand(m_box[item]);
+                ++bin_count[ib];
+            }
+            // Sweep from the right for the right-hand areas.
+            box_type right_box[nbin];
+            size_t right_count[nbin];
+            box_type acc = box_type::empty();
+            size_t nacc = 0;
+            for (size_t ib=nbin; ib>1; --ib)
+            {
+                acc.expand(bin_box[ib-1]);
+                nacc += bin_count[ib-1];
+                right_box[ib-1] = acc;
+                right_count[ib-1] = nacc;
+            }
+            acc = box_type::empty();
+            nacc = 0;
+            for (size_t ib=1; ib<nbin; ++ib)
+            {
+                acc.expand(bin_box[ib-1]);
+                nacc += bin_count[ib-1];
+                if (0 == nacc || 0 == right_count[ib]) { continue; }
+                const real_type cost = acc.half_area() * nacc + right_box[ib].half_area() * right_count[ib];
+                if (cost < best_cost)
+                {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_bin = ib;
+                    best_left = acc;
+                    best_right = right_box[ib];
+                }
+            }
+        }
+
+        const real_type area = nodes[inode].box.half_area();
+        serial_type mid = end;
+        if (best_cost < std::numeric_limits<real_type>::max())
+        {
+            // A leaf costs its items, and a split one traversal plus the
+            // items weighted by the chance of hitting either child.
+            if (count <= LEAF_SIZE && (area <= 0 || TRAVERSAL_COST + best_cost / area >= count)) { return end; }
+            const real_type scale = nbin / (cbox.hi[best_axis] - cbox.lo[best_axis]);
+            const real_type lo = cbox.lo[best_axis];
+            auto left = [&](serial_type item)
+            {
+                return std::min(size_t((m_center[item][best_axis] - lo) * scale), nbin-1) < best_bin;
+            };
+            mid = serial_type(std::partition(m_item.begin() + begin, m_item.begin() + end, left) - m_item.begin());
+            // The bins already hold the boxes of the children.
+            const serial_type child = serial_type(nodes.size());
+            nodes.push_back(Node{best_left, begin, mid - begin, inode, mid - begin});
+            nodes.push_back(Node{best_right, mid, end - mid, inode, end - mid});
+            nodes[inode].first = child;
+            nodes[inode].count = 0;
+            nodes[inode].capacity = 0;
+            return mid;
+        }
+        else
+        {
+            // The centers coincide; halve the items to bound the leaves.
+            if (count <= LEAF_SIZE) { return end; }
+            mid = begin + serial_type(count / 2);
+        }
+        add_children(nodes, inode, begin, mid, end);
+        return mid;
+    }
+
+    /// Split the items at the median along the longest axis of the centers.
+    serial_type halve(std::vector<Node> & nodes, serial_type inode, serial_type begin, serial_type end)
+    {
+        box_type cbox = box_type::empty();
+        for (size_t it=begin; it<end; ++it) { cbox.expand(m_center[m_item[it]].data()); }
+        size_t axis = 0;
+        for (size_t it=1; it<ND; ++it)
+        {
+            if (cbox.hi[it] - cbox.lo[it] > cbox.hi[axis] - cbox.lo[axis]) { axis = it; }
+        }
+        const serial_type mid = begin + (end - begin) / 2;
+        std::nth_element
+        (
+            m_item.begin() + begin, m_item.begin() + mid, m_item.begin() + end
+          , [&](serial_type a, serial_type b) { return m_center[a][axis] < m_center[b][axis]; }
+        );
+        add_children(nodes, inode, begin, mid, end);
+        return mid;
+    }
+
+    void add_children(std::vector<Node> & nodes, serial_type inode, serial_type begin, serial_type mid, serial_type end) const
+    {
+        const serial_type child = serial_type(nodes.size());
+        nodes.push_back(make_node(inode, begin, mid - begin));
+        nodes.push_back(make_node(inode, mid, end - mid));
+        nodes[inode].first = child;
+        nodes[inode].count = 0;
+        nodes[inode].capacity = 0;
+    }
+
+    SpatialKind m_kind = SpatialKind::POINT;
+    /// Coordinates, boxes, slots, and leaves by item.
+    std::vector<real_type> m_crd;
+    std::vector<box_type> m_box;
+    std::vector<std::array<real_type, ND>> m_center;
+    std::vector<serial_type> m_slot;
+    std::vector<serial_type> m_leaf;
+    /// Removed items for reuse.
+    std::vector<serial_type> m_free;
+    /// Items by slot; INVALID for a hole.
+    std::vector<serial_type> m_item;
+    std::vector<real_type> m_slot_crd;
+    std::vector<Node> m_node;
+    std::vector<Stat> m_stat;
+    /// Nodes left behind by rebuilt units.
+    size_t m_ngarbage = 0;
+
+}; /* end class SpatialIndex */
+
+using SpatialIndex2d = SpatialIndex<2>;
+using SpatialIndex3d = SpatialIndex<3>;
+
+} /* end namespace modmesh */
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,470 @@
+#pragma once
+
+/*
+ * Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+ * BSD-style license; see COPYING
+ */
+
+/**
+ * Decomposition of a mesh into sub-meshes with ghost cells and halo exchange.
+ */
+
+#include "modmesh/base.hpp"
+#include "modmesh/buffer.hpp"
+#include "modmesh/kernel.hpp"
+#include "modmesh/mesh.hpp"
+#include "modmesh/profile.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * Cells a part exchanges with its neighbor parts, in the CSR format by
+ * neighbor.  The owned cells in send_cell[send_offset[i]:send_offset[i+1]]
+ * go to part send_part[i], and the ghost cells in
+ * recv_cell[recv_offset[i]:recv_offset[i+1]] come from part recv_part[i].
+ * The cells are local and in the order of the global cell, so that a send
+ * list and the matching receive list pair up item by item.  The neighbor
+ * parts are sorted.
+ */
+struct HaloPlan
+{
+
+    using serial_type = uint32_t;
+
+    std::vector<serial_type> send_part;
+    std::vector<serial_type> send_offset = std::vector<serial_type>(1, 0);
+    std::vector<serial_type> send_cell;
+    std::vector<serial_type> recv_part;
+    std::vector<serial_type> recv_offset = std::vector<serial_type>(1, 0);
+    std::vector<serial_type> recv_cell;
+
+    size_t nsend() const { return send_part.size(); }
+    size_t nrecv() const { return recv_part.size(); }
+
+}; /* end struct HaloPlan */
+
+/**
+ * One part of a decomposed mesh as a standalone mesh.  The owned cells come
+ * first in the order of the global cells, followed by the ghost cells layer
+ * by layer, each layer in the order of the global cells.  The nodes are in
+ * the order of the global nodes.
+ */
+template <size_t ND>
+class SubMesh
+  : public SpaceBase<ND>
+{
+
+public:
+
+    using serial_type = typename SpaceBase<ND>::serial_type;
+    using mesh_type = std::conditional_t<2 == ND, StaticMesh2d, StaticMesh3d>;
+
+    SubMesh() = default;
+
+    serial_type part() const { return m_part; }
+    /// Number of owned cells.
+    size_t nown() const { return m_nown; }
+    size_t nghost() const { return m_mesh.ncell() - m_nown; }
+
+    mesh_type const & mesh() const { return m_mesh; }
+    /// Global cell of every local cell.
+    std::vector<serial_type> const & clgid() const { return m_clgid; }
+    /// Global node of every local node.
+    std::vector<serial_type> const & ndgid() const { return m_ndgid; }
+    /// Ghost layer of every local cell; 0 for the owned cells.
+    std::vector<serial_type> const & cllayer() const { return m_cllayer; }
+    HaloPlan const & plan() const { return m_plan; }
+
+private:
+
+    template <size_t> friend class MeshDecomposition;
+
+    serial_type m_part = 0;
+    size_t m_nown = 0;
+    mesh_type m_mesh;
+    std::vector<serial_type> m_clgid;
+    std::vector<serial_type> m_ndgid;
+    std::vector<serial_type> m_cllayer;
+    HaloPlan m_plan;
+
+}; /* end class SubMesh */
+
+/**
+ * Copy the values of the owned cells into the ghost cells of the other
+ * parts, following the halo plans.  Every part has its own array, with the
+ * same number of values per cell.  The parts receive in parallel; each only
+ * writes to its ghost cells and only reads the owned cells of the others.
+ * The plans are referenced, not copied, and must outlive the exchanger.
+ */
+class HaloExchanger
+{
+
+public:
+
+    using serial_type = HaloPlan::serial_type;
+
+    HaloExchanger() = default;
+
+    explicit HaloExchanger(std::vector<HaloPlan const *> plans)
+      : m_plans(std::move(plans))
+      , m_peer(m_plans.size())
+    {
+        for (size_t ipart=0; ipart<m_plans.size(); ++ipart)
+        {
+            HaloPlan const & plan = *m_plans[ipart];
+            for (size_t irecv=0; irecv<plan.nrecv(); ++irecv)
+            {
+                const serial_type peer = plan.recv_part[irecv];
+                if (peer >= m_plans.size())
+                {
+                    MODMESH_EXCEPT(HaloExchanger, std::out_of_range, "neighbor part out of range");
+                }
+                HaloPlan const & other = *m_plans[peer];
+                auto found = std::lower_bound(other.send_part.begin(), other.send_part.end(), serial_type(ipart));
+                if (found == other.send_part.end() || *found != ipart)
+                {
+                    MODMESH_EXCEPT(HaloExchanger, std::invalid_argument, "receive without matching send");
+                }
+                const size_t isend = found - other.send_part.begin();
+                if (other.send_offset[isend+1] - other.send_offset[isend] != plan.recv_offset[irecv+1] - plan.recv_offset[irecv])
+                {
+                    MODMESH_EXCEPT(HaloExchanger, std::invalid_argument, "send and receive differ in size");
+                }
+                m_peer[ipart].push_back(serial_type(isend));
+            }
+        }
+    }
+
+    size_t nparts() const { return m_plans.size(); }
+
+    /// Exchange the arrays of ncomp values per cell; data[i] is of part i.
+    template <typename T>
+    void exchange(T * const * data, size_t ncomp) const
+    {
+        MODMESH_TIME("HaloExchanger::exchange");
+        KernelPool::me().run_tasks
+        (
+            m_plans.size()
+          , [&](size_t ipart)
+            {
+                HaloPlan const & plan = *m_plans[ipart];
+                T * dst = data[ipart];
+                for (size_t irecv=0; irecv<plan.nrecv(); ++irecv)
+                {
+                    HaloPlan const & other = *m_plans[plan.recv_part[irecv]];
+                    T const * src = data[plan.recv_part[irecv]];
+                    const size_t isend = m_peer[ipart][irecv];
+                    serial_type const * scl = other.send_cell.data() + other.send_offset[isend];
+                    serial_type const * rcl = plan.recv_cell.data() + plan.recv_offset[irecv];
+                    const size_t size = plan.recv_offset[irecv+1] - plan.recv_offset[irecv];
+                    for (size_t it=0; it<size; ++it)
+                    {
+                        std::copy_n(src + scl[it] * ncomp, ncomp, dst + rcl[it] * ncomp);
+                    }
+                }
+            }
+        );
+    }
+
+    /// Exchange contiguous arrays whose first axis is the local cells.
+    template <typename T>
+    void exchange(std::vector<SimpleArray<T>> & fields, std::vector<size_t> const & ncell) const
+    {
+        if (fields.size() != m_plans.size() || ncell.size() != m_plans.size())
+        {
+            MODMESH_EXCEPT(HaloExchanger, std::invalid_argument, "need one array per part");
+        }
+        std::vector<T *> data(fields.size());
+        size_t ncomp = 0;
+        for (size_t ipart=0; ipart<fields.size(); ++ipart)
+        {
+            SimpleArray<T> & field = fields[ipart];
+            if (!field.is_contiguous() || 0 == field.ndim() || field.shape(0) != ncell[ipart])
+            {
+                MODMESH_EXCEPT(HaloExchanger, std::invalid_argument, "array must be contiguous with one row per cell");
+            }
+            const size_t row = field.shape(0) ? field.size() / field.shape(0) : 0;
+            if (ipart && row != ncomp)
+            {
+                MODMESH_EXCEPT(HaloExchanger, std::invalid_argument, "arrays differ in values per cell");
+            }
+            ncomp = row;
+            data[ipart] = field.data();
+        }
+        exchange(data.data(), ncomp);
+    }
+
+private:
+
+    std::vector<HaloPlan const *> m_plans;
+    // Send list of the neighbor matching every receive list.
+    std::vector<std::vector<serial_type>> m_peer;
+
+}; /* end class HaloExchanger */
+
+/**
+ * Sub-meshes of a mesh split by a cell partition, with nlayer layers of
+ * ghost cells around the owned cells.  A ghost layer is the cells sharing a
+ * face with the previous layer.  The sub-meshes are built in parallel.
+ */
+template <size_t ND>
+class MeshDecomposition
+  : public SpaceBase<ND>
+{
+
+public:
+
+    using serial_type = typename SpaceBase<ND>::serial_type;
+    using real_type = typename SpaceBase<ND>::real_type;
+    using submesh_type = SubMesh<ND>;
+    using serial_array = SimpleArray<serial_type>;
+
+    MeshDecomposition() = default;
+
+    MeshDecomposition(StaticMesh<ND> const & mesh, serial_array const & part, size_t nparts, size_t nlayer=1)
+      : m_parts(nparts)
+    {
+        MODMESH_TIME("MeshDecomposition::MeshDecomposition");
+        const size_t ncell = mesh.ncell();
+        if (part.size() != ncell)
+        {
+            MODMESH_EXCEPT(MeshDecomposition, std::invalid_argument, "part must have one entry per cell");
+        }
+
+        // Owned cells of every part by counting sort, and their local ids.
+        std::vector<serial_type> own_offset(nparts+1, 0);
+        for (size_t icl=0; icl<ncell; ++icl)
+        {
+            if (part[icl] >= nparts)
+            {
+                MODMESH_EXCEPT(MeshDecomposition, std::out_of_range, "part out of range");
+            }
+            ++own_offset[part[icl]+1];
+        }
+        for (size_t ipart=0; ipart<nparts; ++ipart) { own_offset[ipart+1] += own_offset[ipart]; }
+        std::vector<serial_type> own_cell(ncell);
+        std::vector<serial_type> own_local(ncell);
+        {
+            std::vector<serial_type> pos(own_offset.begin(), own_offset.end()-1);
+            for (size_t icl=0; icl<ncell; ++icl)
+            {
+                own_local[icl] = pos[part[icl]] - own_offset[part[icl]];
+                own_cell[pos[part[icl]]++] = serial_type(icl);
+            }
+        }
+
+        KernelPool::me().run_tasks
+        (
+            nparts
+          , [&](size_t ipart)
+            {
+                build(mesh, part, ipart, own_cell.data() + own_offset[ipart], own_offset[ipart+1] - own_offset[ipart], nlayer);
+            }
+        );
+
+        // A ghost received from a part is sent by it, in the same order.
+        std::vector<std::vector<std::pair<serial_type, std::vector<serial_type>>>> sends(nparts);
+        for (size_t ipart=0; ipart<nparts; ++ipart)
+        {
+            HaloPlan const & plan = m_parts[ipart].m_plan;
+            std::vector<serial_type> const & clgid = m_parts[ipart].m_clgid;
+            for (size_t irecv=0; irecv<plan.nrecv(); ++irecv)
+            {
+                std::vector<serial_type> cells;
+                cells.reserve(plan.recv_offset[irecv+1] - plan.recv_offset[irecv]);
+                for (size_t it=plan.recv_offset[irecv]; it<plan.recv_offset[irecv+1]; ++it)
+                {
+                    cells.push_back(own_local[clgid[plan.recv_cell[it]]]);
+                }
+                sends[plan.recv_part[irecv]].emplace_back(serial_type(ipart), std::move(cells));
+            }
+        }
+        for (size_t ipart=0; ipart<nparts; ++ipart)
+        {
+            HaloPlan & plan = m_parts[ipart].m_plan;
+            for (auto & item : sends[ipart])
+            {
+                plan.send_part.push_back(item.first);
+                plan.send_cell.insert(plan.send_cell.end(), item.second.begin(), item.second.end());
+                plan.send_offset.push_back(serial_type(plan.send_cell.size()));
+            }
+        }
+
+        link();
+    }
+
+    // The exchanger points to the plans of the parts.  A copy relinks to
+    // its own parts, while a move keeps the buffer of the parts.
+    MeshDecomposition(MeshDecomposition const & other) : m_parts(other.m_parts) { link(); }
+    MeshDecomposition(MeshDecomposition &&) = default;
+    MeshDecomposition & operator=(MeshDecomposition const & other)
+    {
+        if (this != &other)
+        {
+            m_parts = other.m_parts;
+            link();
+        }
+        return *this;
+    }
+    MeshDecomposition & operator=(MeshDecomposition &&) = default;
+    ~MeshDecomposition() = default;
+
+    size_t nparts() const { return m_parts.size(); }
+    submesh_type const & operator[](size_t it) const { return m_parts[it]; }
+    submesh_type const & at(size_t it) const
+    {
+        if (it >= m_parts.size())
+        {
+            MODMESH_EXCEPT(MeshDecomposition, std::out_of_range, "part out of range");
+        }
+        return m_parts[it];
+    }
+
+    HaloExchanger const & exchanger() const { return m_exchanger; }
+
+    /// Fill the ghost cells of the per-part arrays.
+    template <typename T>
+    void exchange(std::vector<SimpleArray<T>> & fields) const
+    {
+        std::vector<size_t> ncell(m_parts.size());
+        for (size_t ipart=0; ipart<m_parts.size(); ++ipart) { ncell[ipart] = m_parts[ipart].m_mesh.ncell(); }
+        m_exchanger.exchange(fields, ncell);
+    }
+
+private:
+
+    void build
+    (
+        StaticMesh<ND> const & mesh, serial_array const & part, size_t ipart
+      , serial_type const * own, size_t nown, size_t nlayer
+    )
+    {
+        submesh_type & sub = m_parts[ipart];
+        sub.m_part = serial_type(ipart);
+        sub.m_nown = nown;
+        std::vector<serial_type> & clgid = sub.m_clgid;
+        std::vector<serial_type> & cllayer = sub.m_cllayer;
+        clgid.assign(own, own + nown);
+        cllayer.assign(nown, 0);
+
+        // Grow the ghost layers.  Every layer is sorted, and so are the
+        // owned cells.
+        serial_array const & nbofs = mesh.clnbs_offset();
+        serial_array const & nbs = mesh.clnbs();
+        size_t begin = 0;
+        for (size_t ilayer=1; ilayer<=nlayer; ++ilayer)
+        {
+            const size_t end = clgid.size();
+            std::vector<serial_type> layer;
+            for (size_t it=begin; it<end; ++it)
+            {
+                for (size_t inb=nbofs[clgid[it]]; inb<nbofs[clgid[it]+1]; ++inb)
+                {
+                    if (part[nbs[inb]] != ipart) { layer.push_back(nbs[inb]); }
+                }
+            }
+            std::sort(layer.begin(), layer.end());
+            layer.erase(std::unique(layer.begin(), layer.end()), layer.end());
+            auto known = [&](serial_type icl)
+            {
+                for (size_t jlayer=1; jlayer<ilayer; ++jlayer)
+                {
+                    auto first = clgid.begin() + layer_begin(cllayer, jlayer);
+                    auto last = clgid.begin() + layer_begin(cllayer, jlayer+1);
+                    if (std::binary_search(first, last, icl)) { return true; }
+                }
+                return false;
+            };
+            layer.erase(std::remove_if(layer.begin(), layer.end(), known), layer.end());
+            if (layer.empty()) { break; }
+            clgid.insert(clgid.end(), layer.begin(), layer.end());
+            cllayer.resize(clgid.size(), serial_type(ilayer));
+            begin = end;
+        }
+
+        // Receive lists grouped by the owner and in the order of the global
+        // cells.
+        std::vector<std::pair<serial_type, serial_type>> ghost;
+        ghost.reserve(clgid.size() - nown);
+        for (size_t it=nown; it<clgid.size(); ++it) { ghost.emplace_back(part[clgid[it]], serial_type(it)); }
+        std::sort
+        (
+            ghost.begin(), ghost.end()
+          , [&](auto const & a, auto const & b)
+            {
+                return a.first != b.first ? a.first < b.first : clgid[a.second] < clgid[b.second];
+            }
+        );
+        HaloPlan & plan = sub.m_plan;
+        for (size_t it=0; it<ghost.size(); ++it)
+        {
+            if (0 == it || ghost[it].first != ghost[it-1].first)
+            {
+                if (it) { plan.recv_offset.push_back(serial_type(it)); }
+                plan.recv_part.push_back(ghost[it].first);
+            }
+            plan.recv_cell.push_back(ghost[it].second);
+        }
+        if (!ghost.empty()) { plan.recv_offset.push_back(serial_type(ghost.size())); }
+
+        // Nodes and cells in local numbering.
+        std::vector<serial_type> & ndgid = sub.m_ndgid;
+        size_t nclnd = 0;
+        for (serial_type icl : clgid) { nclnd += mesh.cell_nnode(icl); }
+        ndgid.reserve(nclnd);
+        for (serial_type icl : clgid)
+        {
+            ndgid.insert(ndgid.end(), mesh.cell_nodes(icl), mesh.cell_nodes(icl) + mesh.cell_nnode(icl));
+        }
+        std::sort(ndgid.begin(), ndgid.end());
+        ndgid.erase(std::unique(ndgid.begin(), ndgid.end()), ndgid.end());
+        SimpleArray<real_type> ndcrd(std::vector<size_t>{ndgid.size(), ND});
+        for (size_t ind=0; ind<ndgid.size(); ++ind)
+        {
+            for (size_t idm=0; idm<ND; ++idm) { ndcrd(ind, idm) = mesh.ndcrd()(ndgid[ind], idm); }
+        }
+        serial_array clnds_offset(clgid.size()+1);
+        serial_array clnds(nclnd);
+        clnds_offset[0] = 0;
+        for (size_t icl=0; icl<clgid.size(); ++icl)
+        {
+            const size_t nnd = mesh.cell_nnode(clgid[icl]);
+            serial_type const * nds = mesh.cell_nodes(clgid[icl]);
+            for (size_t it=0; it<nnd; ++it)
+            {
+                clnds[clnds_offset[icl]+it] = serial_type(std::lower_bound(ndgid.begin(), ndgid.end(), nds[it]) - ndgid.begin());
+            }
+            clnds_offset[icl+1] = serial_type(clnds_offset[icl] + nnd);
+        }
+        sub.m_mesh = typename submesh_type::mesh_type(ndcrd, clnds_offset, clnds);
+    }
+
+    void link()
+    {
+        std::vector<HaloPlan const *> plans;
+        plans.reserve(m_parts.size());
+        for (submesh_type const & sub : m_parts) { plans.push_back(&sub.m_plan); }
+        m_exchanger = HaloExchanger(std::move(plans));
+    }
+
+    /// First local cell of the ghost layer.
+    static size_t layer_begin(std::vector<serial_type> const & cllayer, size_t ilayer)
+    {
+        return std::lower_bound(cllayer.begin(), cllayer.end(), serial_type(ilayer)) - cllayer.begin();
+    }
+
+    std::vector<submesh_type> m_parts;
+    HaloExchanger m_exchanger;
+
+}; /* end class MeshDecomposition */
+
+} /* end namespace modmesh */
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -10,19 +10,71 @@ from . import _modmesh
 
 
 __all__ = [
+    'ConcreteBuffer',
+    'SimpleArrayFloat64',
+    'SimpleArrayInt32',
+    'SimpleArrayInt64',
     'TimeRegistry',
     'time_registry',
+    'TimedScope',
+    'Clock',
+    'clock',
+    'KernelPool',
+    'kernel_pool',
     'StaticGrid1d',
     'StaticGrid2d',
     'StaticGrid3d',
+    'StaticMesh2d',
+    'StaticMesh3d',
+    'StaticGraph',
+    'GraphPartitioner',
+    'SubMesh2d',
+    'SubMesh3d',
+    'MeshDecomposition2d',
+    'MeshDecomposition3d',
+    'SpatialIndex2d',
+    'SpatialIndex3d',
+    'KdTree2d',
+    'KdTree3d',
+    'PointLocator2d',
+    'PointLocator3d',
+    'PoissonSolver2d',
+    'PolynomialFitter',
 ]
 
 
+ConcreteBuffer = _modmesh.ConcreteBuffer
+SimpleArrayFloat64 = _modmesh.SimpleArrayFloat64
+SimpleArrayInt32 = _modmesh.SimpleArrayInt32
+SimpleArrayInt64 = _modmesh.SimpleArrayInt64
+
 TimeRegistry = _modmesh.TimeRegistry
 time_registry = _modmesh.time_registry
+TimedScope = _modmesh.TimedScope
+Clock = _modmesh.Clock
+clock = _modmesh.clock
+KernelPool = _modmesh.KernelPool
+kernel_pool = _modmesh.kernel_pool
 
 StaticGrid1d = _modmesh.StaticGrid1d
 StaticGrid2d = _modmesh.StaticGrid2d
 StaticGrid3d = _modmesh.StaticGrid3d
 
+StaticMesh2d = _modmesh.StaticMesh2d
+StaticMesh3d = _modmesh.StaticMesh3d
+StaticGraph = _modmesh.StaticGraph
+GraphPartitioner = _modmesh.GraphPartitioner
+SubMesh2d = _modmesh.SubMesh2d
+SubMesh3d = _modmesh.SubMesh3d
+MeshDecomposition2d = _modmesh.MeshDecomposition2d
+MeshDecomposition3d = _modmesh.MeshDecomposition3d
+SpatialIndex2d = _modmesh.SpatialIndex2d
+SpatialIndex3d = _modmesh.SpatialIndex3d
+KdTree2d = _modmesh.KdTree2d
+KdTree3d = _modmesh.KdTree3d
+PointLocator2d = _modmesh.PointLocator2d
+PointLocator3d = _modmesh.PointLocator3d
+PoissonSolver2d = _modmesh.PoissonSolver2d
+PolynomialFitter = _modmesh.PolynomialFitter
+
 # vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -15,11 +15,36 @@ namespace python
 void initialize(pybind11::module & mod)
 {
 
+    WrapConcreteBuffer::commit(mod);
+    WrapSimpleArrayFloat64::commit(mod);
+    WrapSimpleArrayInt32::commit(mod);
+    WrapSimpleArrayInt64::commit(mod);
     WrapStaticGrid1d::commit(mod);
     WrapStaticGrid2d::commit(mod);
     WrapStaticGrid3d::commit(mod);
+    WrapStaticMesh2d::commit(mod);
+    WrapStaticMesh3d::commit(mod);
+    WrapStaticGraph::commit(mod);
+    WrapGraphPartitioner::commit(mod);
+    WrapSubMesh2d::commit(mod);
+    WrapSubMesh3d::commit(mod);
+    WrapMeshDecomposition2d::commit(mod);
+    WrapMeshDecomposition3d::commit(mod);
+    WrapSpatialIndex2d::commit(mod);
+    WrapSpatialIndex3d::commit(mod);
+    WrapKdTree2d::commit(mod);
+    WrapKdTree3d::commit(mod);
+    WrapPointLocator2d::commit(mod);
+    WrapPointLocator3d::commit(mod);
+    WrapPoissonSolver2d::commit(mod);
+    WrapPolynomialFitter::commit(mod);
     WrapTimeRegistry::commit(mod);
     mod.attr("time_registry") = mod.attr("TimeRegistry").attr("me");
+    WrapTimedScope::commit(mod);
+    WrapClock::commit(mod);
+    mod.attr("clock") = mod.attr("Clock").attr("me");
+    WrapKernelPool::commit(mod);
+    mod.attr("kernel_pool") = mod.attr("KernelPool").attr("me");
 
 }
 
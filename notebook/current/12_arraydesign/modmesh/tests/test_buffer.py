@@ -0,0 +1,114 @@
+# Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+# BSD-style license; see COPYING
+
+import gc
+import unittest
+
+import numpy as np
+
+import modmesh
+
+
+class ConcreteBufferTC(unittest.TestCase):
+
+    def test_buffer_protocol(self):
+
+        buf = modmesh.ConcreteBuffer(24)
+        self.assertEqual(24, buf.nbytes)
+        self.assertEqual(24, len(buf))
+        view = np.asarray(buf)
+        self.assertEqual(np.int8, view.dtype)
+        self.assertEqual((24,), view.shape)
+        view[:] = 0
+        buf[3] = 5
+        self.assertEqual(5, view[3])
+        view[4] = -2
+        self.assertEqual(-2, buf[4])
+        # A clone owns its own memory.
+        other = buf.clone()
+        view[3] = 7
+        self.assertEqual(5, other[3])
+
+
+class SimpleArrayTC(unittest.TestCase):
+
+    classes = (
+        (modmesh.SimpleArrayFloat64, np.float64),
+        (modmesh.SimpleArrayInt32, np.int32),
+        (modmesh.SimpleArrayInt64, np.int64),
+    )
+
+    def test_zero_copy(self):
+
+        for cls, dtype in self.classes:
+            arr = cls((3, 4, 5))
+            itemsize = np.dtype(dtype).itemsize
+            self.assertEqual(itemsize, cls.itemsize)
+            self.assertEqual((3, 4, 5), arr.shape)
+            self.assertEqual((20, 5, 1), arr.stride)
+            self.assertTrue(arr.is_contiguous)
+            for view in (np.asarray(arr), arr.ndarray):
+                self.assertEqual(dtype, view.dtype)
+                self.assertEqual((3, 4, 5), view.shape)
+                self.assertEqual((20*itemsize, 5*itemsize, itemsize),
+                                 view.strides)
+            view = np.asarray(arr)
+            self.assertEqual(view.ctypes.data, arr.ndarray.ctypes.data)
+            self.assertEqual(view.ctypes.data,
+                             np.asarray(memoryview(arr)).ctypes.data)
+            # Writes on either side show on the other.
+            view[...] = np.arange(60).reshape((3, 4, 5))
+            self.assertEqual(33, arr[1, 2, 3])
+            arr[2, 3, 4] = -1
+            self.assertEqual(-1, view[2, 3, 4])
+
+    def test_reshape_shares_memory(self):
+
+        arr = modmesh.SimpleArrayFloat64((3, 4))
+        arr.fill(0)
+        flat = arr.reshape([12])
+        self.assertEqual((12,), flat.shape)
+        np.asarray(flat)[5] = 2.5
+        self.assertEqual(2.5, arr[1, 1])
+        self.assertTrue(np.shares_memory(np.asarray(arr), np.asarray(flat)))
+
+    def test_from_numpy_copies(self):
+
+        src = np.arange(6, dtype='float64').reshape((2, 3))
+        arr = modmesh.SimpleArrayFloat64(src)
+        self.assertEqual((2, 3), arr.shape)
+        self.assertEqual(src.tolist(), np.asarray(arr).tolist())
+        src[0, 0] = 10.0
+        self.assertEqual(0.0, arr[0, 0])
+        # Strided input is gathered into C order.
+        arr = modmesh.SimpleArrayFloat64(src.T)
+        self.assertEqual((3, 2), arr.shape)
+        self.assertEqual(src.T.tolist(), np.asarray(arr).tolist())
+
+    def test_view_keeps_array_alive(self):
+
+        view = np.asarray(modmesh.SimpleArrayInt64(1000))
+        gc.collect()
+        view[...] = 1
+        self.assertEqual(1000, view.sum())
+
+    def test_allocators(self):
+
+        for name in ('aligned', 'pool', 'mmap', 'hugepage'):
+            arr = modmesh.SimpleArrayFloat64(1000, allocator=name)
+            self.assertEqual(name, arr.allocator)
+            self.assertEqual(0, np.asarray(arr).ctypes.data % 64)
+        with self.assertRaises(ValueError):
+            modmesh.SimpleArrayFloat64(10, allocator='stack')
+
+    def test_index(self):
+
+        arr = modmesh.SimpleArrayInt32((2, 3))
+        arr.fill(4)
+        self.assertEqual(4, arr[1, 2])
+        with self.assertRaises(IndexError):
+            arr[2, 0]
+        with self.assertRaises(IndexError):
+            arr[1]
+
+# vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,169 @@
+# Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+# BSD-style license; see COPYING
+
+import unittest
+
+import numpy as np
+
+import modmesh
+
+
+class StaticGrid1dTC(unittest.TestCase):
+
+    def setUp(self):
+
+        self.grid = modmesh.StaticGrid1d(10)
+        self.grid.coord = np.arange(10, dtype='float64')
+
+    def test_coord(self):
+
+        grid = self.grid
+        self.assertEqual(10, len(grid))
+        self.assertEqual(list(range(10)), grid.coord.tolist())
+        with self.assertRaises(ValueError):
+            grid.coord = np.zeros(9)
+        with self.assertRaises(ValueError):
+            grid.coord = np.zeros((2, 5))
+        # Other dtypes are converted.
+        grid.coord = np.arange(10, dtype='int32')[::-1]
+        self.assertEqual(9.0, grid[0])
+
+    def test_negative_index(self):
+
+        grid = self.grid
+        self.assertEqual(9.0, grid[-1])
+        self.assertEqual(0.0, grid[-10])
+        grid[-2] = 20.0
+        self.assertEqual(20.0, grid[8])
+        for it in (10, -11):
+            with self.assertRaises(IndexError):
+                grid[it]
+            with self.assertRaises(IndexError):
+                grid[it] = 0.0
+
+    def test_slice_is_view(self):
+
+        grid = self.grid
+        part = grid[2:5]
+        self.assertEqual([2.0, 3.0, 4.0], part.tolist())
+        part[0] = 100.0
+        self.assertEqual(100.0, grid[2])
+        self.assertEqual([9.0, 7.0], grid[:-4:-2].tolist())
+        grid[::2] = 0.0
+        self.assertEqual([0.0, 1.0, 0.0, 3.0], grid[:4].tolist())
+
+    def test_fancy_index_is_copy(self):
+
+        grid = self.grid
+        picked = grid[[1, -1]]
+        self.assertEqual([1.0, 9.0], picked.tolist())
+        picked[0] = -1.0
+        self.assertEqual(1.0, grid[1])
+        self.assertEqual([6.0, 7.0, 8.0, 9.0], grid[grid.coord > 5].tolist())
+        grid[np.array([0, 3])] = [7.0, 8.0]
+        self.assertEqual([7.0, 1.0, 2.0, 8.0], grid[:4].tolist())
+        grid[grid.coord > 7] = -2.0
+        self.assertEqual([7.0, -2.0, 7.0, -2.0, -2.0],
+                         grid[[0, 3, 7, 8, 9]].tolist())
+        with self.assertRaises(IndexError):
+            grid[[0, 10]]
+
+    def test_buffer(self):
+
+        grid = self.grid
+        for view in (np.asarray(grid), np.asarray(memoryview(grid))):
+            self.assertEqual((10,), view.shape)
+            self.assertEqual((8,), view.strides)
+            self.assertTrue(np.shares_memory(view, grid.coord))
+        np.asarray(grid)[4] = 40.0
+        self.assertEqual(40.0, grid[4])
+
+
+class StaticGridArrayTC(unittest.TestCase):
+
+    @staticmethod
+    def _values(grid):
+
+        shape = tuple(n + 2*grid.nghost for n in grid.shape)
+        return np.arange(np.prod(shape), dtype='float64').reshape(shape)
+
+    def _check_round_trip(self, grid):
+
+        ng = grid.nghost
+        values = self._values(grid)
+        grid.from_array(values)
+        self.assertEqual(values.tolist(), grid.to_array().tolist())
+        # Every index, ghost points included, reaches its own point.
+        for idx in np.ndindex(*values.shape):
+            self.assertEqual(values[idx], grid[tuple(i - ng for i in idx)])
+        return values
+
+    def test_row_major_2d(self):
+
+        grid = modmesh.StaticGrid2d(5, 7, nghost=2)
+        self.assertEqual('row_major', grid.layout)
+        values = self._check_round_trip(grid)
+        self.assertEqual(values.tolist(), grid.data.tolist())
+        self.assertEqual(values[2:-2, 2:-2].tolist(), grid.interior.tolist())
+        # Rows are padded to the alignment.
+        self.assertEqual(0, grid.extent[1] % 8)
+        self.assertEqual(grid.extent[1]*8, grid.data.strides[0])
+
+    def test_tiled_2d(self):
+
+        grid = modmesh.StaticGrid2d(5, 7, nghost=2, layout='tiled', tile=4)
+        self.assertEqual('tiled', grid.layout)
+        self.assertEqual((12, 12), grid.extent)
+        values = self._check_round_trip(grid)
+        data = grid.data
+        self.assertEqual((3, 3, 4, 4), data.shape)
+        for p0, p1 in np.ndindex(*values.shape):
+            self.assertEqual(values[p0, p1], data[p0//4, p1//4, p0%4, p1%4])
+        with self.assertRaises(ValueError):
+            grid.interior
+
+    def test_tiled_3d(self):
+
+        grid = modmesh.StaticGrid3d(3, 6, 5, nghost=1, layout='tiled', tile=4)
+        self.assertEqual((8, 8, 8), grid.extent)
+        values = self._check_round_trip(grid)
+        data = grid.data
+        self.assertEqual((2, 2, 2, 4, 4, 4), data.shape)
+        for p0, p1, p2 in np.ndindex(*values.shape):
+            self.assertEqual(values[p0, p1, p2],
+                             data[p0//4, p1//4, p2//4, p0%4, p1%4, p2%4])
+
+    def test_layouts_agree(self):
+
+        row = modmesh.StaticGrid3d(3, 6, 5, nghost=1)
+        tiled = modmesh.StaticGrid3d(3, 6, 5, nghost=1, layout='tiled', tile=2)
+        row.from_array(self._values(row))
+        tiled.from_array(row.to_array())
+        for idx in np.ndindex(5, 8, 7):
+            idx = tuple(i - 1 for i in idx)
+            self.assertEqual(row[idx], tiled[idx])
+        tiled[2, 5, 4] = -1.0
+        row.from_array(tiled.to_array())
+        self.assertEqual(-1.0, row[2, 5, 4])
+
+    def test_index_range(self):
+
+        for layout in ('row_major', 'tiled'):
+            grid = modmesh.StaticGrid2d(4, 3, nghost=1, layout=layout)
+            grid.fill(0.0)
+            self.assertEqual(0.0, grid[-1, 3])
+            with self.assertRaises(IndexError):
+                grid[-2, 0]
+            with self.assertRaises(IndexError):
+                grid[0, 4]
+            with self.assertRaises(IndexError):
+                grid[0, 0, 0]
+
+    def test_bad_tile(self):
+
+        with self.assertRaises(ValueError):
+            modmesh.StaticGrid2d(4, 4, layout='tiled', tile=6)
+        with self.assertRaises(ValueError):
+            modmesh.StaticGrid2d(4, 4, layout='blocked')
+
+# vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,148 @@
+# Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+# BSD-style license; see COPYING
+
+import unittest
+
+import numpy as np
+
+import modmesh
+
+
+class KernelTC(unittest.TestCase):
+
+    # Below and above the default threshold of 64Ki elements.
+    sizes = (1000, 2**16 - 1, 2**16, 300001)
+
+    def setUp(self):
+
+        self.pool = modmesh.kernel_pool
+        self.nthread = self.pool.nthread
+        self.pool.nthread = 4
+        self.rng = np.random.default_rng(39)
+
+    def tearDown(self):
+
+        self.pool.nthread = self.nthread
+
+    def _array(self, size):
+
+        arr = modmesh.SimpleArrayFloat64(size)
+        view = np.asarray(arr)
+        view[...] = self.rng.random(size) - 0.5
+        return arr, view
+
+    def test_array(self):
+
+        for size in self.sizes:
+            x, vx = self._array(size)
+            y, vy = self._array(size)
+            # The sums are in a different order.
+            np.testing.assert_allclose(x.sum(), vx.sum(),
+                                       rtol=0, atol=1.e-9)
+            np.testing.assert_allclose(x.dot(y), vx.dot(vy),
+                                       rtol=0, atol=1.e-9)
+            self.assertEqual(vx.min(), x.min())
+            self.assertEqual(vx.max(), x.max())
+            gold = vy + 0.25*vx
+            y.axpy(0.25, x)
+            np.testing.assert_allclose(vy, gold, rtol=1.e-15)
+            gold = vx * 3.0
+            x.scale(3.0)
+            self.assertEqual(gold.tolist(), vx.tolist())
+            y.copy_from(x)
+            self.assertEqual(vx.tolist(), vy.tolist())
+
+    def test_grid(self):
+
+        for size in self.sizes:
+            grid = modmesh.StaticGrid1d(size)
+            other = modmesh.StaticGrid1d(size)
+            grid.fill(2.0)
+            self.assertTrue((grid.coord == 2.0).all())
+            grid.coord = self.rng.random(size)
+            other.coord = self.rng.random(size)
+            vx, vy = grid.coord, other.coord
+            np.testing.assert_allclose(grid.sum(), vx.sum(), rtol=1.e-12)
+            np.testing.assert_allclose(grid.dot(other), vx.dot(vy),
+                                       rtol=1.e-12)
+            self.assertEqual(vx.min(), grid.min())
+            self.assertEqual(vx.max(), grid.max())
+            gold = vy - 2.0*vx
+            other.axpy(-2.0, grid)
+            np.testing.assert_allclose(vy, gold, rtol=1.e-15)
+
+    def test_stream(self):
+
+        threshold = self.pool.stream_threshold
+        try:
+            # Force the non-temporal stores.
+            self.pool.stream_threshold = 0
+            for size in self.sizes:
+                x, vx = self._array(size)
+                y, vy = self._array(size)
+                y.copy_from(x)
+                self.assertEqual(vx.tolist(), vy.tolist())
+                grid = modmesh.StaticGrid1d(size)
+                grid.fill(-1.0)
+                self.assertTrue((grid.coord == -1.0).all())
+        finally:
+            self.pool.stream_threshold = threshold
+
+    def test_run(self):
+
+        for size in self.sizes:
+            chunks = []
+            self.pool.run(size, lambda *args: chunks.append(args))
+            chunks.sort()
+            if size < self.pool.threshold:
+                self.assertEqual([(0, size, 0)], chunks)
+                continue
+            self.assertEqual(4, len(chunks))
+            self.assertEqual([0, 1, 2, 3], sorted(c[2] for c in chunks))
+            # The chunks tile the range and start on whole grains.
+            self.assertEqual(0, chunks[0][0])
+            self.assertEqual(size, chunks[-1][1])
+            for prev, cur in zip(chunks[:-1], chunks[1:]):
+                self.assertEqual(prev[1], cur[0])
+                self.assertEqual(0, cur[0] % 8)
+
+    def test_nested_run(self):
+
+        x, vx = self._array(2**17)
+        results = []
+
+        # A kernel called from a chunk runs serially instead of waiting for
+        # the busy pool.
+        def _chunk(begin, end, ichunk):
+            total = x.sum()
+            inner = []
+            self.pool.run(2**17, lambda *args: inner.append(args))
+            results.append((total, inner))
+
+        self.pool.run(2**17, _chunk)
+        self.assertEqual(4, len(results))
+        for total, inner in results:
+            np.testing.assert_allclose(total, vx.sum(), rtol=0, atol=1.e-9)
+            self.assertEqual([(0, 2**17, 0)], inner)
+
+    def test_run_tasks(self):
+
+        x, vx = self._array(2**17)
+        done = [None] * 100
+
+        def _task(itask):
+            self.assertIsNone(done[itask])
+            done[itask] = x.sum() * itask
+
+        self.pool.run_tasks(len(done), _task)
+        np.testing.assert_allclose(done, vx.sum() * np.arange(100),
+                                   rtol=0, atol=1.e-7)
+
+        def _fail(itask):
+            if 7 == itask:
+                raise ValueError('task 7')
+
+        with self.assertRaisesRegex(ValueError, 'task 7'):
+            self.pool.run_tasks(10, _fail)
+
+# vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,136 @@
+# Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+# BSD-style license; see COPYING
+
+import unittest
+
+import numpy as np
+
+import modmesh
+
+
+def _shape(nnd, ndim, r):
+
+    """Shape functions of the reference cell at the reference coordinates."""
+    if nnd == ndim + 1:
+        return np.concatenate([[1 - r.sum()], r])
+    s, t = r[0], r[1]
+    quad = np.array([(1-s)*(1-t), s*(1-t), s*t, (1-s)*t])
+    if 2 == ndim:
+        return quad
+    u = r[2]
+    if 5 == nnd:
+        return np.concatenate([quad*(1-u), [u]])
+    if 6 == nnd:
+        tri = np.array([1-s-t, s, t])
+        return np.concatenate([tri*(1-u), tri*u])
+    return np.concatenate([quad*(1-u), quad*u])
+
+
+def _reference(rng, nnd, ndim):
+
+    """Random reference coordinates away from the faces of the cell."""
+    r = 0.05 + 0.9*rng.random(ndim)
+    if nnd == ndim + 1:
+        # Inside the simplex.
+        r = r / ndim * 0.9
+    elif 6 == nnd:
+        r[:2] *= 0.45
+    elif 5 == nnd:
+        r[2] *= 0.8
+    return r
+
+
+class PointLocatorTC(unittest.TestCase):
+
+    def setUp(self):
+
+        self.rng = np.random.default_rng(48)
+
+    @staticmethod
+    def _cells(mesh):
+
+        offset = mesh.clnds_offset
+        return [mesh.clnds[offset[icl]:offset[icl+1]]
+                for icl in range(mesh.ncell)]
+
+    def _check(self, mesh, locator_cls):
+
+        ndim = mesh.ndcrd.shape[1]
+        locator = locator_cls(mesh)
+        self.assertEqual(mesh.ncell, locator.ncell)
+        cells = self._cells(mesh)
+        # The centroid of a cell is in it.
+        centroid = np.asarray(mesh.cell_centroid())
+        found, local = locator.locate(centroid)
+        self.assertEqual(list(range(mesh.ncell)), found.tolist())
+        # Points at known reference coordinates.
+        ref = np.array([_reference(self.rng, len(nds), ndim)
+                        for nds in cells])
+        pts = np.array([_shape(len(nds), ndim, r).dot(mesh.ndcrd[nds])
+                        for nds, r in zip(cells, ref)])
+        found, local = locator.locate(pts)
+        self.assertEqual(list(range(mesh.ncell)), found.tolist())
+        np.testing.assert_allclose(local, ref, rtol=0, atol=1.e-10)
+        # The reference coordinates map back to the points.
+        for icl, (nds, r) in enumerate(zip(cells, local)):
+            np.testing.assert_allclose(_shape(len(nds), ndim, r)
+                                       .dot(mesh.ndcrd[nds]),
+                                       pts[icl], rtol=0, atol=1.e-12)
+        # The points outside.
+        lo, hi = mesh.ndcrd.min(axis=0), mesh.ndcrd.max(axis=0)
+        side = np.concatenate([[lo[0] - 0.1], (lo[1:] + hi[1:]) / 2])
+        outside = np.array([lo - 0.5, hi + 0.5, side])
+        found, local = locator.locate(outside)
+        self.assertEqual([locator.INVALID]*3, found.tolist())
+        self.assertTrue(np.isnan(local).all())
+
+    def test_rectangle(self):
+
+        for triangle in (False, True):
+            mesh = modmesh.StaticMesh2d.rectangle(12, 9, triangle=triangle)
+            self._check(mesh, modmesh.PointLocator2d)
+
+    def test_distorted(self):
+
+        # Moving the interior nodes makes the quadrilaterals non-affine.
+        mesh = modmesh.StaticMesh2d.rectangle(12, 9)
+        ndcrd = np.array(mesh.ndcrd)
+        inner = ((ndcrd > 0) & (ndcrd < 1)).all(axis=1)
+        ndcrd[inner] += 0.25 * (self.rng.random((inner.sum(), 2)) - 0.5) / 9
+        mesh = modmesh.StaticMesh2d(ndcrd, mesh.clnds_offset, mesh.clnds)
+        self._check(mesh, modmesh.PointLocator2d)
+        # Random points in the rectangle are all found and map back.
+        pts = self.rng.random((1000, 2))
+        found, local = modmesh.PointLocator2d(mesh).locate(pts)
+        self.assertTrue((found != modmesh.PointLocator2d.INVALID).all())
+        cells = self._cells(mesh)
+        for pt, icl, r in zip(pts, found, local):
+            nds = cells[icl]
+            np.testing.assert_allclose(_shape(4, 2, r).dot(ndcrd[nds]), pt,
+                                       rtol=0, atol=1.e-12)
+
+    def test_box(self):
+
+        self._check(modmesh.StaticMesh3d.box(5, 4, 3), modmesh.PointLocator3d)
+
+    def test_mixed_3d(self):
+
+        # A hexahedron with a pyramid on top and a prism on its side, and a
+        # tetrahedron under the prism.
+        ndcrd = [[0, 0, 0], [1, 0, 0], [1, 1, 0], [0, 1, 0],
+                 [0, 0, 1], [1, 0, 1], [1, 1, 1], [0, 1, 1],
+                 [0.5, 0.5, 2], [2, 0.5, 0], [2, 0.5, 1], [1.7, 0.5, -1]]
+        clnds = [0, 1, 2, 3, 4, 5, 6, 7,
+                 4, 5, 6, 7, 8,
+                 1, 9, 2, 5, 10, 6,
+                 1, 2, 9, 11]
+        mesh = modmesh.StaticMesh3d(ndcrd, [0, 8, 13, 19, 23], clnds)
+        self._check(mesh, modmesh.PointLocator3d)
+
+    def test_bad_shape(self):
+
+        locator = modmesh.PointLocator2d(modmesh.StaticMesh2d.rectangle(2, 2))
+        with self.assertRaises(ValueError):
+            locator.locate(np.zeros((3, 3)))
+
+# vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
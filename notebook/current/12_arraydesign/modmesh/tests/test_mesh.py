@@ -0,0 +1,110 @@
+# Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+# BSD-style license; see COPYING
+
+import unittest
+
+import numpy as np
+
+import modmesh
+
+
+class StaticMeshTC(unittest.TestCase):
+
+    def _check_faces(self, mesh):
+
+        invalid = mesh.INVALID
+        fccls = mesh.fccls
+        self.assertEqual((mesh.nface, 2), fccls.shape)
+        self.assertEqual(mesh.nbface, (fccls[:, 1] == invalid).sum())
+        self.assertTrue((fccls[:, 0] != invalid).all())
+        clfcs_offset = mesh.clfcs_offset
+        clnds_offset = mesh.clnds_offset
+        fcnds_offset = mesh.fcnds_offset
+        seen = np.zeros(mesh.nface, dtype='int64')
+        for icl in range(mesh.ncell):
+            nodes = set(mesh.clnds[clnds_offset[icl]:clnds_offset[icl+1]])
+            begin, end = clfcs_offset[icl], clfcs_offset[icl+1]
+            for ifc, inb in zip(mesh.clfcs[begin:end],
+                                mesh.clnbs_full[begin:end]):
+                seen[ifc] += 1
+                # The face lists the cell, and the other cell is the
+                # neighbor across it.
+                pair = fccls[ifc].tolist()
+                self.assertIn(icl, pair)
+                pair.remove(icl)
+                self.assertEqual(pair[0], inb)
+                fcnds = mesh.fcnds[fcnds_offset[ifc]:fcnds_offset[ifc+1]]
+                self.assertTrue(set(fcnds) <= nodes)
+            # clnbs is clnbs_full without the boundary.
+            full = mesh.clnbs_full[begin:end]
+            nbs = mesh.clnbs[mesh.clnbs_offset[icl]:mesh.clnbs_offset[icl+1]]
+            self.assertEqual(full[full != invalid].tolist(), nbs.tolist())
+        # A boundary face belongs to one cell and an interior face to two.
+        self.assertEqual((2 - (fccls[:, 1] == invalid)).tolist(),
+                         seen.tolist())
+
+    def test_rectangle(self):
+
+        mesh = modmesh.StaticMesh2d.rectangle(3, 2)
+        self.assertEqual(12, mesh.nnode)
+        self.assertEqual(6, mesh.ncell)
+        self.assertEqual(3*3 + 2*4, mesh.nface)
+        self.assertEqual(2*(3+2), mesh.nbface)
+        self._check_faces(mesh)
+
+    def test_rectangle_triangle(self):
+
+        mesh = modmesh.StaticMesh2d.rectangle(3, 2, triangle=True)
+        self.assertEqual(12, mesh.ncell)
+        # One more interior face per diagonal.
+        self.assertEqual(3*3 + 2*4 + 6, mesh.nface)
+        self.assertEqual(2*(3+2), mesh.nbface)
+        self._check_faces(mesh)
+
+    def test_box(self):
+
+        mesh = modmesh.StaticMesh3d.box(2, 3, 4)
+        self.assertEqual(3*4*5, mesh.nnode)
+        self.assertEqual(24, mesh.ncell)
+        self.assertEqual(3*3*4 + 2*4*4 + 2*3*5, mesh.nface)
+        self.assertEqual(2*(3*4 + 2*4 + 2*3), mesh.nbface)
+        self._check_faces(mesh)
+
+    def test_mixed_2d(self):
+
+        # A quadrilateral, a triangle on its right, and a pentagon on top.
+        ndcrd = [[0, 0], [1, 0], [1, 1], [0, 1], [2, 0.5],
+                 [1, 2], [0.5, 2.5], [0, 2]]
+        mesh = modmesh.StaticMesh2d(
+            ndcrd, [0, 4, 7, 12], [0, 1, 2, 3, 1, 4, 2, 3, 2, 5, 6, 7])
+        self.assertEqual(4 + 3 + 5 - 2, mesh.nface)
+        self.assertEqual(mesh.nface - 2, mesh.nbface)
+        self._check_faces(mesh)
+        self.assertEqual([1, 2], sorted(mesh.clnbs[0:2]))
+
+    def test_mixed_3d(self):
+
+        # A hexahedron with a pyramid on top and a prism on its side, and a
+        # tetrahedron under the prism.
+        ndcrd = [[0, 0, 0], [1, 0, 0], [1, 1, 0], [0, 1, 0],
+                 [0, 0, 1], [1, 0, 1], [1, 1, 1], [0, 1, 1],
+                 [0.5, 0.5, 2], [2, 0.5, 0], [2, 0.5, 1], [1.7, 0.5, -1]]
+        clnds = [0, 1, 2, 3, 4, 5, 6, 7,
+                 4, 5, 6, 7, 8,
+                 1, 9, 2, 5, 10, 6,
+                 1, 2, 9, 11]
+        mesh = modmesh.StaticMesh3d(ndcrd, [0, 8, 13, 19, 23], clnds)
+        self.assertEqual(6 + 5 + 5 + 4 - 3, mesh.nface)
+        self.assertEqual(mesh.nface - 3, mesh.nbface)
+        self.assertEqual([6, 11, 16, 20], mesh.clfcs_offset[1:].tolist())
+        self._check_faces(mesh)
+        # The shared faces: two quadrilaterals and a triangle.
+        invalid = mesh.INVALID
+        shared = {}
+        for ifc, pair in enumerate(mesh.fccls.tolist()):
+            if invalid != pair[1]:
+                nnd = mesh.fcnds_offset[ifc+1] - mesh.fcnds_offset[ifc]
+                shared[tuple(sorted(pair))] = nnd
+        self.assertEqual({(0, 1): 4, (0, 2): 4, (2, 3): 3}, shared)
+
+# vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
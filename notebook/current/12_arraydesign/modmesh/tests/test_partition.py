@@ -0,0 +1,82 @@
+# Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+# BSD-style license; see COPYING
+
+import unittest
+
+import numpy as np
+
+import modmesh
+
+
+class GraphPartitionerTC(unittest.TestCase):
+
+    def setUp(self):
+
+        self.graph = modmesh.StaticGraph.dual(
+            modmesh.StaticMesh2d.rectangle(40, 30))
+
+    @staticmethod
+    def _edge_cut(graph, part):
+
+        xadj = graph.xadj
+        # Each edge is listed by both of its vertices.
+        owner = np.repeat(np.arange(graph.nvertex), np.diff(xadj))
+        cut = part[owner] != part[graph.adjncy]
+        return int(graph.adjwgt.astype('int64')[cut].sum()) // 2
+
+    def test_dual(self):
+
+        graph = self.graph
+        self.assertEqual(40*30, graph.nvertex)
+        self.assertEqual(39*30 + 40*29, graph.nedge)
+        self.assertEqual(2*graph.nedge, graph.xadj[-1])
+
+    def test_partition(self):
+
+        graph = self.graph
+        partitioner = modmesh.GraphPartitioner(seed=7)
+        # A straight cut crosses 30 edges and the four quadrants 70.
+        for nparts, maxcut in ((2, 2*30), (4, 2*70), (7, 250), (8, 250)):
+            part = partitioner.partition(graph, nparts)
+            # Every vertex is in exactly one part and no part is empty.
+            self.assertEqual((graph.nvertex,), part.shape)
+            self.assertEqual(list(range(nparts)), np.unique(part).tolist())
+            cut = graph.edge_cut(part)
+            self.assertEqual(self._edge_cut(graph, part), cut)
+            self.assertLessEqual(cut, maxcut)
+            counts = np.bincount(part, minlength=nparts)
+            imbalance = graph.imbalance(part, nparts)
+            self.assertAlmostEqual(counts.max() * nparts / graph.nvertex,
+                                   imbalance)
+            self.assertLessEqual(imbalance, partitioner.ubfactor + 1.e-12)
+
+    def test_seed(self):
+
+        graph = self.graph
+        part = modmesh.GraphPartitioner(seed=11).partition(graph, 4)
+        again = modmesh.GraphPartitioner(seed=11).partition(graph, 4)
+        self.assertEqual(part.tolist(), again.tolist())
+
+    def test_heavy_edges(self):
+
+        # The coarse edges sum the weights beyond 32 bits.  Scaling every
+        # weight must not change the parts.
+        graph = self.graph
+        heavy = modmesh.StaticGraph(
+            graph.xadj, graph.adjncy, graph.vwgt,
+            np.full(graph.adjncy.shape, 2**31, dtype='uint32'))
+        partitioner = modmesh.GraphPartitioner(seed=7)
+        for nparts in (2, 4, 8):
+            part = partitioner.partition(graph, nparts)
+            other = partitioner.partition(heavy, nparts)
+            self.assertEqual(part.tolist(), other.tolist())
+            self.assertEqual(graph.edge_cut(part) * 2**31,
+                             heavy.edge_cut(other))
+
+    def test_bad_part(self):
+
+        graph = self.graph
+        with self.assertRaises(IndexError):
+            graph.imbalance(np.full(graph.nvertex, 4, dtype='uint32'), 4)
+
+# vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,88 @@
+# Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+# BSD-style license; see COPYING
+
+import unittest
+
+import numpy as np
+
+import modmesh
+
+
+class PoissonSolver2dTC(unittest.TestCase):
+
+    @staticmethod
+    def _problem(n):
+
+        """-(u_xx + u_yy) = f on the unit square with u = sin(pi x)
+        sin(pi y), which is 0 on the boundary."""
+        h = 1.0 / (n + 1)
+        x = np.arange(n + 2) * h
+        exact = np.outer(np.sin(np.pi*x), np.sin(np.pi*x))
+        f = modmesh.StaticGrid2d(n, n, nghost=1)
+        f.from_array(2 * np.pi**2 * exact)
+        u = modmesh.StaticGrid2d(n, n, nghost=1)
+        u.fill(0.0)
+        return h, exact[1:-1, 1:-1], u, f
+
+    def test_vcycle(self):
+
+        for n, nlevel in ((63, 6), (100, 7), (257, 8)):
+            h, exact, u, f = self._problem(n)
+            solver = modmesh.PoissonSolver2d(n, n, hx=h, hy=h)
+            self.assertEqual(nlevel, solver.nlevel)
+            r0 = solver.residual(u, f)
+            ncycle, res = solver.solve(u, f, tolerance=1.e-9*r0)
+            # The convergence does not depend on the size of the grid.
+            self.assertLessEqual(9, ncycle)
+            self.assertLessEqual(ncycle, 11)
+            self.assertLessEqual(res, 1.e-9*r0)
+            np.testing.assert_allclose(res, solver.residual(u, f), rtol=1.e-6)
+            # The discretization error is O(h^2).
+            err = np.abs(u.interior - exact).max()
+            self.assertLess(0.7*h**2, err)
+            self.assertLess(err, 0.9*h**2)
+
+    def test_vcycle_rate(self):
+
+        n = 127
+        h, exact, u, f = self._problem(n)
+        solver = modmesh.PoissonSolver2d(n, n, hx=h, hy=h)
+        norms = [solver.vcycle(u, f) for it in range(6)]
+        for prev, cur in zip(norms[1:-1], norms[2:]):
+            self.assertLess(cur, 0.2*prev)
+
+    def test_sor(self):
+
+        n = 63
+        h, exact, u, f = self._problem(n)
+        solver = modmesh.PoissonSolver2d(n, n, hx=h, hy=h)
+        omega = 2 / (1 + np.sin(np.pi*h))
+        solver.sor(u, f, omega=omega, nsweep=50)
+        res = [solver.residual(u, f)]
+        change = []
+        for it in range(4):
+            change.append(solver.sor(u, f, omega=omega, nsweep=50))
+            res.append(solver.residual(u, f))
+        for prev, cur in zip(res[:-1], res[1:]):
+            self.assertLess(cur, 0.05*prev)
+        for prev, cur in zip(change[:-1], change[1:]):
+            self.assertLess(cur, prev)
+        # Gauss-Seidel converges much slower.
+        gs = modmesh.StaticGrid2d(n, n, nghost=1)
+        gs.fill(0.0)
+        solver.sor(gs, f, nsweep=250)
+        self.assertLess(1.e4*res[-1], solver.residual(gs, f))
+        with self.assertRaises(ValueError):
+            solver.sor(u, f, omega=2.0)
+
+    def test_bad_grid(self):
+
+        solver = modmesh.PoissonSolver2d(7, 7)
+        u = modmesh.StaticGrid2d(7, 5, nghost=1)
+        f = modmesh.StaticGrid2d(7, 7, nghost=1)
+        with self.assertRaises(ValueError):
+            solver.residual(u, f)
+        with self.assertRaises(ValueError):
+            modmesh.PoissonSolver2d(0, 7)
+
+# vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,143 @@
+# Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+# BSD-style license; see COPYING
+
+import unittest
+
+import numpy as np
+
+import modmesh
+
+
+class PolynomialFitterTC(unittest.TestCase):
+
+    def setUp(self):
+
+        self.rng = np.random.default_rng(50)
+
+    def _points(self, npoint, order, lo=-3.0, hi=5.0):
+
+        """Sorted x and noisy y of a random polynomial."""
+        x = np.sort(lo + (hi - lo) * self.rng.random(npoint))
+        y = np.polyval(self.rng.random(order+1) - 0.5, x)
+        return x, y + 0.01 * (self.rng.random(npoint) - 0.5)
+
+    def _gold(self, x, y, offsets, order):
+
+        """Fit the groups one by one with numpy.polyfit."""
+        return np.array([np.polyfit(x[lo:hi], y[lo:hi], order)
+                         for lo, hi in zip(offsets[:-1], offsets[1:])])
+
+    def test_fit(self):
+
+        for order in range(5):
+            fitter = modmesh.PolynomialFitter(order)
+            self.assertEqual(order, fitter.order)
+            self.assertEqual(order+1, fitter.ncoefficient)
+            x, y = self._points(1001, order)
+            # The coefficients start from the highest degree.
+            np.testing.assert_allclose(fitter.fit(x, y),
+                                       np.polyfit(x, y, order),
+                                       rtol=1.e-8, atol=1.e-10)
+
+    def test_bin_offsets(self):
+
+        x, y = self._points(1000, 0)
+        # The edges out of the points and on the points.
+        edges = np.concatenate([[-4.0], np.linspace(-3, 5, 17), x[::97],
+                                [6.0]])
+        edges.sort()
+        offsets = modmesh.PolynomialFitter.bin_offsets(x, edges)
+        self.assertEqual(np.searchsorted(x, edges).tolist(),
+                         offsets.tolist())
+        with self.assertRaises(ValueError):
+            modmesh.PolynomialFitter.bin_offsets(x, edges[::-1].copy())
+        with self.assertRaises(ValueError):
+            modmesh.PolynomialFitter.bin_offsets(x, np.zeros(0))
+        with self.assertRaises(ValueError):
+            modmesh.PolynomialFitter.bin_offsets(x, np.zeros((2, 2)))
+
+    def test_fit_bins(self):
+
+        order = 3
+        fitter = modmesh.PolynomialFitter(order)
+        x, y = self._points(5000, order)
+        edges = np.linspace(-3, 5, 41)
+        ret = fitter.fit_bins(x, y, edges)
+        self.assertEqual((40, order+1), ret.shape)
+        offsets = np.searchsorted(x, edges)
+        np.testing.assert_allclose(ret, self._gold(x, y, offsets, order),
+                                   rtol=1.e-6, atol=1.e-8)
+        out = np.full((40, order+1), -1.0)
+        self.assertIsNone(fitter.fit_bins(x, y, edges, out))
+        np.testing.assert_array_equal(ret, out)
+
+    def test_fit_groups(self):
+
+        order = 2
+        fitter = modmesh.PolynomialFitter(order)
+        x, y = self._points(3000, order)
+        # Groups of various sizes, with an empty one.
+        offsets = np.array([0, 3, 10, 10, 500, 1800, 3000], dtype='int64')
+        ret = fitter.fit_groups(x, y, offsets)
+        self.assertEqual((6, order+1), ret.shape)
+        self.assertTrue(np.isnan(ret[2]).all())
+        gold = self._gold(x, y, offsets[[0, 1, 2, 4, 5, 6]], order)
+        np.testing.assert_allclose(ret[[0, 1, 3, 4, 5]], gold,
+                                   rtol=1.e-6, atol=1.e-8)
+        # The preallocated result may be an ndarray or a SimpleArray.
+        out = np.full((6, order+1), -1.0)
+        self.assertIsNone(fitter.fit_groups(x, y, offsets, out))
+        np.testing.assert_array_equal(ret, out)
+        sarr = modmesh.SimpleArrayFloat64((6, order+1))
+        self.assertIsNone(fitter.fit_groups(x, y, offsets, sarr))
+        np.testing.assert_array_equal(ret, sarr.ndarray)
+        # The offsets need not start from the first point.
+        np.testing.assert_array_equal(
+            ret[3:], fitter.fit_groups(x, y, offsets[3:]))
+
+    def test_few_distinct(self):
+
+        # A group of too few distinct x for the order gets NaN.
+        fitter = modmesh.PolynomialFitter(2)
+        x = np.array([0.0, 1.0, 2.0, 2.0, 2.0, 3.0, 3.0, 5.0, 5.0, 5.0, 6.0,
+                      7.0, 8.0])
+        y = x**2
+        offsets = np.array([0, 2, 7, 10, 13], dtype='int64')
+        ret = fitter.fit_groups(x, y, offsets)
+        # Two points, two distinct x, one distinct x, and three distinct x.
+        self.assertTrue(np.isnan(ret[:3]).all())
+        np.testing.assert_allclose(ret[3], [1, 0, 0], rtol=0, atol=1.e-9)
+        self.assertTrue(np.isnan(fitter.fit(x[:2], y[:2])).all())
+        # The same point repeated.
+        self.assertTrue(np.isnan(
+            modmesh.PolynomialFitter(1).fit(np.ones(10), np.ones(10))).all())
+
+    def test_bad(self):
+
+        with self.assertRaises(ValueError):
+            modmesh.PolynomialFitter(modmesh.PolynomialFitter.MAX_ORDER + 1)
+        fitter = modmesh.PolynomialFitter(1)
+        x, y = self._points(10, 1)
+        with self.assertRaises(ValueError):
+            fitter.fit(x, y[:-1])
+        with self.assertRaises(ValueError):
+            fitter.fit_groups(x, y, np.array([0, 5, 3], dtype='int64'))
+        with self.assertRaises(ValueError):
+            fitter.fit_groups(x, y, np.array([0, 11], dtype='int64'))
+        offsets = np.array([0, 5, 10], dtype='int64')
+        with self.assertRaises(ValueError):
+            fitter.fit_groups(x, y, offsets,
+                              modmesh.SimpleArrayFloat64((2, 3)))
+        # The result is written in place, so it is never converted.
+        for out in (np.zeros((2, 2), dtype='float32'),
+                    np.zeros((2, 4))[:, ::2], np.zeros(4)):
+            with self.assertRaises(ValueError):
+                fitter.fit_groups(x, y, offsets, out)
+        out = np.zeros((2, 2))
+        out.flags.writeable = False
+        with self.assertRaises(ValueError):
+            fitter.fit_groups(x, y, offsets, out)
+        with self.assertRaises(ValueError):
+            fitter.fit_bins(x, y, np.zeros((2, 2)), np.zeros((1, 2)))
+
+# vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
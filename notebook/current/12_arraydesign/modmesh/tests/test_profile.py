@@ -0,0 +1,354 @@
+# Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+# BSD-style license; see COPYING
+
+import json
+import os
+import subprocess
+import sys
+import threading
+import time
+import unittest
+
+import modmesh
+
+
+class TimeRegistryTC(unittest.TestCase):
+
+    def setUp(self):
+
+        self.registry = modmesh.time_registry
+        self.registry.enable('test_profile.scope')
+
+    def tearDown(self):
+
+        self.registry.disable('test_profile.scope')
+
+    def _count(self):
+
+        stat = self.registry.snapshot().get('test_profile.scope')
+        return 0 if stat is None else stat['count']
+
+    def test_threads(self):
+
+        # Each thread records in its own shard.  The shards of the exited
+        # threads are merged into the registry.
+        def _run():
+            for it in range(100):
+                with modmesh.TimedScope('test_profile.scope'):
+                    pass
+
+        count = self._count()
+        threads = [threading.Thread(target=_run) for it in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        self.assertEqual(count + 400, self._count())
+        # The live shard of this thread is merged too.
+        _run()
+        self.assertEqual(count + 500, self._count())
+
+    def test_disabled(self):
+
+        self.registry.disable('test_profile.scope')
+        count = self._count()
+        with modmesh.TimedScope('test_profile.scope'):
+            pass
+        self.assertEqual(count, self._count())
+
+
+class TimedScopeTC(unittest.TestCase):
+
+    def setUp(self):
+
+        self.registry = modmesh.time_registry
+        self.registry.enable('test_profile.outer')
+        self.registry.enable('test_profile.inner')
+        self.registry.call_tree = True
+
+    def tearDown(self):
+
+        self.registry.call_tree = False
+        self.registry.disable('test_profile.outer')
+        self.registry.disable('test_profile.inner')
+
+    def test_mismatched_exit(self):
+
+        outer = modmesh.TimedScope('test_profile.outer')
+        inner = modmesh.TimedScope('test_profile.inner')
+        outer.__enter__()
+        inner.__enter__()
+        with self.assertRaises(RuntimeError):
+            outer.__exit__(None, None, None)
+        inner.__exit__(None, None, None)
+        outer.__exit__(None, None, None)
+        with self.assertRaises(RuntimeError):
+            outer.__exit__(None, None, None)
+        # The call tree still nests the inner scope under the outer one.
+        lines = self.registry.report_tree().splitlines()
+        iouter = [it for it, line in enumerate(lines)
+                  if line.startswith('test_profile.outer')]
+        self.assertEqual(1, len(iouter))
+        self.assertTrue(lines[iouter[0]+1].startswith('  test_profile.inner'))
+
+    def test_exit_in_other_thread(self):
+
+        scope = modmesh.TimedScope('test_profile.outer')
+        errors = []
+
+        def _exit():
+            try:
+                scope.__exit__(None, None, None)
+            except RuntimeError as exc:
+                errors.append(exc)
+
+        with scope:
+            thread = threading.Thread(target=_exit)
+            thread.start()
+            thread.join()
+        self.assertEqual(1, len(errors))
+
+
+class ClockTC(unittest.TestCase):
+
+    def setUp(self):
+
+        self.clock = modmesh.clock
+        self.source = self.clock.source
+        self.registry = modmesh.time_registry
+        self.registry.enable('test_profile.clock')
+
+    def tearDown(self):
+
+        self.registry.disable('test_profile.clock')
+        self.clock.source = self.source
+
+    def _spin(self, seconds):
+
+        """Seconds a busy loop of the wall time takes on the clock."""
+        stat = self.registry.snapshot().get('test_profile.clock')
+        before = 0.0 if stat is None else stat['time']
+        with modmesh.TimedScope('test_profile.clock'):
+            end = time.perf_counter() + seconds
+            while time.perf_counter() < end:
+                pass
+        return self.registry.snapshot()['test_profile.clock']['time'] - before
+
+    def test_source(self):
+
+        for name in ('monotonic', 'thread_cpu', 'process_cpu'):
+            self.clock.source = name
+            self.assertEqual(name, self.clock.source)
+            self.assertEqual(1.e9, self.clock.frequency)
+        self.clock.source = 'monotonic'
+        self.assertAlmostEqual(0.05, self._spin(0.05), delta=0.01)
+        with self.assertRaises(ValueError):
+            self.clock.source = 'sundial'
+        self.assertEqual('monotonic', self.clock.source)
+
+    def test_tsc(self):
+
+        if not modmesh.Clock.has_invariant_tsc:
+            with self.assertRaises(RuntimeError):
+                self.clock.source = 'tsc'
+            return
+        self.clock.source = 'tsc'
+        self.assertEqual('tsc', self.clock.source)
+        # Calibrated against the monotonic clock.
+        self.assertGreater(self.clock.frequency, 1.e8)
+        self.assertAlmostEqual(0.05, self._spin(0.05), delta=0.01)
+
+    def test_environment(self):
+
+        # A bad MODMESH_CLOCK falls back to the monotonic clock with a
+        # warning, and the timed scopes keep working.
+        path = os.path.dirname(os.path.dirname(modmesh.__file__))
+        env = dict(os.environ)
+        env['PYTHONPATH'] = os.pathsep.join(
+            [path] + env.get('PYTHONPATH', '').split(os.pathsep))
+        code = ('import modmesh\n'
+                'modmesh.time_registry.enable("test_profile.env")\n'
+                'with modmesh.TimedScope("test_profile.env"):\n'
+                '    pass\n'
+                'print(modmesh.clock.source)\n')
+        names = ['sundial']
+        if not modmesh.Clock.has_invariant_tsc:
+            names.append('tsc')
+        for name in names:
+            env['MODMESH_CLOCK'] = name
+            proc = subprocess.run([sys.executable, '-c', code], env=env,
+                                  capture_output=True, text=True)
+            self.assertEqual(0, proc.returncode, proc.stderr)
+            self.assertEqual('monotonic', proc.stdout.strip())
+            self.assertIn('MODMESH_CLOCK', proc.stderr)
+
+
+class ChromeTraceTC(unittest.TestCase):
+
+    def setUp(self):
+
+        self.source = modmesh.clock.source
+        self.registry = modmesh.time_registry
+        self.registry.enable('test_profile.trace')
+        self.registry.trace = True
+
+    def tearDown(self):
+
+        self.registry.trace = False
+        self.registry.disable('test_profile.trace')
+        modmesh.clock.source = self.source
+
+    def test_switch_source(self):
+
+        # The timeline keeps one time base when the clock source changes.
+        names = ['monotonic', 'thread_cpu', 'process_cpu']
+        if modmesh.Clock.has_invariant_tsc:
+            names.append('tsc')
+        for name in names:
+            modmesh.clock.source = name
+            with modmesh.TimedScope('test_profile.trace'):
+                time.sleep(0.01)
+        trace = json.loads(self.registry.chrome_trace())
+        events = [event for event in trace['traceEvents']
+                  if 'test_profile.trace' == event['name']][-len(names):]
+        self.assertEqual(len(names), len(events))
+        for prev, cur in zip(events[:-1], events[1:]):
+            self.assertLessEqual(prev['ts'] + prev['dur'], cur['ts'])
+        for event in events:
+            self.assertGreaterEqual(event['ts'], 0)
+            # Sleeping takes wall time but no CPU time.
+            self.assertGreaterEqual(event['dur'], 1.e4)
+            self.assertLess(event['dur'], 1.e6)
+
+
+class CounterTC(unittest.TestCase):
+
+    events = ('cycles', 'instructions', 'LLC misses', 'branch misses')
+
+    def setUp(self):
+
+        self.registry = modmesh.time_registry
+        self.registry.enable('test_profile.counter')
+        self.registry.counters = True
+
+    def tearDown(self):
+
+        self.registry.counters = False
+        self.registry.disable('test_profile.counter')
+
+    def test_counters(self):
+
+        # Runs whether perf_event_open is permitted or not.  Without it the
+        # scopes are timed as usual and count no events.
+        before = self.registry.snapshot().get('test_profile.counter')
+        for it in range(10):
+            with modmesh.TimedScope('test_profile.counter'):
+                sum(range(10000))
+        stat = self.registry.snapshot()['test_profile.counter']
+        ncount = stat['count'] - (0 if before is None else before['count'])
+        self.assertEqual(10, ncount)
+        available = self.registry.counters_available
+        self.assertTrue(set(available) <= set(self.events))
+        self.assertEqual(set(self.events), set(stat['events']))
+        line = [line for line in self.registry.report().splitlines()
+                if line.startswith('test_profile.counter ')][0]
+        if not available:
+            self.assertEqual(0, stat['ncounted'])
+            self.assertTrue(all(0 == val for val in stat['events'].values()))
+            self.assertNotIn('cycles =', line)
+            return
+        self.assertLessEqual(10, stat['ncounted'])
+        for name in self.events:
+            if name in available:
+                self.assertIn(name + ' =', line)
+            else:
+                self.assertEqual(0, stat['events'][name])
+        if 'instructions' in available:
+            self.assertGreater(stat['events']['instructions'], 0)
+        # Turned off, the scopes count no more events.
+        self.registry.counters = False
+        ncounted = stat['ncounted']
+        with modmesh.TimedScope('test_profile.counter'):
+            pass
+        stat = self.registry.snapshot()['test_profile.counter']
+        self.assertEqual(ncounted, stat['ncounted'])
+
+
+class LatencyHistogramTC(unittest.TestCase):
+
+    name = 'test_profile.latency'
+
+    def setUp(self):
+
+        self.registry = modmesh.time_registry
+        self.registry.snapshot(reset=True)
+
+    @staticmethod
+    def _lower(ns):
+
+        """Lower bound of the bucket: 8 linear buckets per power of 2."""
+        if ns < 8:
+            return ns
+        shift = ns.bit_length() - 4
+        return (ns >> shift) << shift
+
+    def _add(self, ns):
+
+        # Half a nanosecond more, so that the truncation keeps ns.
+        self.registry.add(self.name, (ns + 0.5) * 1.e-9)
+
+    def test_bucket(self):
+
+        durations = [0, 3, 7, 8, 9, 15, 16, 17, 18, 19, 1000, 1023, 1024,
+                     123456789]
+        for ns in durations:
+            self._add(ns)
+        stat = self.registry.snapshot()[self.name]
+        self.assertEqual(len(durations), stat['count'])
+        lower, count = stat['histogram']
+        expect = {}
+        for ns in durations:
+            key = self._lower(ns)
+            expect[key] = expect.get(key, 0) + 1
+        self.assertEqual(sorted(expect), [round(val*1.e9) for val in lower])
+        self.assertEqual([expect[key] for key in sorted(expect)],
+                         count.tolist())
+        self.assertEqual(0, stat['min'])
+        self.assertAlmostEqual(123456789e-9, stat['max'], places=15)
+
+    def test_percentile(self):
+
+        # Uniform from 1 to 1000 microseconds.
+        for it in range(1000):
+            self._add((it + 1) * 1000)
+        stat = self.registry.snapshot()[self.name]
+        self.assertEqual(1000, stat['count'])
+        self.assertAlmostEqual(1.e-6, stat['min'], places=15)
+        self.assertAlmostEqual(1.e-3, stat['max'], places=15)
+        # The middle of a bucket is within 1/16 of the exact value.
+        for key, value in (('p50', 500.e-6), ('p90', 900.e-6),
+                           ('p99', 990.e-6)):
+            self.assertAlmostEqual(value, stat[key], delta=value/16)
+        # A single duration is exact, since the extrema bound it.
+        self.registry.snapshot(reset=True)
+        self._add(777777)
+        stat = self.registry.snapshot()[self.name]
+        for key in ('min', 'p50', 'p90', 'p99', 'max'):
+            self.assertAlmostEqual(777777e-9, stat[key], places=15)
+
+    def test_reset(self):
+
+        for ns in (100, 200, 300):
+            self._add(ns)
+        stat = self.registry.snapshot(reset=True)[self.name]
+        self.assertEqual(3, stat['count'])
+        self.assertNotIn(self.name, self.registry.snapshot())
+        self._add(5000)
+        stat = self.registry.snapshot()[self.name]
+        self.assertEqual(1, stat['count'])
+        lower, count = stat['histogram']
+        self.assertEqual([1], count.tolist())
+        self.assertAlmostEqual(5000e-9, stat['min'], places=15)
+        self.assertAlmostEqual(5000e-9, stat['max'], places=15)
+
+# vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,98 @@
+# Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+# BSD-style license; see COPYING
+
+import unittest
+
+import numpy as np
+
+import modmesh
+
+
+class ReorderTC(unittest.TestCase):
+
+    methods = ('rcm', 'hilbert', 'morton')
+
+    def setUp(self):
+
+        # Shuffle a rectangle mesh so that it starts with a poor locality.
+        mesh = modmesh.StaticMesh2d.rectangle(30, 20)
+        rng = np.random.default_rng(44)
+        self.mesh = mesh.renumber(rng.permutation(mesh.ncell),
+                                  rng.permutation(mesh.nnode))
+
+    @staticmethod
+    def _cells(mesh):
+
+        offset = mesh.clnds_offset
+        return [mesh.clnds[offset[icl]:offset[icl+1]]
+                for icl in range(mesh.ncell)]
+
+    @classmethod
+    def _area(cls, mesh):
+
+        ndcrd = mesh.ndcrd
+        area = 0.0
+        for nds in cls._cells(mesh):
+            x, y = ndcrd[nds, 0], ndcrd[nds, 1]
+            area += 0.5 * (x.dot(np.roll(y, -1)) - y.dot(np.roll(x, -1)))
+        return area
+
+    def test_permutation(self):
+
+        mesh = self.mesh
+        for method in self.methods:
+            self.assertEqual(list(range(mesh.ncell)),
+                             sorted(mesh.cell_order(method).tolist()))
+            self.assertEqual(list(range(mesh.nnode)),
+                             sorted(mesh.node_order(method).tolist()))
+        with self.assertRaises(ValueError):
+            mesh.cell_order('random')
+
+    def test_rcm_bandwidth(self):
+
+        mesh = self.mesh
+        other = mesh.renumber(mesh.cell_order('rcm'), mesh.node_order('rcm'))
+        # A row of 30 cells bounds the bandwidths of the best orders.
+        self.assertLess(4*other.cell_bandwidth, mesh.cell_bandwidth)
+        self.assertLessEqual(other.cell_bandwidth, 2*30)
+        self.assertLess(4*other.node_bandwidth, mesh.node_bandwidth)
+        self.assertLessEqual(other.node_bandwidth, 2*32)
+
+    def test_renumber(self):
+
+        mesh = self.mesh
+        cells = self._cells(mesh)
+        area = self._area(mesh)
+        np.testing.assert_allclose(area, 1.0, rtol=1.e-12)
+        for method in self.methods:
+            cell_order = mesh.cell_order(method)
+            node_order = mesh.node_order(method)
+            other = mesh.renumber(cell_order, node_order)
+            self.assertEqual(mesh.nface, other.nface)
+            self.assertEqual(mesh.nbface, other.nbface)
+            np.testing.assert_allclose(self._area(other), area, rtol=1.e-12)
+            self.assertEqual(mesh.ndcrd[node_order].tolist(),
+                             other.ndcrd.tolist())
+            # Every new cell has the nodes of its old cell.
+            for icl, nds in enumerate(self._cells(other)):
+                self.assertEqual(cells[cell_order[icl]].tolist(),
+                                 node_order[nds].tolist())
+            # And the neighbors of its old cell.
+            offset = other.clnbs_offset
+            old_offset = mesh.clnbs_offset
+            for icl in range(other.ncell):
+                jcl = cell_order[icl]
+                nbs = cell_order[other.clnbs[offset[icl]:offset[icl+1]]]
+                old = mesh.clnbs[old_offset[jcl]:old_offset[jcl+1]]
+                self.assertEqual(sorted(old.tolist()), sorted(nbs.tolist()))
+
+    def test_not_permutation(self):
+
+        mesh = self.mesh
+        node_order = np.arange(mesh.nnode)
+        with self.assertRaises(ValueError):
+            mesh.renumber(np.zeros(mesh.ncell), node_order)
+        with self.assertRaises(ValueError):
+            mesh.renumber(np.arange(mesh.ncell - 1), node_order)
+
+# vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,253 @@
+# Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+# BSD-style license; see COPYING
+
+import unittest
+
+import numpy as np
+
+import modmesh
+
+
+def _distance(kind, crd, pt):
+
+    """Distances from the point to the items by brute force."""
+    if 'points' == kind:
+        return np.sqrt(((crd - pt)**2).sum(axis=1))
+    if 'segments' == kind:
+        p0, p1 = crd[:, 0], crd[:, 1]
+        d = p1 - p0
+        t = ((pt - p0) * d).sum(axis=1) / (d * d).sum(axis=1)
+        t = np.clip(t, 0, 1)[:, None]
+        return np.sqrt(((p0 + t*d - pt)**2).sum(axis=1))
+    out = np.maximum(np.maximum(crd[:, 0] - pt, pt - crd[:, 1]), 0)
+    return np.sqrt((out**2).sum(axis=1))
+
+
+def _overlap(kind, crd, lo, hi):
+
+    """Whether the items overlap the box, by brute force."""
+    if 'points' == kind:
+        return ((crd >= lo) & (crd <= hi)).all(axis=1)
+    if 'segments' == kind:
+        # Clip the parameter range of the segments by the slabs.
+        p0, d = crd[:, 0], crd[:, 1] - crd[:, 0]
+        t0 = (lo - p0) / d
+        t1 = (hi - p0) / d
+        tlo = np.maximum(np.minimum(t0, t1).max(axis=1), 0)
+        thi = np.minimum(np.maximum(t0, t1).min(axis=1), 1)
+        return tlo <= thi
+    return ((crd[:, 0] <= hi) & (crd[:, 1] >= lo)).all(axis=1)
+
+
+class SpatialTC(unittest.TestCase):
+
+    def _random(self, kind, nitem, ndim):
+
+        """Coordinates of the random items of the kind."""
+        rng = self.rng
+        if 'points' == kind:
+            return rng.random((nitem, ndim))
+        lo = rng.random((nitem, ndim))
+        if 'segments' == kind:
+            return np.stack([lo, lo + 0.1*(rng.random((nitem, ndim)) - 0.5)],
+                            axis=1)
+        return np.stack([lo, lo + 0.05*rng.random((nitem, ndim))], axis=1)
+
+    def _queries(self, nquery, ndim):
+
+        rng = self.rng
+        lo = rng.random((nquery, ndim)) - 0.1
+        box = np.stack([lo, lo + 0.2*rng.random((nquery, ndim))], axis=1)
+        return box, rng.random((nquery, ndim)) * 1.2 - 0.1
+
+    def _check(self, index, kind, ids, crd, nquery=200, k=5):
+
+        """Compare the queries to brute force over the items of the ids."""
+        ndim = crd.shape[-1]
+        box, pts = self._queries(nquery, ndim)
+        offset, found = index.range(box)
+        self.assertEqual((nquery+1,), offset.shape)
+        for iq in range(nquery):
+            gold = ids[_overlap(kind, crd, box[iq, 0], box[iq, 1])]
+            self.assertEqual(sorted(gold.tolist()),
+                             sorted(found[offset[iq]:offset[iq+1]].tolist()))
+        near, dist = index.nearest(pts, k=k)
+        self.assertEqual((nquery, k), near.shape)
+        self.assertEqual((nquery, k), dist.shape)
+        for iq in range(nquery):
+            gold = _distance(kind, crd, pts[iq])
+            # Compare the distances, since the items may tie.
+            np.testing.assert_allclose(dist[iq], np.sort(gold)[:k],
+                                       rtol=1.e-12, atol=1.e-15)
+            pos = np.searchsorted(ids, near[iq])
+            np.testing.assert_allclose(dist[iq], gold[pos],
+                                       rtol=1.e-12, atol=1.e-15)
+
+
+class SpatialIndexTC(SpatialTC):
+
+    classes = ((modmesh.SpatialIndex2d, 2), (modmesh.SpatialIndex3d, 3))
+    kinds = ('points', 'segments', 'boxes')
+
+    def setUp(self):
+
+        self.rng = np.random.default_rng(45)
+
+    def test_queries(self):
+
+        for cls, ndim in self.classes:
+            for kind in self.kinds:
+                crd = self._random(kind, 3000, ndim)
+                index = getattr(cls, kind)(crd)
+                self.assertEqual(3000, len(index))
+                self._check(index, kind, np.arange(3000), crd)
+
+    def test_sorted_batch(self):
+
+        # A batch this large is answered along the Morton curve.
+        for cls, ndim in self.classes:
+            crd = self._random('points', 1000, ndim)
+            index = cls.points(crd)
+            self._check(index, 'points', np.arange(1000), crd, nquery=5000)
+
+    def test_few_items(self):
+
+        crd = self._random('boxes', 3, 2)
+        index = modmesh.SpatialIndex2d.boxes(crd)
+        near, dist = index.nearest(np.zeros((1, 2)), k=5)
+        self.assertEqual([index.INVALID]*2, near[0, 3:].tolist())
+        self.assertTrue(np.isinf(dist[0, 3:]).all())
+        self._check(index, 'boxes', np.arange(3), crd, k=3)
+
+    def test_bad_shape(self):
+
+        with self.assertRaises(ValueError):
+            modmesh.SpatialIndex2d.segments(np.zeros((4, 2)))
+        index = modmesh.SpatialIndex3d.points(np.zeros((4, 3)))
+        with self.assertRaises(ValueError):
+            index.range(np.zeros((4, 3)))
+        with self.assertRaises(ValueError):
+            index.nearest(np.zeros((4, 2)))
+
+
+class SpatialIndexUpdateTC(SpatialTC):
+
+    def setUp(self):
+
+        self.rng = np.random.default_rng(47)
+
+    def _check_live(self, index, kind, live):
+
+        ids = np.array(sorted(live))
+        crd = np.array([live[it] for it in ids])
+        self.assertEqual(len(live), len(index))
+        self._check(index, kind, ids, crd, nquery=100)
+
+    def _update(self, index, kind, ndim, live):
+
+        rng = self.rng
+        removed = rng.choice(sorted(live), 500, replace=False)
+        index.remove(removed)
+        for it in removed:
+            del live[it]
+            self.assertFalse(index.alive(it))
+        crd = self._random(kind, 700, ndim)
+        ids = index.insert(crd)
+        # The removed ids are reused.
+        self.assertEqual(700, len(set(ids.tolist())))
+        self.assertTrue(set(removed.tolist()) <= set(ids.tolist()))
+        for it, item in zip(ids, crd):
+            self.assertNotIn(it, live)
+            live[it] = item
+        moved = rng.choice(sorted(live), 300, replace=False)
+        crd = self._random(kind, 300, ndim)
+        index.refit(moved, crd)
+        for it, item in zip(moved, crd):
+            live[it] = item
+
+    def test_update(self):
+
+        for cls, ndim in SpatialIndexTC.classes:
+            for kind in SpatialIndexTC.kinds:
+                crd = self._random(kind, 2000, ndim)
+                index = getattr(cls, kind)(crd)
+                live = dict(enumerate(crd))
+                for it in range(3):
+                    self._update(index, kind, ndim, live)
+                    self._check_live(index, kind, live)
+                index.rebuild()
+                self._check_live(index, kind, live)
+
+    def test_drift(self):
+
+        # Moving every item degrades the tree until it is rebuilt, which
+        # keeps the cost within 1.5 times that when built.
+        crd = self._random('boxes', 5000, 3)
+        index = modmesh.SpatialIndex3d.boxes(crd)
+        ids = np.arange(5000)
+        for it in range(10):
+            crd = crd + 0.2 * (self.rng.random((5000, 1, 3)) - 0.5)
+            index.refit(ids, crd)
+            self.assertLess(index.quality, 1.5)
+        self.assertEqual(5000, index.nid)
+        self._check(index, 'boxes', ids, crd)
+
+    def test_bad_items(self):
+
+        index = modmesh.SpatialIndex2d.points(np.zeros((4, 2)))
+        index.remove([1])
+        with self.assertRaises(IndexError):
+            index.remove([1])
+        with self.assertRaises(IndexError):
+            index.refit([4], np.zeros((1, 2)))
+        with self.assertRaises(ValueError):
+            index.refit([0, 0], np.zeros((2, 2)))
+        with self.assertRaises(ValueError):
+            index.insert(np.zeros((1, 3)))
+
+
+class KdTreeTC(SpatialTC):
+
+    classes = ((modmesh.KdTree2d, 2), (modmesh.KdTree3d, 3))
+
+    def setUp(self):
+
+        self.rng = np.random.default_rng(46)
+
+    def test_queries(self):
+
+        # The last bucket is partly filled unless the size is a multiple of
+        # eight.
+        for cls, ndim in self.classes:
+            for npoint in (1, 5, 8, 3001):
+                crd = self._random('points', npoint, ndim)
+                tree = cls(crd)
+                self.assertEqual(npoint, len(tree))
+                self._check(tree, 'points', np.arange(npoint), crd,
+                            k=min(npoint, 5))
+
+    def test_sorted_batch(self):
+
+        for cls, ndim in self.classes:
+            crd = self._random('points', 1000, ndim)
+            self._check(cls(crd), 'points', np.arange(1000), crd,
+                        nquery=5000, k=3)
+
+    def test_duplicates(self):
+
+        # The median splits meet many equal coordinates.
+        crd = np.repeat(self._random('points', 100, 3), 10, axis=0)
+        tree = modmesh.KdTree3d(crd)
+        self._check(tree, 'points', np.arange(1000), crd, k=12)
+
+    def test_few_points(self):
+
+        tree = modmesh.KdTree2d(np.zeros((3, 2)))
+        near, dist = tree.nearest(np.ones((1, 2)), k=5)
+        self.assertEqual([0, 1, 2], sorted(near[0, :3].tolist()))
+        self.assertEqual([tree.INVALID]*2, near[0, 3:].tolist())
+        self.assertTrue(np.isinf(dist[0, 3:]).all())
+        with self.assertRaises(ValueError):
+            modmesh.KdTree2d(np.zeros((3, 3)))
+
+# vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
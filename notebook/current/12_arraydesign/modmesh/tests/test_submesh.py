@@ -0,0 +1,71 @@
+# Copyright (c) 2019, Yung-Yu Chen <yyc@solvcon.net>
+# BSD-style license; see COPYING
+
+import unittest
+
+import numpy as np
+
+import modmesh
+
+
+class MeshDecompositionTC(unittest.TestCase):
+
+    @staticmethod
+    def _decompose(cls, mesh, nparts, nlayer):
+
+        graph = modmesh.StaticGraph.dual(mesh)
+        part = modmesh.GraphPartitioner(seed=3).partition(graph, nparts)
+        return part, cls(mesh, part, nparts, nlayer=nlayer)
+
+    def _check_exchange(self, cls, mesh, nparts):
+
+        for nlayer in (1, 2):
+            part, decomp = self._decompose(cls, mesh, nparts, nlayer)
+            self.assertEqual(nparts, len(decomp))
+            # Every cell is owned by exactly one part.
+            owned = np.concatenate([sub.clgid[:sub.nown] for sub in decomp])
+            self.assertEqual(list(range(mesh.ncell)), sorted(owned.tolist()))
+            # Owned values are the global cell and the part; the ghosts
+            # start as garbage.
+            fields = []
+            for sub in decomp:
+                field = np.full((sub.mesh.ncell, 2), -1.0)
+                field[:sub.nown, 0] = sub.clgid[:sub.nown]
+                field[:sub.nown, 1] = sub.part
+                fields.append(field)
+            decomp.exchange(fields)
+            nghost = 0
+            for sub, field in zip(decomp, fields):
+                self.assertEqual(nlayer, sub.cllayer.max())
+                ghost = sub.clgid[sub.nown:]
+                nghost += len(ghost)
+                self.assertEqual(ghost.tolist(),
+                                 field[sub.nown:, 0].tolist())
+                self.assertEqual(part[ghost].tolist(),
+                                 field[sub.nown:, 1].tolist())
+                # The owned cells are left alone.
+                self.assertEqual(sub.clgid[:sub.nown].tolist(),
+                                 field[:sub.nown, 0].tolist())
+            self.assertLess(0, nghost)
+
+    def test_rectangle(self):
+
+        self._check_exchange(modmesh.MeshDecomposition2d,
+                             modmesh.StaticMesh2d.rectangle(20, 15), 4)
+
+    def test_box(self):
+
+        self._check_exchange(modmesh.MeshDecomposition3d,
+                             modmesh.StaticMesh3d.box(6, 5, 4), 3)
+
+    def test_bad_fields(self):
+
+        mesh = modmesh.StaticMesh2d.rectangle(4, 4)
+        part, decomp = self._decompose(modmesh.MeshDecomposition2d, mesh, 2, 1)
+        with self.assertRaises(ValueError):
+            decomp.exchange([np.zeros(decomp[0].mesh.ncell)])
+        with self.assertRaises(TypeError):
+            decomp.exchange([np.zeros(sub.mesh.ncell, dtype='int64')
+                             for sub in decomp])
+
+# vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+
+import sys
+sys.path.insert(0, 'modmesh')
+
+import time
+
+import numpy as np
+
+import modmesh as mm
+
+mm.time_registry.enable()
+
+rng = np.random.default_rng(0)
+crd = rng.random((1000000, 3))
+pts = rng.random((100000, 3))
+lo = rng.random((100000, 3)) * 0.99
+box = np.stack([lo, lo + 0.01], axis=1)
+
+
+def rate(name, nquery, func):
+    start = time.perf_counter()
+    func()
+    elapsed = time.perf_counter() - start
+    print('{:<28s} {:12.0f} queries/s'.format(name, nquery / elapsed))
+
+
+# Brute force scans every point per query; time a few queries of it.
+def brute_nearest():
+    for pt in pts[:100]:
+        ((crd - pt)**2).sum(axis=1).argmin()
+
+
+def brute_range():
+    for lo_, hi_ in box[:100]:
+        np.flatnonzero(((crd >= lo_) & (crd <= hi_)).all(axis=1))
+
+
+rate('brute nearest', 100, brute_nearest)
+rate('brute range', 100, brute_range)
+for cls in (mm.SpatialIndex3d.points, mm.KdTree3d):
+    index = cls(crd)
+    name = type(index).__name__
+    rate(name + ' nearest', len(pts), lambda: index.nearest(pts, k=1))
+    rate(name + ' nearest(k=8)', len(pts), lambda: index.nearest(pts, k=8))
+    rate(name + ' range', len(box), lambda: index.range(box))
+print(mm.time_registry.report())
+
+# vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4: